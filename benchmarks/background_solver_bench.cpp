@@ -0,0 +1,99 @@
+#include <benchmark/benchmark.h>
+#include "bechmark_helpers.hpp"
+#include "synthetic_problems.hpp"
+#include <chrono>
+
+// Latency of reading the newest pose while Gauss-Newton iterations on a grid pose graph
+// run on another thread. The solver publishes the poses after every iteration, either
+// through BackgroundSolver's double buffer, or by copying them into a store guarded by a
+// mutex, which readers lock. The counters give percentiles of the read latency in
+// nanoseconds, and the number of solutions published while reading.
+
+using synthetic::Pose;
+using Store = wave::VariableStore<Pose>;
+using Clock = std::chrono::steady_clock;
+
+struct Problem {
+    Store store;
+    std::vector<wave::RelativePoseMeasurement<Pose>> measurements;
+};
+
+Problem makeProblem(std::size_t n) {
+    const auto graph = synthetic::gridPoseGraph(n);
+    auto problem = Problem{{}, graph.measurements};
+    for (const auto &T : graph.odometry) {
+        problem.store.add(T);
+    }
+    return problem;
+}
+
+/** Returns the newest pose, as a sensor-rate consumer would */
+Pose newestPose(const Store &store) {
+    return store.values<Pose>().back();
+}
+
+/** Times each read, and sets latency percentiles as counters */
+template <typename Read>
+void timeReads(benchmark::State &state, Read read) {
+    auto latencies = std::vector<double>{};
+    for (auto _ : state) {
+        const auto start = Clock::now();
+        const auto T = read();
+        const auto end = Clock::now();
+        benchmark::DoNotOptimize(T);
+        const auto latency = std::chrono::duration<double, std::nano>(end - start);
+        latencies.push_back(latency.count());
+    }
+    std::sort(latencies.begin(), latencies.end());
+    const auto percentile = [&latencies](double p) {
+        return latencies[static_cast<std::size_t>(p * (latencies.size() - 1))];
+    };
+    state.counters["p50_ns"] = percentile(0.5);
+    state.counters["p99_ns"] = percentile(0.99);
+    state.counters["p99.99_ns"] = percentile(0.9999);
+    state.counters["max_ns"] = latencies.back();
+}
+
+void BM_readDoubleBuffer(benchmark::State &state) {
+    const auto n = static_cast<std::size_t>(state.range(0));
+    auto solver = wave::BackgroundSolver<Problem, Store>{
+      makeProblem(n),
+      [](Problem &p) {
+          synthetic::gaussNewton(p.store, p.measurements, 1);
+          return false;  // keep solving
+      },
+      [](const Problem &p, Store &solution) { solution = p.store; }};
+    solver.post([](Problem &) {});
+    const auto before = solver.published();
+    timeReads(state, [&solver] { return solver.read(newestPose); });
+    state.counters["published"] = solver.published() - before;
+}
+
+void BM_readMutex(benchmark::State &state) {
+    const auto n = static_cast<std::size_t>(state.range(0));
+    auto problem = makeProblem(n);
+    auto shared = problem.store;
+    auto mutex = std::mutex{};
+    auto stopping = std::atomic<bool>{false};
+    auto published = std::atomic<std::size_t>{0};
+    auto solver = std::thread{[&] {
+        while (!stopping.load()) {
+            synthetic::gaussNewton(problem.store, problem.measurements, 1);
+            std::lock_guard<std::mutex> lock{mutex};
+            shared = problem.store;
+            ++published;
+        }
+    }};
+    timeReads(state, [&] {
+        std::lock_guard<std::mutex> lock{mutex};
+        return newestPose(shared);
+    });
+    state.counters["published"] = published.load();
+    stopping = true;
+    solver.join();
+}
+
+BENCHMARK(BM_readDoubleBuffer)->Arg(2500)->MinTime(3)->UseRealTime();
+BENCHMARK(BM_readMutex)->Arg(2500)->MinTime(3)->UseRealTime();
+
+WAVE_BENCHMARK_MAIN()
@@ -0,0 +1,138 @@
+#include <benchmark/benchmark.h>
+#include <wave/geometry/dynamic.hpp>
+#include <wave/geometry/geometry.hpp>
+#include "bechmark_helpers.hpp"
+
+// Values and Jacobians of many dynamic graphs of one shape, each evaluated on its own
+// compared to evaluated together by a BatchSweep, either built for each evaluation or
+// built once and reused. Last, one graph evaluated over arrays of values by a
+// BatchKernel, compared to a graph built for each instance.
+
+using Rotation = wave::RotationMd;
+using Translation = wave::Translationd;
+
+/** Graphs inverse(x[j] * e) * p[i], where each pose x[j] * e is seen by 10 instances */
+struct Instances {
+    explicit Instances(int k) {
+        const auto e = wave::Proxy<Rotation>{Rotation::Random() * Rotation::Random()};
+        auto pose = wave::Proxy<Rotation>{e};
+        for (int i = 0; i < k; ++i) {
+            if (i % 10 == 0) {
+                pose = wave::Proxy<Rotation>{wave::Proxy<Rotation>{Rotation::Random()} * e};
+            }
+            roots.emplace_back(inverse(pose) *
+                               wave::Proxy<Translation>{Translation::Random()});
+        }
+    }
+
+    std::vector<wave::Proxy<Translation>> roots;
+};
+
+void BM_eachInstance(benchmark::State &state) {
+    const auto instances = Instances(state.range(0));
+
+    for (auto _ : state) {
+        for (const auto &root : instances.roots) {
+            const auto [result, jac_map] =
+              wave::internal::evaluateWithDynamicReverseJacobians(root);
+
+            benchmark::DoNotOptimize(result.value().data());
+            benchmark::DoNotOptimize(jac_map);
+        }
+    }
+}
+
+void BM_eachInstanceSwept(benchmark::State &state) {
+    const auto instances = Instances(state.range(0));
+    auto structures = wave::internal::DynamicStructureCache{};
+
+    for (auto _ : state) {
+        for (const auto &root : instances.roots) {
+            const auto [result, jac_map] =
+              wave::internal::evaluateWithCheckpointedReverseJacobians(
+                root, 1000, &structures);
+
+            benchmark::DoNotOptimize(result.value().data());
+            benchmark::DoNotOptimize(jac_map);
+        }
+    }
+}
+
+void BM_batch(benchmark::State &state) {
+    const auto instances = Instances(state.range(0));
+    auto structures = wave::internal::DynamicStructureCache{};
+
+    for (auto _ : state) {
+        auto batch = wave::internal::BatchSweep<Translation>{instances.roots, structures};
+        const auto results = batch.evaluateWithReverseJacobians();
+
+        benchmark::DoNotOptimize(results.data());
+    }
+}
+
+void BM_batchReused(benchmark::State &state) {
+    const auto instances = Instances(state.range(0));
+    auto structures = wave::internal::DynamicStructureCache{};
+    auto batch = wave::internal::BatchSweep<Translation>{instances.roots, structures};
+
+    for (auto _ : state) {
+        const auto results = batch.evaluateWithReverseJacobians();
+
+        benchmark::DoNotOptimize(results.data());
+    }
+}
+
+/** Arrays of the values of x and p, for instances of inverse(x * e) * p */
+struct Arrays {
+    explicit Arrays(int k) : x(k), p(k) {
+        for (int i = 0; i < k; ++i) {
+            x[i] = Rotation::Random();
+            p[i] = Translation::Random();
+        }
+    }
+
+    const wave::Proxy<Rotation> e{Rotation::Random() * Rotation::Random()};
+    std::vector<Rotation> x;
+    std::vector<Translation> p;
+};
+
+void BM_eachGraph(benchmark::State &state) {
+    const auto arrays = Arrays(state.range(0));
+
+    for (auto _ : state) {
+        for (std::size_t k = 0; k < arrays.x.size(); ++k) {
+            const auto root = wave::Proxy<Translation>{
+              inverse(wave::Proxy<Rotation>{arrays.x[k] * arrays.e}) * arrays.p[k]};
+            const auto [result, jac_map] =
+              wave::internal::evaluateWithDynamicReverseJacobians(root);
+
+            benchmark::DoNotOptimize(result.value().data());
+            benchmark::DoNotOptimize(jac_map);
+        }
+    }
+}
+
+void BM_kernel(benchmark::State &state) {
+    const auto arrays = Arrays(state.range(0));
+    const auto x = Rotation::Random();
+    const auto p = Translation::Random();
+    auto kernel = wave::internal::BatchKernel<Translation>{wave::Proxy<Translation>{
+      inverse(wave::Proxy<Rotation>{x * arrays.e}) * p}};
+    kernel.bind(x, arrays.x.data());
+    kernel.bind(p, arrays.p.data());
+
+    for (auto _ : state) {
+        const auto results = kernel.evaluateWithReverseJacobians(arrays.x.size());
+
+        benchmark::DoNotOptimize(results.data());
+    }
+}
+
+BENCHMARK(BM_eachInstance)->Arg(100);
+BENCHMARK(BM_eachInstanceSwept)->Arg(100);
+BENCHMARK(BM_batch)->Arg(100);
+BENCHMARK(BM_batchReused)->Arg(100);
+BENCHMARK(BM_eachGraph)->Arg(1000);
+BENCHMARK(BM_kernel)->Arg(1000);
+
+WAVE_BENCHMARK_MAIN()
@@ -0,0 +1,85 @@
+#include <benchmark/benchmark.h>
+#include <wave/geometry/geometry.hpp>
+#include "bechmark_helpers.hpp"
+
+// Compares BoxMinus against the equivalent LogMap<Compose<Lhs, Inverse<Rhs>>>, which it
+// was previously an alias of.
+
+template <typename Leaf>
+void BM_boxMinusAlias(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto a = randomMatrices<Leaf>(N);
+    const auto b = randomMatrices<Leaf>(N);
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const auto result = eval(log(a[i] * inverse(b[i])));
+
+            benchmark::DoNotOptimize(result.value().data());
+            DEBUG_ASSERT_APPROX(result, eval(a[i] - b[i]));
+        }
+    }
+}
+
+template <typename Leaf>
+void BM_boxMinus(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto a = randomMatrices<Leaf>(N);
+    const auto b = randomMatrices<Leaf>(N);
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const auto result = eval(a[i] - b[i]);
+
+            benchmark::DoNotOptimize(result.value().data());
+        }
+    }
+}
+
+template <typename Leaf>
+void BM_boxMinusJacobiansAlias(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto a = randomMatrices<Leaf>(N);
+    const auto b = randomMatrices<Leaf>(N);
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const auto [result, Ja, Jb] =
+              log(a[i] * inverse(b[i])).evalWithJacobians(a[i], b[i]);
+
+            benchmark::DoNotOptimize(result.value().data());
+            benchmark::DoNotOptimize(Ja.data());
+            benchmark::DoNotOptimize(Jb.data());
+        }
+    }
+}
+
+template <typename Leaf>
+void BM_boxMinusJacobians(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto a = randomMatrices<Leaf>(N);
+    const auto b = randomMatrices<Leaf>(N);
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const auto [result, Ja, Jb] = (a[i] - b[i]).evalWithJacobians(a[i], b[i]);
+
+            benchmark::DoNotOptimize(result.value().data());
+            benchmark::DoNotOptimize(Ja.data());
+            benchmark::DoNotOptimize(Jb.data());
+        }
+    }
+}
+
+#define WAVE_BOXMINUS_BENCHMARKS(Leaf)                                   \
+    BENCHMARK_TEMPLATE(BM_boxMinusAlias, Leaf)->Arg(100);                \
+    BENCHMARK_TEMPLATE(BM_boxMinus, Leaf)->Arg(100);                     \
+    BENCHMARK_TEMPLATE(BM_boxMinusJacobiansAlias, Leaf)->Arg(100);       \
+    BENCHMARK_TEMPLATE(BM_boxMinusJacobians, Leaf)->Arg(100);
+
+WAVE_BOXMINUS_BENCHMARKS(wave::RotationMd)
+WAVE_BOXMINUS_BENCHMARKS(wave::RotationQd)
+WAVE_BOXMINUS_BENCHMARKS(wave::RigidTransformMd)
+WAVE_BOXMINUS_BENCHMARKS(wave::RigidTransformQd)
+
+WAVE_BENCHMARK_MAIN()
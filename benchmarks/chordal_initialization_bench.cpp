@@ -0,0 +1,36 @@
+#include <benchmark/benchmark.h>
+#include "bechmark_helpers.hpp"
+#include "synthetic_problems.hpp"
+
+// Gauss-Newton on a noisy pose graph of a robot spiralling around a sphere. We time
+// initialization plus solving until the update is small, starting from poses composed
+// along odometry, or from the chordal initialization.
+
+using synthetic::Pose;
+
+template <bool Chordal>
+void BM_solveSpherePoseGraph(benchmark::State &state) {
+    const auto graph = synthetic::spherePoseGraph(state.range(0));
+    int iterations = 0;
+    for (auto _ : state) {
+        auto store = wave::VariableStore<Pose>{};
+        for (const auto &T : graph.odometry) {
+            store.add(T);
+        }
+        if (Chordal) {
+            wave::initializePosesChordal<Pose>(store, graph.measurements);
+        }
+        iterations = synthetic::gaussNewton(store, graph.measurements);
+        benchmark::DoNotOptimize(store.values<Pose>().data());
+    }
+    state.counters["iterations"] = iterations;
+}
+
+BENCHMARK_TEMPLATE(BM_solveSpherePoseGraph, false)
+  ->Arg(800)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_solveSpherePoseGraph, true)
+  ->Arg(800)
+  ->Unit(benchmark::kMillisecond);
+
+WAVE_BENCHMARK_MAIN()
@@ -0,0 +1,112 @@
+#include <benchmark/benchmark.h>
+#include "bechmark_helpers.hpp"
+#include "synthetic_problems.hpp"
+
+// One Gauss-Newton step on a grid pose graph linearized at the odometry poses, with a
+// prior on the first pose: assembling J^T J and solving with a sparse LDLT, or
+// matrix-free PCG from the factors' Jacobian blocks to a relative residual of 1e-6, on
+// a pool of 1 or 4 threads. The counters give the memory of the factor of J^T J or of
+// the Jacobian blocks.
+
+using synthetic::Pose;
+
+struct Linearization {
+    std::size_t i;
+    std::size_t j;
+    Eigen::Matrix<double, 6, 1> r;
+    Eigen::Matrix<double, 6, 6> J_i;
+    Eigen::Matrix<double, 6, 6> J_j;
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+/** Returns the linearized factors of a grid pose graph, with the prior first */
+synthetic::AlignedVector<Linearization> linearize(std::size_t n) {
+    const auto problem = synthetic::gridPoseGraph(n);
+    const auto &x = problem.odometry;
+    auto result = synthetic::AlignedVector<Linearization>{};
+    result.push_back({0,
+                      0,
+                      Eigen::Matrix<double, 6, 1>::Zero(),
+                      Eigen::Matrix<double, 6, 6>::Identity(),
+                      Eigen::Matrix<double, 6, 6>::Zero()});
+    for (const auto &m : problem.measurements) {
+        const auto &T_i = x[m.i];
+        const auto &T_j = x[m.j];
+        const auto [r, J_i, J_j] =
+          ((inverse(T_i) * T_j) - m.transform).evalWithJacobians(T_i, T_j);
+        result.push_back({m.i, m.j, r.value(), J_i, J_j});
+    }
+    return result;
+}
+
+void BM_stepCholesky(benchmark::State &state) {
+    const auto n = static_cast<std::size_t>(state.range(0));
+    const auto factors = linearize(n);
+    const auto size = 6 * static_cast<Eigen::Index>(n);
+    std::size_t factor_bytes = 0;
+    for (auto _ : state) {
+        auto triplets = std::vector<Eigen::Triplet<double>>{};
+        triplets.reserve(4 * 36 * factors.size());
+        Eigen::VectorXd g = Eigen::VectorXd::Zero(size);
+        const auto addBlock = [&triplets](std::size_t r, std::size_t c, const auto &B) {
+            for (int a = 0; a < 6; ++a) {
+                for (int b = 0; b < 6; ++b) {
+                    triplets.emplace_back(r + a, c + b, B(a, b));
+                }
+            }
+        };
+        for (const auto &f : factors) {
+            const auto a = 6 * f.i;
+            const auto b = 6 * f.j;
+            addBlock(a, a, f.J_i.transpose() * f.J_i);
+            g.segment<6>(a) += f.J_i.transpose() * f.r;
+            if (f.i != f.j) {
+                addBlock(a, b, f.J_i.transpose() * f.J_j);
+                addBlock(b, a, f.J_j.transpose() * f.J_i);
+                addBlock(b, b, f.J_j.transpose() * f.J_j);
+                g.segment<6>(b) += f.J_j.transpose() * f.r;
+            }
+        }
+        Eigen::SparseMatrix<double> H(size, size);
+        H.setFromTriplets(triplets.begin(), triplets.end());
+        const Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> solver{H};
+        const Eigen::VectorXd delta = -solver.solve(g);
+        benchmark::DoNotOptimize(delta.data());
+        factor_bytes = 12 * solver.matrixL().nestedExpression().nonZeros();
+    }
+    state.counters["MB"] = factor_bytes / 1e6;
+}
+
+void BM_stepPcg(benchmark::State &state) {
+    const auto n = static_cast<std::size_t>(state.range(0));
+    const auto factors = linearize(n);
+    auto J = wave::BlockJacobian{6 * n};
+    for (const auto &f : factors) {
+        if (f.i == f.j) {
+            J.addFactor(f.r, {6 * f.i}, f.J_i);
+        } else {
+            J.addFactor(f.r, {6 * f.i, 6 * f.j}, f.J_i, f.J_j);
+        }
+    }
+    auto pool = wave::WorkStealingPool{static_cast<std::size_t>(state.range(1))};
+    auto options = wave::PcgOptions{};
+    options.pool = &pool;
+    options.max_iterations = 10000;
+    int iterations = 0;
+    for (auto _ : state) {
+        const auto result = wave::solvePcg(J, options);
+        benchmark::DoNotOptimize(result.step.data());
+        iterations = result.iterations;
+    }
+    state.counters["MB"] = J.bytes() / 1e6;
+    state.counters["iterations"] = iterations;
+}
+
+BENCHMARK(BM_stepCholesky)->Arg(2500)->Arg(10000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_stepPcg)
+  ->Args({2500, 1})
+  ->Args({10000, 1})
+  ->Args({10000, 4})
+  ->Unit(benchmark::kMillisecond);
+
+WAVE_BENCHMARK_MAIN()
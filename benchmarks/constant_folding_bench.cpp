@@ -0,0 +1,55 @@
+#include <benchmark/benchmark.h>
+#include <wave/geometry/dynamic.hpp>
+#include <wave/geometry/geometry.hpp>
+#include "bechmark_helpers.hpp"
+
+// Many residual graphs x[i] * E, where the extrinsic E is a product of several constant
+// rigid transforms, with and without folding E.
+
+struct ExtrinsicGraphs {
+    using Leaves =
+      std::vector<wave::RigidTransformMd, Eigen::aligned_allocator<wave::RigidTransformMd>>;
+
+    explicit ExtrinsicGraphs(int n)
+        : constants(randomMatrices<wave::RigidTransformMd>(4)),
+          x(randomMatrices<wave::RigidTransformMd>(n)) {
+        const auto extrinsic = wave::Proxy<wave::RigidTransformMd>{
+          constants[0] * inverse(constants[1]) * constants[2] * constants[3]};
+        for (const auto &xi : x) {
+            roots.emplace_back(xi * extrinsic);
+        }
+    }
+
+    Leaves constants;
+    Leaves x;
+    std::vector<wave::Proxy<wave::RigidTransformMd>> roots;
+};
+
+template <bool Fold>
+void BM_extrinsicGraphs(benchmark::State &state) {
+    const auto graphs = ExtrinsicGraphs(state.range(0));
+    auto folding = wave::ConstantFolding<double>{};
+    if (Fold) {
+        for (const auto &c : graphs.constants) {
+            folding.markConstant(c);
+        }
+        for (const auto &root : graphs.roots) {
+            folding.fold(root);
+        }
+    }
+
+    for (auto _ : state) {
+        for (const auto &root : graphs.roots) {
+            const auto [result, jac_map] =
+              wave::internal::evaluateWithDynamicReverseJacobians(root);
+
+            benchmark::DoNotOptimize(result.value().data());
+            benchmark::DoNotOptimize(jac_map);
+        }
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_extrinsicGraphs, false)->Arg(100);
+BENCHMARK_TEMPLATE(BM_extrinsicGraphs, true)->Arg(100);
+
+WAVE_BENCHMARK_MAIN()
@@ -0,0 +1,95 @@
+#include <benchmark/benchmark.h>
+#include "bechmark_helpers.hpp"
+#include "synthetic_problems.hpp"
+
+// Marginal covariances of poses in a grid pose graph, from its information matrix J^T J
+// at the true poses with a prior on the first pose. Each benchmark includes factorizing
+// the matrix. We compare the sparse inverse subset for a few poses or for every pose with
+// solving for the columns of the inverse belonging to a few poses (or none, to time
+// only the factorization).
+
+using synthetic::Pose;
+using Store = wave::VariableStore<Pose>;
+
+/** The information matrix of a pose graph, and the store it is ordered by */
+struct Information {
+    explicit Information(std::size_t n) {
+        const auto problem = synthetic::gridPoseGraph(n);
+        for (const auto &T : problem.truth) {
+            this->store.add(T);
+        }
+        const auto &x = this->store.values<Pose>();
+        auto triplets = std::vector<Eigen::Triplet<double>>{};
+        const auto addBlock = [&triplets](std::size_t r, std::size_t c, const auto &B) {
+            for (int a = 0; a < 6; ++a) {
+                for (int b = 0; b < 6; ++b) {
+                    triplets.emplace_back(r + a, c + b, B(a, b));
+                }
+            }
+        };
+        for (const auto &m : problem.measurements) {
+            const auto &T_i = x[m.i];
+            const auto &T_j = x[m.j];
+            const auto [r, J_i, J_j] =
+              ((inverse(T_i) * T_j) - m.transform).evalWithJacobians(T_i, T_j);
+            addBlock(6 * m.i, 6 * m.i, J_i.transpose() * J_i);
+            addBlock(6 * m.i, 6 * m.j, J_i.transpose() * J_j);
+            addBlock(6 * m.j, 6 * m.i, J_j.transpose() * J_i);
+            addBlock(6 * m.j, 6 * m.j, J_j.transpose() * J_j);
+        }
+        addBlock(0, 0, Eigen::Matrix<double, 6, 6>::Identity());
+        this->H.resize(this->store.tangentSize(), this->store.tangentSize());
+        this->H.setFromTriplets(triplets.begin(), triplets.end());
+    }
+
+    /** Returns indices of `count` poses spread over the graph */
+    std::vector<std::size_t> selected(std::size_t count) const {
+        auto indices = std::vector<std::size_t>{};
+        const auto n = this->store.size();
+        for (std::size_t k = 0; k < count; ++k) {
+            indices.push_back((2 * k + 1) * n / (2 * count));
+        }
+        return indices;
+    }
+
+    Store store;
+    Eigen::SparseMatrix<double> H;
+};
+
+void BM_marginalsSubset(benchmark::State &state) {
+    const auto info = Information{static_cast<std::size_t>(state.range(0))};
+    const auto indices = info.selected(state.range(1));
+    for (auto _ : state) {
+        const auto cov = wave::MarginalCovariance<Pose>{info.store, info.H};
+        for (const auto i : indices) {
+            const auto P = cov.covariance<Pose>(i);
+            benchmark::DoNotOptimize(P.data());
+        }
+    }
+}
+
+void BM_marginalsColumnSolves(benchmark::State &state) {
+    const auto info = Information{static_cast<std::size_t>(state.range(0))};
+    const auto indices = info.selected(state.range(1));
+    const auto n = info.H.rows();
+    for (auto _ : state) {
+        const auto llt = Eigen::SimplicialLLT<Eigen::SparseMatrix<double>>{info.H};
+        for (const auto i : indices) {
+            Eigen::MatrixXd E = Eigen::MatrixXd::Zero(n, 6);
+            E.middleRows<6>(6 * i).setIdentity();
+            const Eigen::Matrix<double, 6, 6> P = llt.solve(E).middleRows<6>(6 * i);
+            benchmark::DoNotOptimize(P.data());
+        }
+    }
+}
+
+BENCHMARK(BM_marginalsSubset)
+  ->Args({10000, 10})
+  ->Args({10000, 10000})
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_marginalsColumnSolves)
+  ->Args({10000, 0})
+  ->Args({10000, 10})
+  ->Unit(benchmark::kMillisecond);
+
+WAVE_BENCHMARK_MAIN()
@@ -0,0 +1,41 @@
+#include <benchmark/benchmark.h>
+#include <wave/geometry/dynamic.hpp>
+#include <wave/geometry/geometry.hpp>
+#include "bechmark_helpers.hpp"
+
+// Building the graphs of many factors of the same shape, each with its own structure
+// compared to sharing one structure through a DynamicStructureCache.
+
+using Rotation = wave::RotationMd;
+
+/** A reprojection-like graph inverse(x * (a * b)) * (c * d), with its own leaves */
+struct FactorGraph {
+    wave::Proxy<Rotation> a{Rotation::Random()};
+    wave::Proxy<Rotation> b{Rotation::Random()};
+    wave::Proxy<Rotation> c{Rotation::Random()};
+    wave::Proxy<Rotation> d{Rotation::Random()};
+    wave::Proxy<Rotation> x{Rotation::Random()};
+    wave::Proxy<Rotation> pose{x * wave::Proxy<Rotation>{a * b}};
+    wave::Proxy<Rotation> result{inverse(pose) * wave::Proxy<Rotation>{c * d}};
+};
+
+template <bool Intern>
+void BM_factorGraphs(benchmark::State &state) {
+    const auto factors = std::vector<FactorGraph>(state.range(0));
+    auto structures = wave::internal::DynamicStructureCache{};
+    auto graphs = std::vector<wave::internal::DynamicGraph<double>>{};
+    graphs.reserve(factors.size());
+
+    for (auto _ : state) {
+        graphs.clear();
+        for (const auto &f : factors) {
+            graphs.emplace_back(f.result.follow(), Intern ? &structures : nullptr);
+        }
+        benchmark::DoNotOptimize(graphs.data());
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_factorGraphs, false)->Arg(100);
+BENCHMARK_TEMPLATE(BM_factorGraphs, true)->Arg(100);
+
+WAVE_BENCHMARK_MAIN()
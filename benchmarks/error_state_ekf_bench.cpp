@@ -0,0 +1,73 @@
+#include <benchmark/benchmark.h>
+#include "bechmark_helpers.hpp"
+#include "wave/geometry/estimation.hpp"
+
+// One predict and update step of a filter on an SE(3) pose, with a constant-velocity
+// process model and a measurement of a known point in the body frame. We compare
+// ErrorStateEkf with the same step assembled by hand with dynamic matrices, taking the
+// same Jacobians from the expressions.
+
+using Pose = wave::RigidTransformQd;
+using Point = wave::Translationd;
+
+namespace {
+
+const auto velocity =
+  (Eigen::Matrix<double, 6, 1>{} << 0.01, 0.02, -0.01, 0.1, 0, 0.05).finished();
+const auto landmark = Point{5, 1, 2};
+
+Pose startPose() {
+    return Pose{Eigen::Quaterniond{Eigen::AngleAxisd{0.3, Eigen::Vector3d::UnitZ()}},
+                Eigen::Vector3d{1, -2, 0.5}};
+}
+
+}  // namespace
+
+void BM_errorStateEkf(benchmark::State &state) {
+    const Eigen::Matrix<double, 6, 6> P0 = 1e-3 * Eigen::Matrix<double, 6, 6>::Identity();
+    auto ekf = wave::ErrorStateEkf<Pose>{startPose(), P0};
+    const auto Q =
+      wave::DiagonalNoise<Pose>::FromStdDev(1e-3, 1e-3, 1e-3, 1e-3, 1e-3, 1e-3);
+    const auto noise = wave::DiagonalNoise<Point>::FromStdDev(0.01, 0.01, 0.01);
+    const auto step = wave::Twistd{velocity};
+
+    for (auto _ : state) {
+        ekf.predict([&step](const auto &T) { return T * exp(step); }, Q);
+        const auto z = wave::Uncertain<Point, wave::DiagonalNoise>{
+          wave::eval(inverse(ekf.state()) * landmark), noise};
+        benchmark::DoNotOptimize(
+          ekf.update([](const auto &T) { return inverse(T) * landmark; }, z));
+    }
+}
+
+void BM_dynamicEkf(benchmark::State &state) {
+    auto x = startPose();
+    Eigen::MatrixXd P = 1e-3 * Eigen::MatrixXd::Identity(6, 6);
+    const Eigen::MatrixXd Q = 1e-6 * Eigen::MatrixXd::Identity(6, 6);
+    const Eigen::MatrixXd R = 1e-4 * Eigen::MatrixXd::Identity(3, 3);
+    const Eigen::MatrixXd I = Eigen::MatrixXd::Identity(6, 6);
+    const auto step = wave::Twistd{velocity};
+
+    for (auto _ : state) {
+        const auto [value, F_x] = (x * exp(step)).evalWithJacobians(x);
+        const Eigen::MatrixXd F = F_x;
+        P = F * P * F.transpose() + Q;
+        x = Pose{value};
+
+        const auto z = wave::eval(inverse(x) * landmark);
+        const auto [h, H_x] = (inverse(x) * landmark).evalWithJacobians(x);
+        const Eigen::MatrixXd H = H_x;
+        const Eigen::VectorXd r = h.value() - z.value();
+        const Eigen::MatrixXd S = H * P * H.transpose() + R;
+        const Eigen::MatrixXd K = P * H.transpose() * S.inverse();
+        const Eigen::MatrixXd A = I - K * H;
+        P = A * P * A.transpose() + K * R * K.transpose();
+        const Eigen::VectorXd dx = -K * r;
+        x = Pose{x + wave::Twistd{Eigen::Matrix<double, 6, 1>{dx}}};
+        benchmark::DoNotOptimize(r.dot(S.inverse() * r));
+    }
+}
+
+BENCHMARK(BM_errorStateEkf);
+BENCHMARK(BM_dynamicEkf);
+BENCHMARK_MAIN();
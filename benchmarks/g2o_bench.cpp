@@ -0,0 +1,119 @@
+#include <benchmark/benchmark.h>
+#include <wave/geometry/g2o.hpp>
+#include <cstdio>
+#include <sstream>
+#include "bechmark_helpers.hpp"
+
+// Reading a synthetic g2o pose graph of n poses along a random walk, with an edge to the
+// previous pose and to the pose 10 steps back: loading the file, parsing it from memory,
+// and only tokenizing it, compared to tokenizing with an istringstream.
+
+std::string syntheticG2o(int n) {
+    auto out = std::string{};
+    char line[512];
+    const auto quat = [](const wave::RigidTransformQd &T) {
+        return T.rotationBlock().value().coeffs();
+    };
+    const auto vec = [](const wave::RigidTransformQd &T) {
+        return T.translationBlock().value();
+    };
+    auto poses = randomMatrices<wave::RigidTransformQd>(n);
+    for (int i = 0; i < n; ++i) {
+        const auto t = vec(poses[i]);
+        const auto q = quat(poses[i]);
+        std::snprintf(line,
+                      sizeof line,
+                      "VERTEX_SE3:QUAT %d %.9f %.9f %.9f %.9f %.9f %.9f %.9f\n",
+                      i, t.x(), t.y(), t.z(), q.x(), q.y(), q.z(), q.w());
+        out += line;
+    }
+    const auto addEdge = [&](int i, int j) {
+        const auto T = wave::RigidTransformQd{inverse(poses[i]) * poses[j]};
+        const auto t = vec(T);
+        const auto q = quat(T);
+        std::snprintf(line,
+                      sizeof line,
+                      "EDGE_SE3:QUAT %d %d %.9f %.9f %.9f %.9f %.9f %.9f %.9f "
+                      "100 0 0 0 0 0 100 0 0 0 0 100 0 0 0 400 0 0 400 0 400\n",
+                      i, j, t.x(), t.y(), t.z(), q.x(), q.y(), q.z(), q.w());
+        out += line;
+    };
+    for (int i = 1; i < n; ++i) {
+        addEdge(i - 1, i);
+        if (i >= 10) {
+            addEdge(i - 10, i);
+        }
+    }
+    return out;
+}
+
+void BM_loadG2o(benchmark::State &state) {
+    const auto text = syntheticG2o(state.range(0));
+    const auto path = std::string{"g2o_bench.g2o"};
+    {
+        auto file = std::ofstream{path, std::ios::binary};
+        file << text;
+    }
+    for (auto _ : state) {
+        const auto graph = wave::loadG2o(path);
+        benchmark::DoNotOptimize(graph.factors.data());
+    }
+    std::remove(path.c_str());
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+void BM_parseG2o(benchmark::State &state) {
+    const auto text = syntheticG2o(state.range(0));
+    for (auto _ : state) {
+        const auto graph = wave::parseG2o(text.data(), text.data() + text.size());
+        benchmark::DoNotOptimize(graph.factors.data());
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+void BM_tokenizeG2o(benchmark::State &state) {
+    const auto text = syntheticG2o(state.range(0));
+    for (auto _ : state) {
+        auto reader = wave::internal::G2oReader{text.data(), text.data() + text.size()};
+        double sum = 0;
+        for (bool more = reader.firstLine(); more; more = reader.nextLine()) {
+            const auto tag = reader.token();
+            const auto count = wave::internal::tokenIs(tag, "VERTEX_SE3:QUAT") ? 7 : 29;
+            sum += reader.number<long>();
+            for (int k = 0; k < count; ++k) {
+                sum += reader.number<double>();
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+void BM_tokenizeG2oIstream(benchmark::State &state) {
+    const auto text = syntheticG2o(state.range(0));
+    for (auto _ : state) {
+        auto in = std::istringstream{text};
+        auto tag = std::string{};
+        double sum = 0;
+        while (in >> tag) {
+            const auto count = tag == "VERTEX_SE3:QUAT" ? 7 : 29;
+            long id;
+            in >> id;
+            sum += id;
+            for (int k = 0; k < count; ++k) {
+                double x;
+                in >> x;
+                sum += x;
+            }
+        }
+        benchmark::DoNotOptimize(sum);
+    }
+    state.SetBytesProcessed(state.iterations() * text.size());
+}
+
+BENCHMARK(BM_loadG2o)->Arg(10000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_parseG2o)->Arg(10000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_tokenizeG2o)->Arg(10000)->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_tokenizeG2oIstream)->Arg(10000)->Unit(benchmark::kMillisecond);
+
+WAVE_BENCHMARK_MAIN()
@@ -0,0 +1,68 @@
+#include <benchmark/benchmark.h>
+#include <wave/geometry/geometry.hpp>
+#include "bechmark_helpers.hpp"
+
+// Relative rotation inverse(R_i) * R_j of matrix rotations, compared to the same product
+// written with Eigen directly.
+
+void BM_relativeRotationEigen(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto a = randomMatrices<Eigen::Matrix3d>(N);
+    const auto b = randomMatrices<Eigen::Matrix3d>(N);
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const Eigen::Matrix3d result = a[i].transpose() * b[i];
+            benchmark::DoNotOptimize(result.data());
+        }
+    }
+}
+
+void BM_relativeRotation(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto a = randomMatrices<wave::RotationMd>(N);
+    const auto b = randomMatrices<wave::RotationMd>(N);
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const auto result = eval(inverse(a[i]) * b[i]);
+            benchmark::DoNotOptimize(result.value().data());
+        }
+    }
+}
+
+void BM_relativeRotationJacobians(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto a = randomMatrices<wave::RotationMd>(N);
+    const auto b = randomMatrices<wave::RotationMd>(N);
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const auto [result, Ja, Jb] =
+              (inverse(a[i]) * b[i]).evalWithJacobians(a[i], b[i]);
+            benchmark::DoNotOptimize(result.value().data());
+            benchmark::DoNotOptimize(Ja.data());
+            benchmark::DoNotOptimize(Jb.data());
+        }
+    }
+}
+
+void BM_relativeRotationRotate(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto a = randomMatrices<wave::RotationMd>(N);
+    const auto v = randomMatrices<wave::Translationd>(N);
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const auto result = eval(inverse(a[i]) * v[i]);
+            benchmark::DoNotOptimize(result.value().data());
+        }
+    }
+}
+
+BENCHMARK(BM_relativeRotationEigen)->Arg(100);
+BENCHMARK(BM_relativeRotation)->Arg(100);
+BENCHMARK(BM_relativeRotationJacobians)->Arg(100);
+BENCHMARK(BM_relativeRotationRotate)->Arg(100);
+
+WAVE_BENCHMARK_MAIN()
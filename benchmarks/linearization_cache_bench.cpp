@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+#include <wave/geometry/estimation.hpp>
+#include "bechmark_helpers.hpp"
+
+// Reprojection-like residuals inverse(T_wb * T_bc) * p of many points seen from one
+// keyframe, with Jacobians, evaluating the camera pose in every residual compared to
+// taking it from a LinearizationCache.
+
+void BM_residualsUncached(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto T_wb = wave::RigidTransformMd::Random();
+    const auto T_bc = wave::RigidTransformMd::Random();
+    const auto p = randomMatrices<wave::Translationd>(N);
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const auto [r, J_wb, J_bc, J_p] =
+              (inverse(T_wb * T_bc) * p[i]).evalWithJacobians(T_wb, T_bc, p[i]);
+
+            benchmark::DoNotOptimize(r.value().data());
+            benchmark::DoNotOptimize(J_wb.data());
+            benchmark::DoNotOptimize(J_bc.data());
+            benchmark::DoNotOptimize(J_p.data());
+        }
+    }
+}
+
+void BM_residualsCached(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto T_wb = wave::RigidTransformMd::Random();
+    const auto T_bc = wave::RigidTransformMd::Random();
+    const auto p = randomMatrices<wave::Translationd>(N);
+    auto cache = wave::LinearizationCache{};
+
+    for (auto _ : state) {
+        cache.nextPass();
+        for (auto i = N; i--;) {
+            const auto &[T_wc, J_wc_wb, J_wc_bc] =
+              cache.evaluate(T_wb * T_bc, T_wb, T_bc);
+            const auto [r, J_wc, J_p] =
+              (inverse(T_wc) * p[i]).evalWithJacobians(T_wc, p[i]);
+            const Eigen::Matrix<double, 3, 6> J_wb = J_wc * J_wc_wb;
+            const Eigen::Matrix<double, 3, 6> J_bc = J_wc * J_wc_bc;
+
+            benchmark::DoNotOptimize(r.value().data());
+            benchmark::DoNotOptimize(J_wb.data());
+            benchmark::DoNotOptimize(J_bc.data());
+            benchmark::DoNotOptimize(J_p.data());
+        }
+    }
+}
+
+BENCHMARK(BM_residualsUncached)->Arg(100);
+BENCHMARK(BM_residualsCached)->Arg(100);
+
+WAVE_BENCHMARK_MAIN()
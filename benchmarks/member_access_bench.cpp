@@ -0,0 +1,115 @@
+#include <benchmark/benchmark.h>
+#include <wave/geometry/geometry.hpp>
+#include "bechmark_helpers.hpp"
+
+// Rotation and translation parts of a product and of an inverse, with Jacobians, compared
+// to taking the block from the whole evaluated transform (as every .rotation() and
+// .translation() of a non-leaf expression previously did).
+
+struct RotationPart {
+    template <typename Derived>
+    using Getter = wave::RotationGetter<Derived>;
+
+    template <typename Expr>
+    static auto of(Expr &&expr) {
+        return std::forward<Expr>(expr).rotation();
+    }
+};
+
+struct TranslationPart {
+    template <typename Derived>
+    using Getter = wave::TranslationGetter<Derived>;
+
+    template <typename Expr>
+    static auto of(Expr &&expr) {
+        return std::forward<Expr>(expr).translation();
+    }
+};
+
+template <typename Part, typename Expr>
+auto wholeThenPart(Expr &&expr) {
+    using Getter = typename Part::template Getter<wave::tmp::remove_cr_t<Expr>>;
+    return wave::internal::memberAccess<Getter>(std::forward<Expr>(expr));
+}
+
+template <typename Leaf, typename Part>
+void BM_composePartWhole(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto a = randomMatrices<Leaf>(N);
+    const auto b = randomMatrices<Leaf>(N);
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const auto [result, Ja, Jb] =
+              wholeThenPart<Part>(a[i] * b[i]).evalWithJacobians(a[i], b[i]);
+
+            benchmark::DoNotOptimize(result.value());
+            benchmark::DoNotOptimize(Ja.data());
+            benchmark::DoNotOptimize(Jb.data());
+        }
+    }
+}
+
+template <typename Leaf, typename Part>
+void BM_composePart(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto a = randomMatrices<Leaf>(N);
+    const auto b = randomMatrices<Leaf>(N);
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const auto [result, Ja, Jb] =
+              Part::of(a[i] * b[i]).evalWithJacobians(a[i], b[i]);
+
+            benchmark::DoNotOptimize(result.value());
+            benchmark::DoNotOptimize(Ja.data());
+            benchmark::DoNotOptimize(Jb.data());
+            DEBUG_ASSERT_APPROX(result, eval(wholeThenPart<Part>(a[i] * b[i])));
+        }
+    }
+}
+
+template <typename Leaf, typename Part>
+void BM_inversePartWhole(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto a = randomMatrices<Leaf>(N);
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const auto [result, Ja] =
+              wholeThenPart<Part>(inverse(a[i])).evalWithJacobians(a[i]);
+
+            benchmark::DoNotOptimize(result.value());
+            benchmark::DoNotOptimize(Ja.data());
+        }
+    }
+}
+
+template <typename Leaf, typename Part>
+void BM_inversePart(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto a = randomMatrices<Leaf>(N);
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const auto [result, Ja] = Part::of(inverse(a[i])).evalWithJacobians(a[i]);
+
+            benchmark::DoNotOptimize(result.value());
+            benchmark::DoNotOptimize(Ja.data());
+            DEBUG_ASSERT_APPROX(result, eval(wholeThenPart<Part>(inverse(a[i]))));
+        }
+    }
+}
+
+#define WAVE_MEMBER_ACCESS_BENCHMARKS(Leaf, Part)                           \
+    BENCHMARK_TEMPLATE(BM_composePartWhole, Leaf, Part)->Arg(100);          \
+    BENCHMARK_TEMPLATE(BM_composePart, Leaf, Part)->Arg(100);               \
+    BENCHMARK_TEMPLATE(BM_inversePartWhole, Leaf, Part)->Arg(100);          \
+    BENCHMARK_TEMPLATE(BM_inversePart, Leaf, Part)->Arg(100);
+
+WAVE_MEMBER_ACCESS_BENCHMARKS(wave::RigidTransformMd, RotationPart)
+WAVE_MEMBER_ACCESS_BENCHMARKS(wave::RigidTransformMd, TranslationPart)
+WAVE_MEMBER_ACCESS_BENCHMARKS(wave::RigidTransformQd, RotationPart)
+WAVE_MEMBER_ACCESS_BENCHMARKS(wave::RigidTransformQd, TranslationPart)
+
+WAVE_BENCHMARK_MAIN()
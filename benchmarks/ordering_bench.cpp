@@ -0,0 +1,110 @@
+#include <benchmark/benchmark.h>
+#include <wave/geometry/estimation.hpp>
+#include <random>
+#include "bechmark_helpers.hpp"
+#include "synthetic_problems.hpp"
+
+// Synthetic pose graphs (see synthetic_problems.hpp): a robot sweeping a grid row by row,
+// with loop closures to the previous row, and a robot spiralling around a sphere, with
+// loop closures to the previous ring. We compare Cholesky fill in the natural and
+// minimum degree orderings, and the time to linearize all between-factors when
+// variables are stored in a random order, or re-laid out by reverse Cuthill-McKee (a
+// locality ordering) or by minimum degree (a fill-reducing one). In each case the
+// factors are sorted by their variables' indices, so only the memory layout differs.
+
+enum class Layout { Shuffled, ReverseCuthillMcKee, MinimumDegree };
+
+using MakeProblem = synthetic::PoseGraphProblem (*)(std::size_t,
+                                                    const synthetic::NoiseOptions &);
+
+template <MakeProblem Make>
+void BM_minimumDegreeOrdering(benchmark::State &state) {
+    const auto problem = Make(state.range(0), {});
+    const auto graph = problem.variableGraph();
+    auto ordering = std::vector<std::size_t>{};
+    for (auto _ : state) {
+        ordering = wave::minimumDegreeOrdering(graph);
+        benchmark::DoNotOptimize(ordering.data());
+    }
+
+    auto natural = std::vector<std::size_t>(problem.truth.size());
+    std::iota(natural.begin(), natural.end(), std::size_t{0});
+    state.counters["fill_natural"] = wave::choleskyFill(graph, natural);
+    state.counters["fill_ordered"] = wave::choleskyFill(graph, ordering);
+}
+
+template <MakeProblem Make, Layout L>
+void BM_linearizePoseGraph(benchmark::State &state) {
+    const auto problem = Make(state.range(0), {});
+    const auto num_poses = problem.truth.size();
+
+    // Store the poses in a random order, as if read with arbitrary ids
+    auto ids = std::vector<std::size_t>(num_poses);
+    std::iota(ids.begin(), ids.end(), std::size_t{0});
+    std::shuffle(ids.begin(), ids.end(), std::mt19937{42});
+    auto shuffled = synthetic::AlignedVector<synthetic::Pose>(num_poses);
+    for (std::size_t k = 0; k < num_poses; ++k) {
+        shuffled[ids[k]] = problem.odometry[k];
+    }
+    auto store = wave::VariableStore<synthetic::Pose>{};
+    for (const auto &T : shuffled) {
+        store.add(T);
+    }
+    auto edges = std::vector<std::pair<std::size_t, std::size_t>>{};
+    auto graph = wave::VariableGraph{num_poses};
+    for (const auto &m : problem.measurements) {
+        edges.emplace_back(ids[m.i], ids[m.j]);
+        graph.addFactor({edges.back().first, edges.back().second});
+    }
+
+    if (L != Layout::Shuffled) {
+        const auto ordering = L == Layout::ReverseCuthillMcKee
+                                ? wave::reverseCuthillMcKeeOrdering(graph)
+                                : wave::minimumDegreeOrdering(graph);
+        const auto new_index = wave::relayout(store, ordering);
+        for (auto &e : edges) {
+            e = {new_index[e.first], new_index[e.second]};
+        }
+    }
+    // Visit factors in the same order as their variables
+    for (auto &e : edges) {
+        e = std::minmax(e.first, e.second);
+    }
+    std::sort(edges.begin(), edges.end());
+
+    const auto &x = store.values<synthetic::Pose>();
+    for (auto _ : state) {
+        for (const auto &e : edges) {
+            const auto &a = x[e.first];
+            const auto &b = x[e.second];
+            const auto [r, J_a, J_b] = (inverse(a) * b).evalWithJacobians(a, b);
+
+            benchmark::DoNotOptimize(r.value().data());
+            benchmark::DoNotOptimize(J_a.data());
+            benchmark::DoNotOptimize(J_b.data());
+        }
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_minimumDegreeOrdering, synthetic::gridPoseGraph)->Arg(2500);
+BENCHMARK_TEMPLATE(BM_minimumDegreeOrdering, synthetic::spherePoseGraph)->Arg(2450);
+BENCHMARK_TEMPLATE(BM_linearizePoseGraph, synthetic::gridPoseGraph, Layout::Shuffled)
+  ->Arg(90000);
+BENCHMARK_TEMPLATE(BM_linearizePoseGraph,
+                   synthetic::gridPoseGraph,
+                   Layout::ReverseCuthillMcKee)
+  ->Arg(90000);
+BENCHMARK_TEMPLATE(BM_linearizePoseGraph, synthetic::gridPoseGraph, Layout::MinimumDegree)
+  ->Arg(90000);
+BENCHMARK_TEMPLATE(BM_linearizePoseGraph, synthetic::spherePoseGraph, Layout::Shuffled)
+  ->Arg(80000);
+BENCHMARK_TEMPLATE(BM_linearizePoseGraph,
+                   synthetic::spherePoseGraph,
+                   Layout::ReverseCuthillMcKee)
+  ->Arg(80000);
+BENCHMARK_TEMPLATE(BM_linearizePoseGraph,
+                   synthetic::spherePoseGraph,
+                   Layout::MinimumDegree)
+  ->Arg(80000);
+
+WAVE_BENCHMARK_MAIN()
@@ -0,0 +1,109 @@
+#include <benchmark/benchmark.h>
+#include "bechmark_helpers.hpp"
+#include "synthetic_problems.hpp"
+
+// One Gauss-Newton step on a multi-robot map: four grid pose graphs, each with a prior
+// on its first pose, either separate or joined in a chain by a single loop closure
+// between consecutive robots. We compare one sparse LDLT of the whole system with
+// solvePartitioned() on a pool of 1 or 4 threads, which solves the robots' maps as
+// separate components, or as sides of the joining poses.
+
+using synthetic::Pose;
+
+constexpr std::size_t NumRobots = 4;
+
+/** The normal equations of the map, and the graph and offsets of its poses */
+struct System {
+    System(std::size_t poses_per_robot, bool joined) {
+        const auto problem = synthetic::gridPoseGraph(poses_per_robot);
+        const auto m = problem.odometry.size();
+        const auto n = NumRobots * m;
+        auto triplets = std::vector<Eigen::Triplet<double>>{};
+        const auto addBlock = [&triplets](std::size_t r, std::size_t c, const auto &B) {
+            for (int a = 0; a < 6; ++a) {
+                for (int b = 0; b < 6; ++b) {
+                    triplets.emplace_back(r + a, c + b, B(a, b));
+                }
+            }
+        };
+        this->graph = wave::VariableGraph{n};
+        this->b = Eigen::VectorXd::Zero(6 * n);
+        const auto addFactor = [&](std::size_t i,
+                                   std::size_t j,
+                                   const Pose &T_i,
+                                   const Pose &T_j,
+                                   const Pose &measured) {
+            const auto [r, J_i, J_j] =
+              ((inverse(T_i) * T_j) - measured).evalWithJacobians(T_i, T_j);
+            addBlock(6 * i, 6 * i, J_i.transpose() * J_i);
+            addBlock(6 * i, 6 * j, J_i.transpose() * J_j);
+            addBlock(6 * j, 6 * i, J_j.transpose() * J_i);
+            addBlock(6 * j, 6 * j, J_j.transpose() * J_j);
+            this->b.segment<6>(6 * i) -= J_i.transpose() * r.value();
+            this->b.segment<6>(6 * j) -= J_j.transpose() * r.value();
+            this->graph.addFactor({i, j});
+        };
+
+        const auto &x = problem.odometry;
+        const Pose link = wave::eval(inverse(x[m - 1]) * x[0]);
+        for (std::size_t k = 0; k < NumRobots; ++k) {
+            const auto first = k * m;
+            for (const auto &meas : problem.measurements) {
+                addFactor(
+                  first + meas.i, first + meas.j, x[meas.i], x[meas.j], meas.transform);
+            }
+            addBlock(6 * first, 6 * first, Eigen::Matrix<double, 6, 6>::Identity());
+            if (joined && k + 1 < NumRobots) {
+                // The last pose of this robot sees the first pose of the next
+                addFactor(first + m - 1, first + m, x[m - 1], x[0], link);
+            }
+        }
+        this->H.resize(6 * n, 6 * n);
+        this->H.setFromTriplets(triplets.begin(), triplets.end());
+        this->offsets.resize(n + 1);
+        for (std::size_t v = 0; v <= n; ++v) {
+            this->offsets[v] = 6 * v;
+        }
+    }
+
+    Eigen::SparseMatrix<double> H;
+    Eigen::VectorXd b;
+    wave::VariableGraph graph{0};
+    std::vector<Eigen::Index> offsets;
+};
+
+void BM_solveWhole(benchmark::State &state) {
+    const auto system = System{static_cast<std::size_t>(state.range(0)), state.range(1)};
+    for (auto _ : state) {
+        const Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> solver{system.H};
+        const Eigen::VectorXd delta = solver.solve(system.b);
+        benchmark::DoNotOptimize(delta.data());
+    }
+}
+
+void BM_solvePartitioned(benchmark::State &state) {
+    const auto system = System{static_cast<std::size_t>(state.range(0)), state.range(1)};
+    auto pool = wave::WorkStealingPool{static_cast<std::size_t>(state.range(2))};
+    auto options = wave::PartitionOptions{};
+    options.pool = &pool;
+    for (auto _ : state) {
+        const Eigen::VectorXd delta = wave::solvePartitioned(
+          system.H, system.b, system.graph, system.offsets, options);
+        benchmark::DoNotOptimize(delta.data());
+    }
+}
+
+BENCHMARK(BM_solveWhole)
+  ->Args({2500, 0})
+  ->Args({2500, 1})
+  ->Unit(benchmark::kMillisecond)
+  ->UseRealTime();
+BENCHMARK(BM_solvePartitioned)
+  ->Args({2500, 0, 1})
+  ->Args({2500, 0, 4})
+  ->Args({2500, 1, 1})
+  ->Args({2500, 1, 4})
+  ->Unit(benchmark::kMillisecond)
+  ->UseRealTime();
+
+WAVE_BENCHMARK_MAIN()
@@ -0,0 +1,105 @@
+#include <benchmark/benchmark.h>
+#include <wave/geometry/estimation.hpp>
+#include "bechmark_helpers.hpp"
+
+// Solves many small rotation-averaging problems by Gauss-Newton, updating the variables
+// with each retraction policy. Reports iterations to converge and iterations per second.
+
+namespace {
+
+constexpr int NumMeasurements = 4;
+
+struct RotationAveraging {
+    explicit RotationAveraging(int n) {
+        // Give every policy the same problem
+        std::srand(42);
+        for (int i = 0; i < n; ++i) {
+            const auto truth = wave::RotationQd::Random();
+            for (int k = 0; k < NumMeasurements; ++k) {
+                const auto noise = wave::RelativeRotationd{0.05 * Eigen::Vector3d::Random()};
+                measurements.push_back(wave::eval(truth + noise));
+            }
+            // Start far from the solution
+            const auto offset = wave::RelativeRotationd{1.0 * Eigen::Vector3d::Random()};
+            initial.add(wave::eval(truth + offset));
+        }
+    }
+
+    /** Fills the Gauss-Newton step for every variable, returning the total cost */
+    double step(const wave::VariableStore<wave::RotationQd> &store,
+                Eigen::VectorXd &delta) const {
+        const auto &x = store.values<wave::RotationQd>();
+        double cost = 0;
+        for (std::size_t i = 0; i < x.size(); ++i) {
+            Eigen::Matrix3d H = Eigen::Matrix3d::Zero();
+            Eigen::Vector3d g = Eigen::Vector3d::Zero();
+            for (int k = 0; k < NumMeasurements; ++k) {
+                const auto &z = measurements[i * NumMeasurements + k];
+                const auto [r, J, Jz] = (x[i] - z).evalWithJacobians(x[i], z);
+                (void) Jz;
+                H += J.transpose() * J;
+                g += J.transpose() * r.value();
+                cost += r.value().squaredNorm();
+            }
+            delta.segment<3>(3 * i) = -H.ldlt().solve(g);
+        }
+        return cost;
+    }
+
+    std::vector<wave::RotationQd, Eigen::aligned_allocator<wave::RotationQd>> measurements;
+    wave::VariableStore<wave::RotationQd> initial;
+};
+
+}  // namespace
+
+template <typename Policy>
+void BM_rotationAveraging(benchmark::State &state) {
+    const auto problem = RotationAveraging{static_cast<int>(state.range(0))};
+    Eigen::VectorXd delta{problem.initial.tangentSize()};
+    int iterations = 0;
+    int total_iterations = 0;
+    double cost = 0;
+
+    for (auto _ : state) {
+        auto store = problem.initial;
+        for (iterations = 0; iterations < 100; ++iterations) {
+            cost = problem.step(store, delta);
+            if (delta.lpNorm<Eigen::Infinity>() < 1e-10) {
+                break;
+            }
+            wave::boxPlus(store, delta, wave::Retractions<Policy>{});
+        }
+        total_iterations += iterations;
+        benchmark::DoNotOptimize(store.values<wave::RotationQd>().data());
+    }
+
+    state.counters["iterations"] = iterations;
+    state.counters["cost"] = cost;
+    state.counters["iterations/s"] =
+      benchmark::Counter(total_iterations, benchmark::Counter::kIsRate);
+}
+
+template <typename Policy>
+void BM_retractionOnly(benchmark::State &state) {
+    auto store = wave::VariableStore<wave::RotationQd>{};
+    for (auto i = state.range(0); i--;) {
+        store.add(wave::RotationQd::Random());
+    }
+    const Eigen::VectorXd delta = 1e-2 * Eigen::VectorXd::Random(store.tangentSize());
+    auto options = wave::BoxPlusOptions{};
+    options.renormalize_quaternions = true;
+
+    for (auto _ : state) {
+        wave::boxPlus(store, delta, wave::Retractions<Policy>{}, options);
+        benchmark::DoNotOptimize(store.values<wave::RotationQd>().data());
+    }
+}
+
+BENCHMARK_TEMPLATE(BM_rotationAveraging, wave::ExpRetraction)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_rotationAveraging, wave::CayleyRetraction)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_rotationAveraging, wave::FirstOrderRetraction)->Arg(1000);
+BENCHMARK_TEMPLATE(BM_retractionOnly, wave::ExpRetraction)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_retractionOnly, wave::CayleyRetraction)->Arg(10000);
+BENCHMARK_TEMPLATE(BM_retractionOnly, wave::FirstOrderRetraction)->Arg(10000);
+
+WAVE_BENCHMARK_MAIN()
@@ -238,4 +238,35 @@ BENCHMARK_F(RotateChain, wave10)(benchmark::State &state) {
     }
 }
 
+// Value only, without Jacobians. The chain is evaluated right to left, as products of a
+// rotation with a vector.
+
+BENCHMARK_F(RotateChain, waveValue2)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto v0 = eval(R9[i] * R10[i] * v10[i]);
+            benchmark::DoNotOptimize(v0);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveValue5)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto v0 = eval(R6[i] * R7[i] * R8[i] * R9[i] * R10[i] * v10[i]);
+            benchmark::DoNotOptimize(v0);
+        }
+    }
+}
+
+BENCHMARK_F(RotateChain, waveValue10)(benchmark::State &state) {
+    for (auto _ : state) {
+        for (auto i = N; i-- > 0;) {
+            const auto v0 = eval(R1[i] * R2[i] * R3[i] * R4[i] * R5[i] * R6[i] * R7[i] *
+                                 R8[i] * R9[i] * R10[i] * v10[i]);
+            benchmark::DoNotOptimize(v0);
+        }
+    }
+}
+
 WAVE_BENCHMARK_MAIN()
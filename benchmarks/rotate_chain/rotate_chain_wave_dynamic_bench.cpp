@@ -25,6 +25,25 @@ void BM_waveAll(benchmark::State &state) {
     }
 }
 
+void BM_waveCheckpointed(benchmark::State &state) {
+    const auto N = state.range(0);
+    const auto checkpoints = state.range(1);
+    state.SetComplexityN(N);
+    // Produce the expression tree
+    auto expr = makeProxy(wave::Translationd::Random());
+    for (auto i = N; i > 0; --i) {
+        expr = makeProxy(makeProxy(wave::RotationMd::Random()) * expr);
+    }
+
+    for (auto _ : state) {
+        auto [res, jac_map] =
+          wave::internal::evaluateWithCheckpointedReverseJacobians(expr, checkpoints);
+
+        benchmark::DoNotOptimize(res);
+        benchmark::DoNotOptimize(jac_map);
+    }
+}
+
 void BM_dynamicNoVirtual(benchmark::State &state) {
     auto v = wave::Translationd::Random();
     std::array<wave::RotationMd, 10> R{};
@@ -63,6 +82,11 @@ void BM_waveDynamicLeaves(benchmark::State &state) {
 // BENCHMARK(BM_waveDynamicLeaves)->Range(10, 200000)->Complexity();
 // BENCHMARK(BM_waveDynamic)->Arg(10);
 BENCHMARK(BM_waveAll)->RangeMultiplier(2)->DenseRange(1, 1 << 14)->Complexity();
+// Chains deeper than about 1 << 14 overflow the stack in BM_waveAll
+BENCHMARK(BM_waveCheckpointed)
+  ->RangeMultiplier(8)
+  ->Ranges({{1 << 10, 1 << 16}, {4, 64}})
+  ->Complexity();
 // BENCHMARK(BM_dynamicNoVirtual);
 
 WAVE_BENCHMARK_MAIN()
@@ -0,0 +1,356 @@
+/**
+ * @file
+ * Deterministic generators of large synthetic estimation problems, for benchmarks
+ */
+
+#ifndef WAVE_GEOMETRY_SYNTHETIC_PROBLEMS_HPP
+#define WAVE_GEOMETRY_SYNTHETIC_PROBLEMS_HPP
+
+#include <wave/geometry/estimation.hpp>
+#include <cmath>
+#include <random>
+
+namespace synthetic {
+
+using Pose = wave::RigidTransformMd;
+
+template <typename T>
+using AlignedVector = std::vector<T, Eigen::aligned_allocator<T>>;
+
+/** Standard deviations of measurement noise, and the seed of the generator
+ *
+ * The same options always give the same problem.
+ */
+struct NoiseOptions {
+    double rotation_sigma = 0.01;     // radians
+    double translation_sigma = 0.05;  // metres
+    double pixel_sigma = 1.0;         // pixels
+    double gyro_sigma = 1e-3;         // radians per second
+    double accel_sigma = 1e-2;        // metres per second squared
+    unsigned seed = 42;
+};
+
+/** Returns a vector of independent zero-mean normal samples */
+template <int N>
+Eigen::Matrix<double, N, 1> normal(std::mt19937 &rng, double sigma) {
+    auto dist = std::normal_distribution<double>{0, sigma};
+    Eigen::Matrix<double, N, 1> v;
+    for (int i = 0; i < N; ++i) {
+        v[i] = dist(rng);
+    }
+    return v;
+}
+
+/** Returns a pose perturbed by a random twist */
+inline Pose perturb(const Pose &T, std::mt19937 &rng, const NoiseOptions &noise) {
+    Eigen::Matrix<double, 6, 1> twist;
+    twist << normal<3>(rng, noise.rotation_sigma),
+      normal<3>(rng, noise.translation_sigma);
+    return wave::eval(T + wave::Twistd{twist});
+}
+
+/** A pose graph with odometry and loop closures */
+struct PoseGraphProblem {
+    AlignedVector<Pose> truth;
+
+    /** Poses composed along the odometry measurements, from the first true pose */
+    AlignedVector<Pose> odometry;
+
+    /** Noisy relative poses: odometry between consecutive poses, then loop closures */
+    std::vector<wave::RelativePoseMeasurement<Pose>> measurements;
+
+    void addMeasurement(std::size_t i,
+                        std::size_t j,
+                        std::mt19937 &rng,
+                        const NoiseOptions &noise) {
+        const auto T_ij = Pose{inverse(this->truth[i]) * this->truth[j]};
+        this->measurements.push_back({i, j, perturb(T_ij, rng, noise)});
+    }
+
+    /** Returns the graph of the poses and their measurements */
+    wave::VariableGraph variableGraph() const {
+        auto graph = wave::VariableGraph{this->truth.size()};
+        for (const auto &m : this->measurements) {
+            graph.addFactor({m.i, m.j});
+        }
+        return graph;
+    }
+
+    /** Fills `odometry`, once the first truth.size() - 1 measurements are odometry */
+    void composeOdometry() {
+        this->odometry.clear();
+        this->odometry.reserve(this->truth.size());
+        this->odometry.push_back(this->truth.front());
+        for (std::size_t k = 1; k < this->truth.size(); ++k) {
+            this->odometry.push_back(
+              Pose{this->odometry.back() * this->measurements[k - 1].transform});
+        }
+    }
+};
+
+/** Returns a robot sweeping a square grid row by row, with loop closures to the
+ * previous row
+ *
+ * @param num_poses approximate number of poses, rounded to a square
+ */
+inline PoseGraphProblem gridPoseGraph(std::size_t num_poses,
+                                      const NoiseOptions &noise = {}) {
+    const auto side = std::max<std::size_t>(2, std::lround(std::sqrt(num_poses)));
+    auto rng = std::mt19937{noise.seed};
+    auto problem = PoseGraphProblem{};
+
+    // Pose k is at row k / side, and column k % side on even rows, reversed on odd rows
+    const auto index = [side](std::size_t r, std::size_t c) {
+        return r * side + (r % 2 ? side - 1 - c : c);
+    };
+    for (std::size_t r = 0; r < side; ++r) {
+        for (std::size_t k = 0; k < side; ++k) {
+            const auto c = r % 2 ? side - 1 - k : k;
+            const auto yaw = r % 2 ? M_PI : 0.0;
+            problem.truth.emplace_back(Eigen::AngleAxisd{yaw, Eigen::Vector3d::UnitZ()},
+                                       Eigen::Vector3d(c, r, 0));
+        }
+    }
+    for (std::size_t k = 0; k + 1 < problem.truth.size(); ++k) {
+        problem.addMeasurement(k, k + 1, rng, noise);
+    }
+    for (std::size_t r = 1; r < side; ++r) {
+        for (std::size_t c = 0; c < side; ++c) {
+            problem.addMeasurement(index(r - 1, c), index(r, c), rng, noise);
+        }
+    }
+    problem.composeOdometry();
+    return problem;
+}
+
+/** Returns a robot spiralling around a sphere, in rings of twice as many poses as there
+ * are rings, with loop closures to the previous ring
+ *
+ * @param num_poses approximate number of poses
+ */
+inline PoseGraphProblem spherePoseGraph(std::size_t num_poses,
+                                        const NoiseOptions &noise = {}) {
+    const auto rings = std::max<std::size_t>(2, std::lround(std::sqrt(num_poses / 2.0)));
+    const auto per_ring = 2 * rings;
+    auto rng = std::mt19937{noise.seed};
+    auto problem = PoseGraphProblem{};
+
+    const auto radius = static_cast<double>(rings);
+    for (std::size_t r = 0; r < rings; ++r) {
+        for (std::size_t p = 0; p < per_ring; ++p) {
+            const auto lat = M_PI * ((r + 0.5) / rings - 0.5);
+            const auto lon = 2 * M_PI * p / per_ring;
+            const auto R = Eigen::AngleAxisd{lon, Eigen::Vector3d::UnitZ()} *
+                           Eigen::AngleAxisd{-lat, Eigen::Vector3d::UnitY()};
+            const auto t = Eigen::Vector3d{std::cos(lat) * std::cos(lon),
+                                           std::cos(lat) * std::sin(lon),
+                                           std::sin(lat)};
+            problem.truth.emplace_back(R, radius * t);
+        }
+    }
+    for (std::size_t k = 0; k + 1 < problem.truth.size(); ++k) {
+        problem.addMeasurement(k, k + 1, rng, noise);
+    }
+    for (std::size_t k = per_ring; k < problem.truth.size(); ++k) {
+        problem.addMeasurement(k - per_ring, k, rng, noise);
+    }
+    problem.composeOdometry();
+    return problem;
+}
+
+/** Runs Gauss-Newton on a pose graph with the first pose fixed, until the update is
+ * small, returning the number of iterations
+ */
+inline int gaussNewton(
+  wave::VariableStore<Pose> &store,
+  const std::vector<wave::RelativePoseMeasurement<Pose>> &measurements,
+  int max_iterations = 100) {
+    const auto n = store.tangentSize();
+    int iteration = 0;
+    for (; iteration < max_iterations; ++iteration) {
+        const auto &x = store.values<Pose>();
+        auto triplets = std::vector<Eigen::Triplet<double>>{};
+        triplets.reserve(4 * 36 * measurements.size() + 6);
+        Eigen::VectorXd g = Eigen::VectorXd::Zero(n);
+        const auto addBlock = [&triplets](std::size_t r, std::size_t c, const auto &B) {
+            for (int a = 0; a < 6; ++a) {
+                for (int b = 0; b < 6; ++b) {
+                    triplets.emplace_back(r + a, c + b, B(a, b));
+                }
+            }
+        };
+        for (const auto &m : measurements) {
+            const auto &T_i = x[m.i];
+            const auto &T_j = x[m.j];
+            const auto [r, J_i, J_j] =
+              ((inverse(T_i) * T_j) - m.transform).evalWithJacobians(T_i, T_j);
+            const auto a = 6 * m.i;
+            const auto b = 6 * m.j;
+            addBlock(a, a, J_i.transpose() * J_i);
+            addBlock(a, b, J_i.transpose() * J_j);
+            addBlock(b, a, J_j.transpose() * J_i);
+            addBlock(b, b, J_j.transpose() * J_j);
+            g.segment<6>(a) += J_i.transpose() * r.value();
+            g.segment<6>(b) += J_j.transpose() * r.value();
+        }
+        // Fix the first pose
+        for (int a = 0; a < 6; ++a) {
+            triplets.emplace_back(a, a, 1e9);
+        }
+
+        Eigen::SparseMatrix<double> H(n, n);
+        H.setFromTriplets(triplets.begin(), triplets.end());
+        const Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> solver{H};
+        const Eigen::VectorXd delta = -solver.solve(g);
+        wave::boxPlus(store, delta);
+        if (delta.norm() < 1e-6) {
+            break;
+        }
+    }
+    return iteration + 1;
+}
+
+/** A rig of cameras on a robot circling through a field of landmarks
+ *
+ * Each camera looks out horizontally, with z forward and y down, at evenly spaced yaw
+ * angles around the rig. Pixels are pinhole projections f * (x / z, y / z).
+ */
+struct BundleAdjustmentProblem {
+    struct Observation {
+        std::size_t frame;
+        std::size_t camera;
+        std::size_t landmark;
+        Eigen::Vector2d pixel;
+    };
+
+    double focal_length = 500;
+
+    /** T_world_body of each frame */
+    AlignedVector<Pose> rig_poses;
+
+    /** T_body_camera of each camera */
+    AlignedVector<Pose> extrinsics;
+
+    /** Position of each landmark in the world */
+    AlignedVector<wave::Translationd> landmarks;
+
+    AlignedVector<Observation> observations;
+};
+
+/** Returns a multi-camera bundle adjustment problem
+ *
+ * Each landmark is observed in up to `observations_per_landmark` random frames, by the
+ * camera facing it most directly, if it is in front of that camera.
+ */
+inline BundleAdjustmentProblem multiCameraBundleAdjustment(
+  std::size_t num_frames,
+  std::size_t num_cameras,
+  std::size_t num_landmarks,
+  std::size_t observations_per_landmark = 4,
+  const NoiseOptions &noise = {}) {
+    auto rng = std::mt19937{noise.seed};
+    auto uniform = [&rng](double a, double b) {
+        return std::uniform_real_distribution<double>{a, b}(rng);
+    };
+    auto problem = BundleAdjustmentProblem{};
+
+    for (std::size_t c = 0; c < num_cameras; ++c) {
+        const auto yaw = 2 * M_PI * c / num_cameras;
+        Eigen::Matrix3d R;
+        R.col(0) << std::sin(yaw), -std::cos(yaw), 0;
+        R.col(1) << 0, 0, -1;
+        R.col(2) << std::cos(yaw), std::sin(yaw), 0;
+        problem.extrinsics.emplace_back(R, Eigen::Vector3d(0.1 * std::cos(yaw),
+                                                           0.1 * std::sin(yaw),
+                                                           0));
+    }
+    const double circle = 20;
+    for (std::size_t k = 0; k < num_frames; ++k) {
+        const auto angle = 2 * M_PI * k / num_frames;
+        problem.rig_poses.emplace_back(
+          Eigen::AngleAxisd{angle + M_PI / 2, Eigen::Vector3d::UnitZ()},
+          Eigen::Vector3d(circle * std::cos(angle), circle * std::sin(angle), 0));
+    }
+    for (std::size_t l = 0; l < num_landmarks; ++l) {
+        const auto angle = uniform(0, 2 * M_PI);
+        const auto radius = l % 2 ? uniform(28, 40) : uniform(2, 12);
+        const auto height = uniform(-5, 5);
+        problem.landmarks.emplace_back(
+          Eigen::Vector3d(radius * std::cos(angle), radius * std::sin(angle), height));
+    }
+
+    auto frame_dist = std::uniform_int_distribution<std::size_t>{0, num_frames - 1};
+    for (std::size_t l = 0; l < num_landmarks; ++l) {
+        const auto &p = problem.landmarks[l];
+        for (std::size_t n = 0; n < observations_per_landmark; ++n) {
+            const auto k = frame_dist(rng);
+            auto best = std::size_t{0};
+            Eigen::Vector3d best_p_c = Eigen::Vector3d::Zero();
+            for (std::size_t c = 0; c < num_cameras; ++c) {
+                const auto T_wc = Pose{problem.rig_poses[k] * problem.extrinsics[c]};
+                const Eigen::Vector3d p_c = wave::eval(inverse(T_wc) * p).value();
+                if (p_c.z() > best_p_c.z()) {
+                    best = c;
+                    best_p_c = p_c;
+                }
+            }
+            if (best_p_c.z() > 0.5) {
+                const Eigen::Vector2d pixel = problem.focal_length * best_p_c.head<2>() /
+                                                best_p_c.z() +
+                                              normal<2>(rng, noise.pixel_sigma);
+                problem.observations.push_back({k, best, l, pixel});
+            }
+        }
+    }
+    return problem;
+}
+
+/** A smooth 3D trajectory sampled at a fixed rate, with noisy IMU measurements */
+struct ImuProblem {
+    double dt;
+
+    /** T_world_body at each sample */
+    AlignedVector<Pose> truth;
+
+    /** Measured angular velocity in the body frame, from each sample to the next */
+    AlignedVector<Eigen::Vector3d> gyro;
+
+    /** Measured specific force in the body frame, from each sample to the next */
+    AlignedVector<Eigen::Vector3d> accel;
+};
+
+/** Returns an IMU trajectory with gravity along -z */
+inline ImuProblem imuTrajectory(std::size_t num_samples,
+                                double dt = 0.005,
+                                const NoiseOptions &noise = {}) {
+    auto rng = std::mt19937{noise.seed};
+    auto problem = ImuProblem{dt, {}, {}, {}};
+    const Eigen::Vector3d gravity{0, 0, -9.81};
+
+    auto R = wave::RotationMd{Eigen::Matrix3d::Identity()};
+    Eigen::Vector3d v = Eigen::Vector3d::Zero();
+    Eigen::Vector3d p = Eigen::Vector3d::Zero();
+    for (std::size_t k = 0; k < num_samples; ++k) {
+        problem.truth.emplace_back(R.value(), p);
+        if (k + 1 == num_samples) {
+            break;
+        }
+        const auto t = k * dt;
+        const Eigen::Vector3d w{0.3 * std::sin(0.5 * t), 0.2 * std::cos(0.3 * t), 0.5};
+        const Eigen::Vector3d a_body{
+          std::sin(t), std::cos(0.7 * t), 0.1 * std::sin(2 * t)};
+        const Eigen::Vector3d f = a_body - R.value().transpose() * gravity;
+        problem.gyro.push_back(w + normal<3>(rng, noise.gyro_sigma));
+        problem.accel.push_back(f + normal<3>(rng, noise.accel_sigma));
+
+        const Eigen::Vector3d a_world = R.value() * a_body;
+        p += v * dt + 0.5 * a_world * dt * dt;
+        v += a_world * dt;
+        R = wave::RotationMd{R * exp(wave::RelativeRotationd{w * dt})};
+    }
+    return problem;
+}
+
+}  // namespace synthetic
+
+#endif  // WAVE_GEOMETRY_SYNTHETIC_PROBLEMS_HPP
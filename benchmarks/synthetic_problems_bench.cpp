@@ -0,0 +1,234 @@
+#include <benchmark/benchmark.h>
+#include "bechmark_helpers.hpp"
+#include "synthetic_problems.hpp"
+
+// Scaling of residual evaluation, linearization and solving on synthetic problems of
+// 10^3 to 10^6 variables: grid and sphere pose graphs with loop closures, a rig of four
+// cameras observing landmarks (one variable per frame and per landmark), and rotations
+// sampled along an IMU trajectory, constrained by the integrated gyro between samples.
+// Solving is Gauss-Newton from the chordal initialization, for pose graphs only, and up
+// to 10^4 variables since the scalar sparse LDLT dominates beyond that.
+
+using synthetic::Pose;
+using synthetic::NoiseOptions;
+
+/** Returns a problem made by `make(n)`, keeping only the last one of each type alive, so
+ * the largest problems are generated once and not all held at once
+ */
+template <typename Problem, typename Make>
+const Problem &cached(Make make, std::size_t n) {
+    static auto key = std::pair<void (*)(), std::size_t>{};
+    static auto problem = Problem{};
+    const auto this_key = std::make_pair(reinterpret_cast<void (*)()>(make), n);
+    if (key != this_key) {
+        problem = Problem{};
+        problem = make(n, NoiseOptions{});
+        key = this_key;
+    }
+    return problem;
+}
+
+synthetic::BundleAdjustmentProblem bundleAdjustment(std::size_t n,
+                                                    const NoiseOptions &noise) {
+    const auto num_frames = n / 10;
+    return synthetic::multiCameraBundleAdjustment(
+      num_frames, 4, n - num_frames, 4, noise);
+}
+
+synthetic::ImuProblem imu(std::size_t n, const NoiseOptions &noise) {
+    return synthetic::imuTrajectory(n, 0.005, noise);
+}
+
+using MakePoseGraph = synthetic::PoseGraphProblem (*)(std::size_t, const NoiseOptions &);
+
+template <MakePoseGraph Make>
+void BM_poseGraphResiduals(benchmark::State &state) {
+    const auto &problem = cached<synthetic::PoseGraphProblem>(Make, state.range(0));
+    const auto &x = problem.odometry;
+    for (auto _ : state) {
+        for (const auto &m : problem.measurements) {
+            const auto r = wave::eval((inverse(x[m.i]) * x[m.j]) - m.transform);
+            benchmark::DoNotOptimize(r.value().data());
+        }
+    }
+    state.counters["variables"] = x.size();
+    state.counters["factors"] = problem.measurements.size();
+}
+
+template <MakePoseGraph Make>
+void BM_poseGraphLinearize(benchmark::State &state) {
+    const auto &problem = cached<synthetic::PoseGraphProblem>(Make, state.range(0));
+    const auto &x = problem.odometry;
+    for (auto _ : state) {
+        for (const auto &m : problem.measurements) {
+            const auto &T_i = x[m.i];
+            const auto &T_j = x[m.j];
+            const auto [r, J_i, J_j] =
+              ((inverse(T_i) * T_j) - m.transform).evalWithJacobians(T_i, T_j);
+            benchmark::DoNotOptimize(r.value().data());
+            benchmark::DoNotOptimize(J_i.data());
+            benchmark::DoNotOptimize(J_j.data());
+        }
+    }
+    state.counters["variables"] = x.size();
+    state.counters["factors"] = problem.measurements.size();
+}
+
+template <MakePoseGraph Make>
+void BM_poseGraphSolve(benchmark::State &state) {
+    const auto &problem = cached<synthetic::PoseGraphProblem>(Make, state.range(0));
+    int iterations = 0;
+    for (auto _ : state) {
+        auto store = wave::VariableStore<Pose>{};
+        for (const auto &T : problem.odometry) {
+            store.add(T);
+        }
+        wave::initializePosesChordal<Pose>(store, problem.measurements);
+        iterations = synthetic::gaussNewton(store, problem.measurements);
+        benchmark::DoNotOptimize(store.values<Pose>().data());
+    }
+    state.counters["variables"] = problem.truth.size();
+    state.counters["iterations"] = iterations;
+}
+
+/** Returns the pinhole projection of a point in the camera frame, and its Jacobian */
+std::pair<Eigen::Vector2d, Eigen::Matrix<double, 2, 3>> project(
+  double f, const Eigen::Vector3d &p) {
+    const auto z_inv = 1 / p.z();
+    Eigen::Matrix<double, 2, 3> J;
+    J << f * z_inv, 0, -f * p.x() * z_inv * z_inv,  //
+      0, f * z_inv, -f * p.y() * z_inv * z_inv;
+    return {f * z_inv * p.head<2>(), J};
+}
+
+void BM_bundleAdjustmentResiduals(benchmark::State &state) {
+    const auto &problem =
+      cached<synthetic::BundleAdjustmentProblem>(bundleAdjustment, state.range(0));
+    for (auto _ : state) {
+        for (const auto &o : problem.observations) {
+            const auto &T_wb = problem.rig_poses[o.frame];
+            const auto &T_bc = problem.extrinsics[o.camera];
+            const auto &p = problem.landmarks[o.landmark];
+            const auto p_c = wave::eval(inverse(T_wb * T_bc) * p);
+            const Eigen::Vector2d r =
+              problem.focal_length * p_c.value().head<2>() / p_c.value().z() - o.pixel;
+            benchmark::DoNotOptimize(r.data());
+        }
+    }
+    state.counters["variables"] = problem.rig_poses.size() + problem.landmarks.size();
+    state.counters["factors"] = problem.observations.size();
+}
+
+void BM_bundleAdjustmentLinearize(benchmark::State &state) {
+    const auto &problem =
+      cached<synthetic::BundleAdjustmentProblem>(bundleAdjustment, state.range(0));
+    for (auto _ : state) {
+        for (const auto &o : problem.observations) {
+            const auto &T_wb = problem.rig_poses[o.frame];
+            const auto &T_bc = problem.extrinsics[o.camera];
+            const auto &p = problem.landmarks[o.landmark];
+            const auto [p_c, J_T, J_p] =
+              (inverse(T_wb * T_bc) * p).evalWithJacobians(T_wb, p);
+            const auto [pixel, J_proj] = project(problem.focal_length, p_c.value());
+            const Eigen::Vector2d r = pixel - o.pixel;
+            const Eigen::Matrix<double, 2, 6> J_r_T = J_proj * J_T;
+            const Eigen::Matrix<double, 2, 3> J_r_p = J_proj * J_p;
+            benchmark::DoNotOptimize(r.data());
+            benchmark::DoNotOptimize(J_r_T.data());
+            benchmark::DoNotOptimize(J_r_p.data());
+        }
+    }
+    state.counters["variables"] = problem.rig_poses.size() + problem.landmarks.size();
+    state.counters["factors"] = problem.observations.size();
+}
+
+/** Returns the sampled rotations, and the rotation integrated from the gyro between each
+ * pair of samples
+ */
+std::pair<synthetic::AlignedVector<wave::RotationMd>,
+          synthetic::AlignedVector<wave::RotationMd>>
+imuRotations(const synthetic::ImuProblem &problem) {
+    auto rotations = synthetic::AlignedVector<wave::RotationMd>{};
+    auto deltas = synthetic::AlignedVector<wave::RotationMd>{};
+    for (const auto &T : problem.truth) {
+        rotations.emplace_back(T.rotationBlock().value());
+    }
+    for (const auto &w : problem.gyro) {
+        deltas.emplace_back(exp(wave::RelativeRotationd{w * problem.dt}));
+    }
+    return {rotations, deltas};
+}
+
+void BM_imuResiduals(benchmark::State &state) {
+    const auto &problem = cached<synthetic::ImuProblem>(imu, state.range(0));
+    const auto [R, dR] = imuRotations(problem);
+    for (auto _ : state) {
+        for (std::size_t k = 0; k < dR.size(); ++k) {
+            const auto r = wave::eval((inverse(R[k]) * R[k + 1]) - dR[k]);
+            benchmark::DoNotOptimize(r.value().data());
+        }
+    }
+    state.counters["variables"] = R.size();
+    state.counters["factors"] = dR.size();
+}
+
+void BM_imuLinearize(benchmark::State &state) {
+    const auto &problem = cached<synthetic::ImuProblem>(imu, state.range(0));
+    const auto [R, dR] = imuRotations(problem);
+    for (auto _ : state) {
+        for (std::size_t k = 0; k < dR.size(); ++k) {
+            const auto &R_a = R[k];
+            const auto &R_b = R[k + 1];
+            const auto [r, J_a, J_b] =
+              ((inverse(R_a) * R_b) - dR[k]).evalWithJacobians(R_a, R_b);
+            benchmark::DoNotOptimize(r.value().data());
+            benchmark::DoNotOptimize(J_a.data());
+            benchmark::DoNotOptimize(J_b.data());
+        }
+    }
+    state.counters["variables"] = R.size();
+    state.counters["factors"] = dR.size();
+}
+
+BENCHMARK_TEMPLATE(BM_poseGraphResiduals, synthetic::gridPoseGraph)
+  ->RangeMultiplier(10)
+  ->Range(1000, 1000000)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_poseGraphResiduals, synthetic::spherePoseGraph)
+  ->RangeMultiplier(10)
+  ->Range(1000, 1000000)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_poseGraphLinearize, synthetic::gridPoseGraph)
+  ->RangeMultiplier(10)
+  ->Range(1000, 1000000)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_poseGraphLinearize, synthetic::spherePoseGraph)
+  ->RangeMultiplier(10)
+  ->Range(1000, 1000000)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_poseGraphSolve, synthetic::gridPoseGraph)
+  ->RangeMultiplier(10)
+  ->Range(1000, 10000)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK_TEMPLATE(BM_poseGraphSolve, synthetic::spherePoseGraph)
+  ->RangeMultiplier(10)
+  ->Range(1000, 10000)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_bundleAdjustmentResiduals)
+  ->RangeMultiplier(10)
+  ->Range(1000, 1000000)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_bundleAdjustmentLinearize)
+  ->RangeMultiplier(10)
+  ->Range(1000, 1000000)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_imuResiduals)
+  ->RangeMultiplier(10)
+  ->Range(1000, 1000000)
+  ->Unit(benchmark::kMillisecond);
+BENCHMARK(BM_imuLinearize)
+  ->RangeMultiplier(10)
+  ->Range(1000, 1000000)
+  ->Unit(benchmark::kMillisecond);
+
+WAVE_BENCHMARK_MAIN()
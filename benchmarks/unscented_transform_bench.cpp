@@ -0,0 +1,45 @@
+#include <benchmark/benchmark.h>
+#include "bechmark_helpers.hpp"
+#include "wave/geometry/estimation.hpp"
+
+// Propagating an uncertain SE(3) pose through the measurement of a known point in the
+// body frame. We compare the unscented transform, over 13 sigma points, with
+// linearizing the measurement at the mean.
+
+using Pose = wave::RigidTransformQd;
+using Point = wave::Translationd;
+
+namespace {
+
+const auto landmark = Point{5, 1, 2};
+
+wave::Uncertain<Pose, wave::DiagonalNoise> uncertainPose() {
+    const auto R = Eigen::Quaterniond{Eigen::AngleAxisd{0.3, Eigen::Vector3d::UnitZ()}};
+    const auto T = Pose{R, Eigen::Vector3d{1, -2, 0.5}};
+    return {T, wave::DiagonalNoise<Pose>::FromStdDev(0.1, 0.1, 0.2, 0.5, 0.5, 1)};
+}
+
+const auto measure = [](const auto &T) { return inverse(T) * landmark; };
+
+}  // namespace
+
+void BM_unscentedTransform(benchmark::State &state) {
+    const auto x = uncertainPose();
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(wave::unscentedTransform(measure, x));
+    }
+}
+
+void BM_linearizedTransform(benchmark::State &state) {
+    const auto x = uncertainPose();
+    for (auto _ : state) {
+        const auto [value, J] = measure(x.value).evalWithJacobians(x.value);
+        const Eigen::Matrix3d covariance = J * x.noise.covariance() * J.transpose();
+        benchmark::DoNotOptimize(value);
+        benchmark::DoNotOptimize(covariance);
+    }
+}
+
+BENCHMARK(BM_unscentedTransform);
+BENCHMARK(BM_linearizedTransform);
+BENCHMARK_MAIN();
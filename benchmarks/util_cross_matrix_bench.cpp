@@ -198,6 +198,59 @@ void BM_EvalCross(benchmark::State &state) {
         }
     }
 }
+// The following are the cross-matrix products found in SE(3) Jacobians
+
+/** Translation-rotation block of the SE(3) adjoint, [t]x R */
+template <typename Functor>
+void BM_AdjointBlock(benchmark::State &state) {
+    const auto N = state.range(0);
+    auto t = randomMatrices<Eigen::Vector3d>(N);
+    auto R = randomMatrices<Eigen::Matrix3d>(N);
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            Eigen::Matrix3d result = Functor::call(t[i]) * R[i];
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+/** Q matrix of the SE(3) left Jacobian, with constant coefficients (Barfoot eq. 7.86b) */
+template <typename Functor>
+void BM_SE3JacobianQ(benchmark::State &state) {
+    const auto N = state.range(0);
+    auto rho = randomMatrices<Eigen::Vector3d>(N);
+    auto phi = randomMatrices<Eigen::Vector3d>(N);
+    const double a = 0.5, b = 0.1, c = 0.2, d = 0.3;
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const auto u = Functor::call(rho[i]);
+            const auto w = Functor::call(phi[i]);
+            Eigen::Matrix3d result =
+              a * u + b * (w * u + u * w + w * u * w) +
+              c * (w * w * u + u * w * w - 3 * w * u * w) +
+              d * (w * u * w * w + w * w * u * w);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
+
+/** Rotation part of the SO(3) left Jacobian, I + b[phi]x + c[phi]x^2 */
+template <typename Functor>
+void BM_SO3Jacobian(benchmark::State &state) {
+    const auto N = state.range(0);
+    auto phi = randomMatrices<Eigen::Vector3d>(N);
+    const double b = 0.3, c = 0.1;
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            const auto w = Functor::call(phi[i]);
+            Eigen::Matrix3d result = Eigen::Matrix3d::Identity() + b * w + c * (w * w);
+            benchmark::DoNotOptimize(result);
+        }
+    }
+}
 
 // BENCHMARK(BM_ManualCrossMatrix);
 // BENCHMARK(BM_ExprCrossMatrix);
@@ -236,5 +289,13 @@ BENCHMARK_TEMPLATE(BM_CrossTimesCross, WaveCross)->Arg(reps);
 BENCHMARK_TEMPLATE(BM_CrossTimesCross, ManualCross)->Arg(reps);
 BENCHMARK_TEMPLATE(BM_CrossTimesCross, WaveCross)->Arg(reps);
 
+BENCHMARK_TEMPLATE(BM_AdjointBlock, ManualCross)->Arg(reps);
+BENCHMARK_TEMPLATE(BM_AdjointBlock, WaveCross)->Arg(reps);
+
+BENCHMARK_TEMPLATE(BM_SO3Jacobian, ManualCross)->Arg(reps);
+BENCHMARK_TEMPLATE(BM_SO3Jacobian, WaveCross)->Arg(reps);
+
+BENCHMARK_TEMPLATE(BM_SE3JacobianQ, ManualCross)->Arg(reps);
+BENCHMARK_TEMPLATE(BM_SE3JacobianQ, WaveCross)->Arg(reps);
 
 BENCHMARK_MAIN();
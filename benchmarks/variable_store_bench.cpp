@@ -0,0 +1,60 @@
+#include <benchmark/benchmark.h>
+#include <wave/geometry/estimation.hpp>
+#include "bechmark_helpers.hpp"
+
+// Compares box-plus of a VariableStore against updating variables behind shared_ptrs one
+// at a time. (FactorVariable itself cannot hold quaternion leaves, so plain leaves are
+// used.)
+
+template <typename Leaf>
+void BM_boxPlusEachVariable(benchmark::State &state) {
+    using Tangent = typename wave::internal::traits<Leaf>::TangentType;
+    constexpr int Size = wave::internal::traits<Leaf>::TangentSize;
+    const auto N = state.range(0);
+    auto vars = std::vector<std::shared_ptr<Leaf>>{};
+    for (auto i = N; i--;) {
+        vars.push_back(std::allocate_shared<Leaf>(Eigen::aligned_allocator<Leaf>{},
+                                                  Leaf::Random()));
+    }
+    const Eigen::VectorXd delta = 1e-3 * Eigen::VectorXd::Random(N * Size);
+
+    for (auto _ : state) {
+        for (auto i = N; i--;) {
+            auto &x = *vars[i];
+            x = eval(x + Tangent{delta.template segment<Size>(i * Size)});
+        }
+        benchmark::DoNotOptimize(vars.front().get());
+    }
+}
+
+template <typename Leaf>
+void BM_boxPlusStore(benchmark::State &state) {
+    constexpr int Size = wave::internal::traits<Leaf>::TangentSize;
+    const auto N = state.range(0);
+    const auto threads = static_cast<std::size_t>(state.range(1));
+    auto store = wave::VariableStore<Leaf>{};
+    for (auto i = N; i--;) {
+        store.add(Leaf::Random());
+    }
+    const Eigen::VectorXd delta = 1e-3 * Eigen::VectorXd::Random(N * Size);
+    auto pool = wave::WorkStealingPool{threads};
+    auto options = wave::BoxPlusOptions{};
+    options.pool = &pool;
+
+    for (auto _ : state) {
+        wave::boxPlus(store, delta, options);
+        benchmark::DoNotOptimize(store.template values<Leaf>().data());
+    }
+}
+
+#define WAVE_BOXPLUS_BENCHMARKS(Leaf)                                              \
+    BENCHMARK_TEMPLATE(BM_boxPlusEachVariable, Leaf)->Arg(1000)->Arg(100000);      \
+    BENCHMARK_TEMPLATE(BM_boxPlusStore, Leaf)->Args({1000, 1})->Args({100000, 1}) \
+      ->Args({100000, 4});
+
+WAVE_BOXPLUS_BENCHMARKS(wave::RotationQd)
+WAVE_BOXPLUS_BENCHMARKS(wave::RotationMd)
+WAVE_BOXPLUS_BENCHMARKS(wave::RigidTransformQd)
+WAVE_BOXPLUS_BENCHMARKS(wave::Translationd)
+
+WAVE_BENCHMARK_MAIN()
@@ -14,6 +14,8 @@
 #include <boost/optional.hpp>
 // Used by DynamicReverseJacobianEvaluator
 #include <boost/container/flat_map.hpp>
+// For hash_combine, used by DynamicStructure and LinearizationCache
+#include <boost/functional/hash.hpp>
 
 // Tick library for traits checking
 #include <tick/trait_check.h>
@@ -5,7 +5,20 @@
 #ifndef WAVE_GEOMETRY_DYNAMIC_HPP
 #define WAVE_GEOMETRY_DYNAMIC_HPP
 
+#include <algorithm>
+#include <cassert>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <typeindex>
+#include <unordered_map>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
 #include "core.hpp"
+#include "src/util/parallel/WorkStealingPool.hpp"
 
 namespace wave {
 
@@ -24,8 +37,14 @@ class RefProxy;
 }  // namespace wave
 
 #include "src/dynamic/DynamicBase.hpp"
+#include "src/dynamic/BatchEvaluator.hpp"
 #include "src/dynamic/Dynamic.hpp"
+#include "src/dynamic/DynamicGraph.hpp"
 #include "src/dynamic/Proxy.hpp"
 #include "src/dynamic/RefProxy.hpp"
+#include "src/dynamic/CheckpointedReverse.hpp"
+#include "src/dynamic/ParallelEvaluation.hpp"
+#include "src/dynamic/ConstantFolding.hpp"
+#include "src/dynamic/BatchEvaluation.hpp"
 
 #endif  // WAVE_GEOMETRY_DYNAMIC_HPP
@@ -6,8 +6,36 @@
 #define WAVE_GEOMETRY_ESTIMATION_HPP
 
 #include <Eigen/Eigenvalues>
+#include <Eigen/SparseCholesky>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <cctype>
+#include <charconv>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <iterator>
+#include <memory>
+#include <mutex>
+#include <numeric>
+#include <set>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <typeindex>
+#include <unordered_map>
+#include <vector>
 
 #include "geometry.hpp"
+#include "src/util/parallel/DoubleBuffer.hpp"
+#include "src/util/parallel/MpscQueue.hpp"
+#include "src/util/parallel/WorkStealingPool.hpp"
 
 namespace wave {}  // namespace wave
 
@@ -17,5 +45,17 @@ namespace wave {}  // namespace wave
 #include "src/estimation/FactorVariable.hpp"
 #include "src/estimation/FactorBase.hpp"
 #include "src/estimation/Factor.hpp"
+#include "src/estimation/Retraction.hpp"
+#include "src/estimation/VariableStore.hpp"
+#include "src/estimation/LinearizationCache.hpp"
+#include "src/estimation/Ordering.hpp"
+#include "src/estimation/Partition.hpp"
+#include "src/estimation/ChordalInitialization.hpp"
+#include "src/estimation/G2o.hpp"
+#include "src/estimation/Covariance.hpp"
+#include "src/estimation/ConjugateGradient.hpp"
+#include "src/estimation/BackgroundSolver.hpp"
+#include "src/estimation/ErrorStateEkf.hpp"
+#include "src/estimation/UnscentedTransform.hpp"
 
 #endif  // WAVE_GEOMETRY_ESTIMATION_HPP
@@ -0,0 +1,26 @@
+/**
+ * @file Loading of g2o files, kept apart from the estimation module since it uses
+ * platform headers to map files
+ */
+
+#ifndef WAVE_GEOMETRY_G2O_HPP
+#define WAVE_GEOMETRY_G2O_HPP
+
+#include <fstream>
+#include <iterator>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "estimation.hpp"
+
+#include "src/estimation/G2oFile.hpp"
+
+#endif  // WAVE_GEOMETRY_G2O_HPP
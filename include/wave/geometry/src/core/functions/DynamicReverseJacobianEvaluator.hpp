@@ -100,7 +100,7 @@ struct DynamicReverseJacobianEvaluator<Derived,
       jacobianImpl(get_expr_tag_t<Derived>{},
                    std::declval<eval_t<Derived>>(),
                    std::declval<eval_t<typename traits<Derived>::RhsDerived>>()));
-    using RhsAdjoint = decltype(std::declval<Adjoint>() * std::declval<SelfJacobian>());
+    using RhsAdjoint = adjoint_product_t<Adjoint, SelfJacobian>;
 
 
  private:
@@ -114,7 +114,7 @@ struct DynamicReverseJacobianEvaluator<Derived,
 
     // Nested jacobian-evaluators
     const DynamicReverseJacobianEvaluator<typename traits<Derived>::RhsDerived,
-                                          RhsAdjoint>
+                                          adjoint_arg_t<RhsAdjoint>>
       rhs_eval;
 
 
@@ -148,10 +148,8 @@ struct DynamicReverseJacobianEvaluator<Derived,
                         std::declval<eval_t<Derived>>(),
                         std::declval<eval_t<typename traits<Derived>::LhsDerived>>(),
                         std::declval<eval_t<typename traits<Derived>::RhsDerived>>()));
-    using LhsAdjoint =
-      decltype(std::declval<Adjoint>() * std::declval<LhsSelfJacobian>());
-    using RhsAdjoint =
-      decltype(std::declval<Adjoint>() * std::declval<RhsSelfJacobian>());
+    using LhsAdjoint = adjoint_product_t<Adjoint, LhsSelfJacobian>;
+    using RhsAdjoint = adjoint_product_t<Adjoint, RhsSelfJacobian>;
 
 
  private:
@@ -167,10 +165,10 @@ struct DynamicReverseJacobianEvaluator<Derived,
 
     // Nested jacobian-evaluators
     const DynamicReverseJacobianEvaluator<typename traits<Derived>::LhsDerived,
-                                          LhsAdjoint>
+                                          adjoint_arg_t<LhsAdjoint>>
       lhs_eval;
     const DynamicReverseJacobianEvaluator<typename traits<Derived>::RhsDerived,
-                                          RhsAdjoint>
+                                          adjoint_arg_t<RhsAdjoint>>
       rhs_eval;
 
  public:
@@ -24,14 +24,30 @@ struct Evaluator<Derived &&> {
                   "Internal error: Evaluator must be instantiated with clean type");
 };
 
-/** Specialization for leaf expression */
+/** Specialization for leaf expression
+ *
+ * If the leaf is held by reference, and evaluates to a reference (to itself or, for a
+ * Framed leaf, the wrapped leaf), the result refers to it instead of copying it. Views
+ * built on the result, such as the transposed matrix from Inverse, then read the
+ * user's leaf directly.
+ */
 template <typename Derived>
 struct Evaluator<Derived, enable_if_leaf_t<Derived>> {
     EIGEN_MAKE_ALIGNED_OPERATOR_NEW
     using EvalType = eval_t<Derived>;
 
+ private:
+    using ImplResult = decltype(
+      evalImpl(get_expr_tag_t<Derived>(), std::declval<const eval_storage_t<Derived> &>()));
+    using ResultType =
+      std::conditional_t<std::is_reference<eval_storage_t<Derived>>{} &&
+                           std::is_lvalue_reference<ImplResult>{},
+                         const EvalType &,
+                         const EvalType>;
+
+ public:
     WAVE_STRONG_INLINE explicit Evaluator(const Derived &expr)
-        : expr{expr}, result{evalImpl(get_expr_tag_t<Derived>(), expr)} {}
+        : expr{expr}, result{evalImpl(get_expr_tag_t<Derived>(), this->expr)} {}
 
     const EvalType &operator()() const {
         return this->result;
@@ -39,7 +55,7 @@ struct Evaluator<Derived, enable_if_leaf_t<Derived>> {
 
  public:
     const eval_storage_t<Derived> expr;
-    const EvalType result;
+    ResultType result;
 };
 
 /** Specialization for scalar type */
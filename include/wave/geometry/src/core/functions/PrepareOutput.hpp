@@ -87,9 +87,22 @@ decltype(auto) prepareOutput(const Evaluator<Derived> &evaluator) {
     return prepareLeafForOutput<Derived>(evaluator());
 };
 
+/** Checks whether an expression has a cheaper equivalent for evaluating only its value
+ *
+ * Such an expression overloads `rewriteForValue(adl, const Derived &)`, returning an
+ * expression which refers to the operands of the original. Jacobians are still taken
+ * through the original expression.
+ */
+TICK_TRAIT(has_value_rewrite) {
+    template <class T>
+    auto require(const T &x)->valid<decltype(rewriteForValue(adl{}, x))>;
+};
+
 /** Evaluates an expression tree into the given type
  */
-template <typename Destination, typename Derived>
+template <typename Destination,
+          typename Derived,
+          std::enable_if_t<!has_value_rewrite<tmp::remove_cr_t<Derived>>{}, int> = 0>
 auto evaluateTo(Derived &&expr) -> Destination {
     // Construct Evaluator tree
     const auto &evaluator = prepareEvaluatorTo<Destination>(std::forward<Derived>(expr));
@@ -98,6 +111,16 @@ auto evaluateTo(Derived &&expr) -> Destination {
     return prepareOutput(evaluator);
 }
 
+/** Evaluates an expression tree into the given type, through its rewriteForValue() */
+template <typename Destination,
+          typename Derived,
+          std::enable_if_t<has_value_rewrite<tmp::remove_cr_t<Derived>>{}, int> = 0>
+auto evaluateTo(Derived &&expr) -> Destination {
+    // The rewritten expression refers to expr, which outlives it
+    const auto &rewritten = rewriteForValue(adl{}, expr);
+    return evaluateTo<Destination>(rewritten);
+}
+
 }  // namespace internal
 
 
@@ -20,6 +20,39 @@ struct ReverseJacobianEvaluator;
 template <typename T>
 using eigen_plain_t = typename tmp::remove_cr_t<T>::PlainObject;
 
+/** Chooses the type of an adjoint propagated by reverse-mode evaluators.
+ *
+ * The product of an adjoint and a local Jacobian stays symbolic when either is an
+ * identity, negative identity, or identity block (e.g. multiplying by IdentityMatrix
+ * gives back the other operand), so trivial steps cost nothing. A dense Eigen::Product
+ * is evaluated once here, instead of each time the adjoint is used by a child.
+ */
+template <typename T>
+struct adjoint_selector {
+    using type = T;
+};
+
+template <typename Lhs, typename Rhs, int Option>
+struct adjoint_selector<const Eigen::Product<Lhs, Rhs, Option>> {
+    using type = typename Eigen::Product<Lhs, Rhs, Option>::PlainObject;
+};
+
+template <typename Lhs, typename Rhs, int Option>
+struct adjoint_selector<Eigen::Product<Lhs, Rhs, Option>> {
+    using type = typename Eigen::Product<Lhs, Rhs, Option>::PlainObject;
+};
+
+template <typename Adjoint, typename SelfJacobian>
+using adjoint_product_t = typename adjoint_selector<decltype(
+  std::declval<Adjoint>() * std::declval<SelfJacobian>())>::type;
+
+/** The Adjoint parameter of a child evaluator, given the type cached by its parent.
+ *
+ * The child refers to a cached plain matrix instead of copying it.
+ */
+template <typename T>
+using adjoint_arg_t = std::add_lvalue_reference_t<std::add_const_t<T>>;
+
 /** Specialization for leaf expression */
 template <typename Derived, typename Adjoint>
 struct ReverseJacobianEvaluator<Derived, Adjoint, enable_if_leaf_or_scalar_t<Derived>> {
@@ -48,7 +81,7 @@ struct ReverseJacobianEvaluator<Derived, Adjoint, enable_if_unary_t<Derived>> {
       jacobianImpl(get_expr_tag_t<Derived>{},
                    std::declval<eval_t<Derived>>(),
                    std::declval<eval_t<typename traits<Derived>::RhsDerived>>()));
-    using RhsAdjoint = decltype(std::declval<Adjoint>() * std::declval<SelfJacobian>());
+    using RhsAdjoint = adjoint_product_t<Adjoint, SelfJacobian>;
 
 
  private:
@@ -61,7 +94,8 @@ struct ReverseJacobianEvaluator<Derived, Adjoint, enable_if_unary_t<Derived>> {
     jac_ref_sel_t<RhsAdjoint> rhs_adjoint;
 
     // Nested jacobian-evaluators
-    const ReverseJacobianEvaluator<typename traits<Derived>::RhsDerived, RhsAdjoint>
+    const ReverseJacobianEvaluator<typename traits<Derived>::RhsDerived,
+                                   adjoint_arg_t<RhsAdjoint>>
       rhs_eval;
 
 
@@ -95,10 +129,8 @@ struct ReverseJacobianEvaluator<Derived, Adjoint, enable_if_binary_t<Derived>> {
                         std::declval<eval_t<Derived>>(),
                         std::declval<eval_t<typename traits<Derived>::LhsDerived>>(),
                         std::declval<eval_t<typename traits<Derived>::RhsDerived>>()));
-    using LhsAdjoint =
-      decltype(std::declval<Adjoint>() * std::declval<LhsSelfJacobian>());
-    using RhsAdjoint =
-      decltype(std::declval<Adjoint>() * std::declval<RhsSelfJacobian>());
+    using LhsAdjoint = adjoint_product_t<Adjoint, LhsSelfJacobian>;
+    using RhsAdjoint = adjoint_product_t<Adjoint, RhsSelfJacobian>;
 
 
  private:
@@ -113,9 +145,11 @@ struct ReverseJacobianEvaluator<Derived, Adjoint, enable_if_binary_t<Derived>> {
     jac_ref_sel_t<RhsAdjoint> rhs_adjoint;
 
     // Nested jacobian-evaluators
-    const ReverseJacobianEvaluator<typename traits<Derived>::LhsDerived, LhsAdjoint>
+    const ReverseJacobianEvaluator<typename traits<Derived>::LhsDerived,
+                                   adjoint_arg_t<LhsAdjoint>>
       lhs_eval;
-    const ReverseJacobianEvaluator<typename traits<Derived>::RhsDerived, RhsAdjoint>
+    const ReverseJacobianEvaluator<typename traits<Derived>::RhsDerived,
+                                   adjoint_arg_t<RhsAdjoint>>
       rhs_eval;
 
  public:
@@ -126,8 +126,7 @@ auto evalImpl(expr<MemberAccess, Aux>, Rhs &&rhs) {
 }
 
 template <typename Aux, typename Res, typename Rhs>
-auto jacobianImpl(expr<MemberAccess, Aux>, const Res &res, const Rhs &rhs)
-  -> BlockMatrix<Res, Rhs> {
+auto jacobianImpl(expr<MemberAccess, Aux>, const Res &res, const Rhs &rhs) {
     return Aux{}.jacobian(res, rhs);
 }
 
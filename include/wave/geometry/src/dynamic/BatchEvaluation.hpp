@@ -0,0 +1,304 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_BATCHEVALUATION_HPP
+#define WAVE_GEOMETRY_BATCHEVALUATION_HPP
+
+namespace wave {
+namespace internal {
+
+/** Evaluation of many existing dynamic graphs of the same shape at once
+ *
+ * The graphs, or instances, share one DynamicStructure. In the forward pass, instead of
+ * evaluating each graph in turn, each node position is visited for all instances before
+ * the next. Consecutive calls then go to the same node type, with the same code and
+ * similar data. Every result is stored, and a node shared by several instances, such as
+ * a pose seen by many factors, is evaluated once. Each node is still a separate object
+ * with its own virtual calls; to evaluate one graph over arrays of leaf values, see
+ * BatchKernel.
+ *
+ * In the reverse pass, the adjoint of each root is propagated recursively, with
+ * fixed-size adjoints, using the stored results.
+ *
+ * The graphs are found once, on construction, and a BatchSweep may be run many times.
+ * Finding the graphs costs more than the batch saves in one evaluation, so a BatchSweep
+ * is only worthwhile when it is kept and evaluated again, e.g. once per iteration of a
+ * solver.
+ *
+ * @tparam Leaf The leaf type of the roots
+ */
+template <typename Leaf>
+class BatchSweep {
+    using Scalar = scalar_t<Leaf>;
+    using Node = DynamicNode<Scalar>;
+    using JacobianMap = DynamicReverseResult<Scalar>;
+    using Result = std::pair<Leaf, JacobianMap>;
+
+ public:
+    using Results = std::vector<Leaf, Eigen::aligned_allocator<Leaf>>;
+    using ResultsWithJacobians = std::vector<Result, Eigen::aligned_allocator<Result>>;
+
+    /** Prepares to evaluate the given proxies, whose graphs must all have one shape
+     *
+     * @throws std::invalid_argument if the graphs have different shapes
+     */
+    BatchSweep(const std::vector<Proxy<Leaf>> &proxies, DynamicStructureCache &structures)
+        : proxies{proxies} {
+        auto graphs = std::vector<DynamicGraph<Scalar>>{};
+        graphs.reserve(proxies.size());
+        for (const auto &proxy : proxies) {
+            graphs.emplace_back(proxy.follow(), &structures);
+            if (graphs.back().structure != graphs.front().structure) {
+                throw std::invalid_argument{
+                  "Batched graphs must all have the same shape"};
+            }
+        }
+
+        // Each node comes after its children, which are at earlier positions
+        const auto n = graphs.empty() ? 0 : graphs.front().nodes.size();
+        auto seen = std::unordered_set<const Node *>{};
+        for (std::size_t i = 0; i < n; ++i) {
+            for (const auto &graph : graphs) {
+                const auto *node = graph.nodes[i].node;
+                if (seen.insert(node).second) {
+                    this->order.push_back(node);
+                    this->context.reserve(node);
+                }
+            }
+        }
+        this->context.sweep = &this->sweep;
+    }
+
+    /** Returns the result of each instance */
+    Results evaluate() {
+        const ScopedDynamicContext<Scalar> scope{this->context};
+        this->forward();
+        auto results = Results{};
+        results.reserve(this->proxies.size());
+        for (const auto &proxy : this->proxies) {
+            // The root's result is stored, so the Evaluator does not recompute it
+            results.push_back(prepareOutput(Evaluator<Proxy<Leaf>>{proxy}));
+        }
+        this->release();
+        return results;
+    }
+
+    /** Returns the result and map of leaf Jacobians of each instance */
+    ResultsWithJacobians evaluateWithReverseJacobians() {
+        const ScopedDynamicContext<Scalar> scope{this->context};
+        this->forward();
+        auto results = ResultsWithJacobians{};
+        results.reserve(this->proxies.size());
+        for (const auto &proxy : this->proxies) {
+            const auto v_eval = Evaluator<Proxy<Leaf>>{proxy};
+            // Without a sweep, the Jacobian evaluators recurse into the stored results
+            this->context.sweep = nullptr;
+            results.emplace_back(prepareOutput(v_eval),
+                                 evaluateDynamicReverseJacobians(v_eval));
+            this->context.sweep = &this->sweep;
+        }
+        this->release();
+        return results;
+    }
+
+    /** Returns the number of distinct nodes in all graphs */
+    std::size_t numNodes() const noexcept {
+        return this->order.size();
+    }
+
+ private:
+    void forward() {
+        for (const auto *node : this->order) {
+            node->dynStore();
+        }
+    }
+
+    void release() {
+        for (const auto *node : this->order) {
+            node->dynRelease();
+        }
+    }
+
+    std::vector<Proxy<Leaf>> proxies;
+    std::vector<const Node *> order;  // distinct nodes, by position then instance
+    DynamicSweep<Scalar> sweep;
+    DynamicContext<Scalar> context;  // holds the stored results
+};
+
+/** Evaluation of one dynamic graph over many instances, given arrays of their values
+ *
+ * A prototype graph gives the structure, and the expression of each node. Instances
+ * differ from it only in the values of some of its leaves, or of some nodes, which are
+ * bound to arrays with one value per instance. Leaves and nodes not bound keep the
+ * value they have in the prototype, for all instances.
+ *
+ * The graph is visited one node at a time, and each node is evaluated for all instances
+ * in a tight loop over contiguous arrays: its inputs are read from the bound arrays and
+ * from the arrays of results its children stored, with no virtual calls inside the loop.
+ * The reverse pass likewise visits each node once, keeping the adjoints of all instances
+ * of a node side by side in one matrix.
+ *
+ * Leaves are matched by address, so the prototype must refer to the leaves that are
+ * bound (e.g. built from lvalues), and the arrays must outlive each evaluation.
+ *
+ *     const auto x = RotationMd{}; const auto p = Translationd{};
+ *     auto kernel = BatchKernel<Translationd>{Proxy<Translationd>{x * p}};
+ *     kernel.bind(x, xs.data());
+ *     kernel.bind(p, ps.data());
+ *     const auto results = kernel.evaluateWithReverseJacobians(xs.size());
+ *     const auto J_x = kernel.jacobian(x, k);  // of result k with respect to xs[k]
+ *
+ * @tparam Leaf The leaf type of the root
+ */
+template <typename Leaf>
+class BatchKernel {
+    using Scalar = scalar_t<Leaf>;
+    using Node = DynamicNode<Scalar>;
+    enum : int { TangentSize = traits<Leaf>::TangentSize };
+
+ public:
+    using Results = std::vector<Leaf, Eigen::aligned_allocator<Leaf>>;
+
+    /** Prepares to evaluate instances of the prototype graph
+     *
+     * @param structures if given, interns the structure of the graph
+     */
+    explicit BatchKernel(const Proxy<Leaf> &prototype,
+                         DynamicStructureCache *structures = nullptr)
+        : prototype{prototype}, graph{prototype.follow(), structures} {
+        // Within a sweep, each node gives only its own leaves
+        auto sweep = DynamicSweep<Scalar>{};
+        auto context = DynamicContext<Scalar>{};
+        context.sweep = &sweep;
+        const ScopedDynamicContext<Scalar> scope{context};
+        auto leaves = DynamicLeavesVec{};
+        for (const auto &info : this->graph.nodes) {
+            info.node->dynLeaves(leaves);
+            this->keys.insert(info.node);
+        }
+        for (const auto &leaf : leaves) {
+            this->keys.insert(leaf.first);
+        }
+    }
+
+    /** Returns the structure of the graph */
+    const DynamicStructure &structure() const noexcept {
+        return *this->graph.structure;
+    }
+
+    /** Gives a leaf of the prototype the value values[k] in instance k
+     *
+     * @throws std::invalid_argument if the leaf is not in the graph
+     */
+    template <typename T, enable_if_leaf_or_scalar_t<T, int> = 0>
+    void bind(const T &leaf, const T *values) {
+        this->bindKey(&leaf, typeid(T), values);
+    }
+
+    /** Gives a node of the prototype the value values[k] in instance k, in place of the
+     * result of its expression
+     *
+     * @throws std::invalid_argument if the node is not in the graph
+     */
+    template <typename T>
+    void bind(const Proxy<T> &node, const T *values) {
+        static_assert(std::is_same<eval_t<T>, T>{}, "Nodes are bound to their results");
+        this->bindKey(static_cast<const Node *>(&node.follow()), typeid(T), values);
+    }
+
+    /** Returns the result of each of `count` instances
+     *
+     * @throws std::invalid_argument if an array of the wrong type was bound
+     */
+    Results evaluate(std::size_t count) {
+        this->forward(count);
+        return this->results();
+    }
+
+    /** Returns the result of each of `count` instances, and keeps their Jacobians with
+     * respect to each bound leaf and node
+     *
+     * @see jacobian()
+     * @throws std::invalid_argument if an array of the wrong type was bound
+     */
+    Results evaluateWithReverseJacobians(std::size_t count) {
+        this->forward(count);
+        this->batch.startReverse(this->root(), TangentSize);
+        for (auto it = this->graph.nodes.rbegin(); it != this->graph.nodes.rend(); ++it) {
+            if (!this->batch.isBound(it->node)) {
+                it->node->dynBatchReverse(this->batch);
+            }
+        }
+        return this->results();
+    }
+
+    /** Returns the Jacobian of the result of instance k with respect to its value of a
+     * bound leaf, from the last evaluateWithReverseJacobians()
+     */
+    template <typename T, enable_if_leaf_or_scalar_t<T, int> = 0>
+    jacobian_t<Leaf, T> jacobian(const T &leaf, std::size_t k) const {
+        return this->jacobianOf<T>(&leaf, k);
+    }
+
+    /** Returns the Jacobian of the result of instance k with respect to its value of a
+     * bound node, from the last evaluateWithReverseJacobians()
+     */
+    template <typename T>
+    jacobian_t<Leaf, T> jacobian(const Proxy<T> &node, std::size_t k) const {
+        return this->jacobianOf<T>(static_cast<const Node *>(&node.follow()), k);
+    }
+
+ private:
+    void bindKey(const void *key, std::type_index type, const void *values) {
+        if (!this->keys.count(key)) {
+            throw std::invalid_argument{"Bound leaf or node is not in the graph"};
+        }
+        this->batch.bind(key, type, values);
+    }
+
+    const Node *root() const {
+        return this->graph.nodes.back().node;
+    }
+
+    void forward(std::size_t count) {
+        this->batch.reset(count);
+        for (const auto &info : this->graph.nodes) {
+            if (!this->batch.isBound(info.node)) {
+                info.node->dynBatchEvaluate(this->batch);
+            }
+        }
+    }
+
+    Results results() const {
+        const auto input = this->batch.results(this->root());
+        const auto *values = static_cast<const eval_t<Leaf> *>(input.values);
+        auto res = Results{};
+        res.reserve(this->batch.size());
+        for (std::size_t k = 0; k < this->batch.size(); ++k) {
+            res.emplace_back(values[k * input.stride]);
+        }
+        return res;
+    }
+
+    template <typename T>
+    jacobian_t<Leaf, T> jacobianOf(const void *key, std::size_t k) const {
+        enum : int { Size = traits<T>::TangentSize };
+        const auto *adjoints = this->batch.adjoints(key);
+        if (!adjoints) {
+            return jacobian_t<Leaf, T>::Zero();
+        }
+        return adjoints->template block<TangentSize, Size>(
+          0, static_cast<Eigen::Index>(k) * Size);
+    }
+
+    Proxy<Leaf> prototype;  // owns the graph
+    DynamicGraph<Scalar> graph;
+    std::unordered_set<const void *> keys;  // of the leaves and nodes in the graph
+    DynamicBatch<Scalar> batch;
+};
+
+}  // namespace internal
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_BATCHEVALUATION_HPP
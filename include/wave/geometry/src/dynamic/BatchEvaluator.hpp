@@ -0,0 +1,448 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_BATCHEVALUATOR_HPP
+#define WAVE_GEOMETRY_BATCHEVALUATOR_HPP
+
+namespace wave {
+namespace internal {
+
+/** A leaf or node read by an expression evaluated in a DynamicBatch
+ *
+ * For instance k, its value is element k * stride of `values`, an array of its type. If
+ * `adjoints` is not null, the adjoint of instance k is added to its columns
+ * [k * n, (k + 1) * n), for tangent size n.
+ */
+template <typename Scalar>
+struct DynamicBatchInput {
+    const void *values;
+    std::size_t stride;
+    DynamicMatrix<Scalar> *adjoints;
+};
+
+/** State of the evaluation of one graph over many instances
+ *
+ * Every instance has the nodes and leaves of one graph, except that chosen leaves or
+ * nodes are bound to arrays holding their value for each instance. Each node is
+ * evaluated for all instances in turn (see DynamicNode::dynBatchEvaluate()), and stores
+ * the array of its results here, which its parents read.
+ *
+ * In the reverse pass, the adjoints of all instances of a node or bound leaf are kept
+ * side by side in one matrix, and the adjoints of a bound leaf are the Jacobians of the
+ * root with respect to it.
+ */
+template <typename Scalar>
+class DynamicBatch {
+ public:
+    using Input = DynamicBatchInput<Scalar>;
+    using Matrix = DynamicMatrix<Scalar>;
+
+    /** Starts a batch of `count` instances, discarding the results of the last one */
+    void reset(std::size_t count) {
+        this->count = count;
+        this->num_rows = 0;
+        this->outputs.clear();
+        this->adjoint_map.clear();
+    }
+
+    /** Returns the number of instances */
+    std::size_t size() const noexcept {
+        return this->count;
+    }
+
+    /** Binds a leaf or node, whose value has the given type, to an array of values */
+    void bind(const void *key, std::type_index type, const void *values) {
+        this->bound.erase(key);
+        this->bound.emplace(key, std::make_pair(type, values));
+    }
+
+    /** Returns true if the leaf or node is bound to an array of values */
+    bool isBound(const void *key) const {
+        return this->bound.count(key) > 0;
+    }
+
+    /** Returns the input for a leaf: its bound array, or else the leaf for every instance
+     *
+     * @throws std::invalid_argument if the leaf is bound to an array of another type
+     */
+    template <typename T>
+    Input leaf(const T &leaf) {
+        const auto *values = this->boundValues(&leaf, typeid(T));
+        if (!values) {
+            return {&leaf, 0, nullptr};
+        }
+        return {values, 1, this->adjointsFor(&leaf, traits<T>::TangentSize)};
+    }
+
+    /** Returns the input for a node with results of type T: its bound array, or else
+     * the results it stored
+     *
+     * A node whose results are the same for all instances has no adjoints.
+     *
+     * @throws std::invalid_argument if the node is bound to an array of another type
+     */
+    template <typename T>
+    Input node(const DynamicNode<Scalar> *node) {
+        auto input = this->results(node);
+        if (const auto *values = this->boundValues(node, typeid(T))) {
+            input.values = values;
+        }
+        if (input.stride != 0) {
+            input.adjoints = this->adjointsFor(node, traits<T>::TangentSize);
+        }
+        return input;
+    }
+
+    /** Makes the array of results of a node, of type T, and returns its first element
+     *
+     * @param varying false if the node has the same result in every instance, which is
+     * then stored once
+     */
+    template <typename T>
+    T *emplaceResults(const DynamicNode<Scalar> *node, bool varying = true) {
+        using Array = std::vector<T, Eigen::aligned_allocator<T>>;
+        auto state =
+          std::make_unique<DynamicNodeStateHolder<Array>>(varying ? this->count : 1);
+        auto *data = state->value.data();
+        this->outputs[node] = Output{std::move(state), data, varying ? 1u : 0u};
+        return data;
+    }
+
+    /** Returns the results of a node as an input without adjoints: its bound array, or
+     * else the results it stored
+     */
+    Input results(const DynamicNode<Scalar> *node) const {
+        const auto it = this->bound.find(node);
+        if (it != this->bound.end()) {
+            return {it->second.second, 1, nullptr};
+        }
+        const auto out = this->outputs.find(node);
+        assert(out != this->outputs.end() && "Children must be evaluated first");
+        return {out->second.values, out->second.stride, nullptr};
+    }
+
+    /** Starts the reverse pass from a root of the given tangent size, setting its
+     * adjoint to the identity for every instance
+     */
+    void startReverse(const DynamicNode<Scalar> *root, int size) {
+        this->num_rows = size;
+        this->adjoint_map.clear();
+        const auto count = static_cast<Eigen::Index>(this->count);
+        this->adjoint_map[root] = Matrix::Identity(size, size).replicate(1, count);
+    }
+
+    /** Returns the number of rows of every adjoint, or 0 outside the reverse pass */
+    int rows() const noexcept {
+        return this->num_rows;
+    }
+
+    /** Returns the adjoints accumulated for a leaf or node, or null if there are none */
+    const Matrix *adjoints(const void *key) const {
+        const auto it = this->adjoint_map.find(key);
+        return it == this->adjoint_map.end() ? nullptr : &it->second;
+    }
+
+ private:
+    const void *boundValues(const void *key, std::type_index type) const {
+        const auto it = this->bound.find(key);
+        if (it == this->bound.end()) {
+            return nullptr;
+        }
+        if (it->second.first != type) {
+            throw std::invalid_argument{"Bound array has the wrong type"};
+        }
+        return it->second.second;
+    }
+
+    /** During the reverse pass, returns the adjoints of a leaf or node, set to zero if
+     * new; otherwise returns null
+     */
+    Matrix *adjointsFor(const void *key, int size) {
+        if (this->num_rows == 0) {
+            return nullptr;
+        }
+        auto &m = this->adjoint_map[key];
+        if (m.size() == 0) {
+            m.setZero(this->num_rows, size * static_cast<Eigen::Index>(this->count));
+        }
+        return &m;
+    }
+
+    struct Output {
+        std::unique_ptr<DynamicNodeState> state;
+        const void *values;
+        std::size_t stride;
+    };
+
+    std::size_t count = 0;
+    int num_rows = 0;
+    std::unordered_map<const void *, std::pair<std::type_index, const void *>> bound;
+    std::unordered_map<const DynamicNode<Scalar> *, Output> outputs;
+    std::unordered_map<const void *, Matrix> adjoint_map;
+};
+
+/** getBatchInputs() functions build up the inputs of an expression, in the order its
+ * BatchEvaluator reads them
+ */
+template <typename Scalar, typename Derived, enable_if_leaf_or_scalar_t<Derived, int> = 0>
+void getBatchInputs(adl,
+                    DynamicBatch<Scalar> &batch,
+                    std::vector<DynamicBatchInput<Scalar>> &inputs,
+                    const Derived &leaf) {
+    inputs.push_back(batch.leaf(leaf));
+}
+
+template <typename Scalar, typename Derived, enable_if_unary_t<Derived, int> = 0>
+void getBatchInputs(adl,
+                    DynamicBatch<Scalar> &batch,
+                    std::vector<DynamicBatchInput<Scalar>> &inputs,
+                    const ExpressionBase<Derived> &expr) {
+    getBatchInputs(adl{}, batch, inputs, expr.derived().rhs());
+}
+
+template <typename Scalar, typename Derived, enable_if_binary_t<Derived, int> = 0>
+void getBatchInputs(adl,
+                    DynamicBatch<Scalar> &batch,
+                    std::vector<DynamicBatchInput<Scalar>> &inputs,
+                    const ExpressionBase<Derived> &expr) {
+    getBatchInputs(adl{}, batch, inputs, expr.derived().lhs());
+    getBatchInputs(adl{}, batch, inputs, expr.derived().rhs());
+}
+
+/** Evaluates an expression for one instance of a DynamicBatch
+ *
+ * As Evaluator, except that leaves and Proxies read their value for instance k from the
+ * inputs of the expression, which they take in order from `cursor`.
+ */
+template <typename Derived, typename = void>
+struct BatchEvaluator;
+
+/** Evaluates the reverse-mode Jacobians of an expression for one instance of a
+ * DynamicBatch
+ *
+ * As DynamicReverseJacobianEvaluator, except that adjoints of leaves and Proxies are
+ * added to their inputs.
+ */
+template <typename Derived, typename Adjoint, typename = void>
+struct BatchReverseEvaluator;
+
+/** Adds the adjoint of instance k to an input, if it keeps adjoints */
+template <int TangentSize, typename Scalar, typename Adjoint>
+void accumulateBatchAdjoint(const DynamicBatchInput<Scalar> &input,
+                            const Adjoint &adjoint,
+                            std::size_t k) {
+    if (input.adjoints) {
+        constexpr int Rows = tmp::remove_cr_t<Adjoint>::RowsAtCompileTime;
+        auto &m = *input.adjoints;
+        const auto col = static_cast<Eigen::Index>(k) * TangentSize;
+        Eigen::Block<DynamicMatrix<Scalar>, Rows, TangentSize>{
+          m, 0, col, m.rows(), TangentSize} += adjoint;
+    }
+}
+
+/** Specialization for leaf expression */
+template <typename Derived>
+struct BatchEvaluator<Derived, enable_if_leaf_t<Derived>> {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    using EvalType = eval_t<Derived>;
+    using Input = DynamicBatchInput<scalar_t<Derived>>;
+
+ private:
+    using ImplResult =
+      decltype(evalImpl(get_expr_tag_t<Derived>(), std::declval<const Derived &>()));
+    using ResultType = std::conditional_t<std::is_lvalue_reference<ImplResult>{},
+                                          const EvalType &,
+                                          const EvalType>;
+
+ public:
+    WAVE_STRONG_INLINE BatchEvaluator(const Derived &,
+                                      const Input *&cursor,
+                                      std::size_t k)
+        : input{*cursor++},
+          expr{static_cast<const Derived *>(this->input.values)[k * this->input.stride]},
+          result{evalImpl(get_expr_tag_t<Derived>(), this->expr)} {}
+
+    const EvalType &operator()() const {
+        return this->result;
+    }
+
+ public:
+    const Input &input;
+    const Derived &expr;
+    ResultType result;
+};
+
+/** Specialization for scalar type */
+template <typename Derived>
+struct BatchEvaluator<Derived, enable_if_scalar_t<Derived>> {
+    using EvalType = Derived;
+    using Input = DynamicBatchInput<Derived>;
+
+    WAVE_STRONG_INLINE BatchEvaluator(const Derived &,
+                                      const Input *&cursor,
+                                      std::size_t k)
+        : input{*cursor++},
+          expr{static_cast<const Derived *>(this->input.values)[k * input.stride]} {}
+
+    const EvalType &operator()() const {
+        return this->expr;
+    }
+
+ public:
+    const Input &input;
+    const Derived &expr;
+};
+
+/** Specialization for unary expression */
+template <typename Derived>
+struct BatchEvaluator<Derived, enable_if_unary_t<Derived>> {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    using EvalType = eval_t<Derived>;
+    using RhsEval = BatchEvaluator<typename traits<Derived>::RhsDerived>;
+    using Input = DynamicBatchInput<scalar_t<Derived>>;
+
+    WAVE_STRONG_INLINE BatchEvaluator(const Derived &expr,
+                                      const Input *&cursor,
+                                      std::size_t k)
+        : rhs_eval{expr.rhs(), cursor, k},
+          result{evalImpl(get_expr_tag_t<Derived>(), this->rhs_eval())} {}
+
+    const EvalType &operator()() const {
+        return this->result;
+    }
+
+ public:
+    const RhsEval rhs_eval;
+    const EvalType result;
+};
+
+/** Specialization for a binary expression */
+template <typename Derived>
+struct BatchEvaluator<Derived, enable_if_binary_t<Derived>> {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    using EvalType = eval_t<Derived>;
+    using LhsEval = BatchEvaluator<typename traits<Derived>::LhsDerived>;
+    using RhsEval = BatchEvaluator<typename traits<Derived>::RhsDerived>;
+    using Input = DynamicBatchInput<scalar_t<Derived>>;
+
+    WAVE_STRONG_INLINE BatchEvaluator(const Derived &expr,
+                                      const Input *&cursor,
+                                      std::size_t k)
+        : lhs_eval{expr.lhs(), cursor, k},
+          rhs_eval{expr.rhs(), cursor, k},
+          result{
+            evalImpl(get_expr_tag_t<Derived>(), this->lhs_eval(), this->rhs_eval())} {}
+
+    const EvalType &operator()() const {
+        return this->result;
+    }
+
+ public:
+    const LhsEval lhs_eval;
+    const RhsEval rhs_eval;
+    const EvalType result;
+};
+
+/** Specialization for leaf expression */
+template <typename Derived, typename Adjoint>
+struct BatchReverseEvaluator<Derived, Adjoint, enable_if_leaf_or_scalar_t<Derived>> {
+    WAVE_STRONG_INLINE BatchReverseEvaluator(const BatchEvaluator<Derived> &evaluator,
+                                             const Adjoint &adjoint,
+                                             std::size_t k) {
+        accumulateBatchAdjoint<traits<Derived>::TangentSize>(evaluator.input, adjoint, k);
+    }
+};
+
+/** Specialization for unary expression */
+template <typename Derived, typename Adjoint>
+struct BatchReverseEvaluator<Derived, Adjoint, enable_if_unary_t<Derived>> {
+ private:
+    using SelfJacobian = decltype(
+      jacobianImpl(get_expr_tag_t<Derived>{},
+                   std::declval<eval_t<Derived>>(),
+                   std::declval<eval_t<typename traits<Derived>::RhsDerived>>()));
+    using RhsAdjoint = adjoint_product_t<Adjoint, SelfJacobian>;
+
+    const BatchEvaluator<Derived> &evaluator;
+
+    // Results cache
+    jac_ref_sel_t<SelfJacobian> self_jac;
+    jac_ref_sel_t<Adjoint> adjoint;
+    jac_ref_sel_t<RhsAdjoint> rhs_adjoint;
+
+    // Nested jacobian-evaluators
+    const BatchReverseEvaluator<typename traits<Derived>::RhsDerived,
+                                adjoint_arg_t<RhsAdjoint>>
+      rhs_eval;
+
+ public:
+    WAVE_STRONG_INLINE BatchReverseEvaluator(const BatchEvaluator<Derived> &evaluator,
+                                             const Adjoint &adjoint_in,
+                                             std::size_t k)
+        : evaluator{evaluator},
+          self_jac{jacobianImpl(
+            get_expr_tag_t<Derived>{}, this->evaluator(), this->evaluator.rhs_eval())},
+          adjoint{adjoint_in},
+          rhs_adjoint{adjoint * self_jac},
+          rhs_eval{evaluator.rhs_eval, rhs_adjoint, k} {}
+};
+
+/** Specialization for a binary expression */
+template <typename Derived, typename Adjoint>
+struct BatchReverseEvaluator<Derived, Adjoint, enable_if_binary_t<Derived>> {
+ private:
+    using LhsSelfJacobian = decltype(
+      leftJacobianImpl(get_expr_tag_t<Derived>{},
+                       std::declval<eval_t<Derived>>(),
+                       std::declval<eval_t<typename traits<Derived>::LhsDerived>>(),
+                       std::declval<eval_t<typename traits<Derived>::RhsDerived>>()));
+    using RhsSelfJacobian = decltype(
+      rightJacobianImpl(get_expr_tag_t<Derived>{},
+                        std::declval<eval_t<Derived>>(),
+                        std::declval<eval_t<typename traits<Derived>::LhsDerived>>(),
+                        std::declval<eval_t<typename traits<Derived>::RhsDerived>>()));
+    using LhsAdjoint = adjoint_product_t<Adjoint, LhsSelfJacobian>;
+    using RhsAdjoint = adjoint_product_t<Adjoint, RhsSelfJacobian>;
+
+    const BatchEvaluator<Derived> &evaluator;
+
+    // Results cache
+    jac_ref_sel_t<LhsSelfJacobian> lhs_jac;
+    jac_ref_sel_t<RhsSelfJacobian> rhs_jac;
+    jac_ref_sel_t<Adjoint> adjoint;
+    jac_ref_sel_t<LhsAdjoint> lhs_adjoint;
+    jac_ref_sel_t<RhsAdjoint> rhs_adjoint;
+
+    // Nested jacobian-evaluators
+    const BatchReverseEvaluator<typename traits<Derived>::LhsDerived,
+                                adjoint_arg_t<LhsAdjoint>>
+      lhs_eval;
+    const BatchReverseEvaluator<typename traits<Derived>::RhsDerived,
+                                adjoint_arg_t<RhsAdjoint>>
+      rhs_eval;
+
+ public:
+    WAVE_STRONG_INLINE BatchReverseEvaluator(const BatchEvaluator<Derived> &evaluator,
+                                             const Adjoint &adjoint_in,
+                                             std::size_t k)
+        : evaluator{evaluator},
+          lhs_jac{leftJacobianImpl(get_expr_tag_t<Derived>{},
+                                   this->evaluator(),
+                                   this->evaluator.lhs_eval(),
+                                   this->evaluator.rhs_eval())},
+          rhs_jac{rightJacobianImpl(get_expr_tag_t<Derived>{},
+                                    this->evaluator(),
+                                    this->evaluator.lhs_eval(),
+                                    this->evaluator.rhs_eval())},
+          adjoint{adjoint_in},
+          lhs_adjoint{adjoint * lhs_jac},
+          rhs_adjoint{adjoint * rhs_jac},
+          lhs_eval{evaluator.lhs_eval, lhs_adjoint, k},
+          rhs_eval{evaluator.rhs_eval, rhs_adjoint, k} {}
+};
+
+}  // namespace internal
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_BATCHEVALUATOR_HPP
@@ -0,0 +1,268 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_CHECKPOINTEDREVERSE_HPP
+#define WAVE_GEOMETRY_CHECKPOINTEDREVERSE_HPP
+
+namespace wave {
+namespace internal {
+
+/** Returns the smallest t such that binomial(s + t, s) >= l
+ *
+ * This is the number of times each step is evaluated by a binomial checkpointing schedule
+ * reversing l steps with s checkpoints (Griewank and Walther, "Algorithm 799: revolve").
+ */
+inline int checkpointRepetitions(std::size_t l, std::size_t s) {
+    int t = 0;
+    for (std::size_t beta = 1; beta < l; ++t) {
+        // beta(s, t + 1) = beta(s, t) * (s + t + 1) / (t + 1), computed exactly
+        beta = beta * (s + t + 1) / (t + 1);
+    }
+    return t;
+}
+
+/** Returns binomial(s + t, s), saturating at `limit` */
+inline std::size_t checkpointBeta(std::size_t s, int t, std::size_t limit) {
+    std::size_t beta = 1;
+    for (int i = 0; i < t && beta < limit; ++i) {
+        beta = beta * (s + i + 1) / (i + 1);
+    }
+    return std::min(beta, limit);
+}
+
+/** Reverse sweep over a graph of Dynamic nodes, storing a bounded number of results.
+ *
+ * The nodes of the graph are visited one at a time, without recursion, in a topological
+ * order. Nodes with no dynamic children ("sources", such as Proxies holding leaves) are
+ * never kept: they are recomputed whenever a parent needs them. If the remaining nodes
+ * form a chain, as built by repeatedly composing onto the same Proxy, at most
+ * `max_checkpoints` intermediate results are kept at once, and segments of the chain are
+ * recomputed during the reverse pass following a binomial (revolve) schedule. Otherwise,
+ * every result is kept.
+ */
+template <typename Scalar>
+class CheckpointedReverseSweep {
+    using Node = DynamicNode<Scalar>;
+    using JacobianMap = DynamicReverseResult<Scalar>;
+
+ public:
+    CheckpointedReverseSweep(const Node &root,
+                             std::size_t max_checkpoints,
+                             DynamicStructureCache *structures = nullptr)
+        : graph{root, structures}, max_checkpoints{max_checkpoints} {
+        this->findSpine();
+    }
+
+    /** Runs the forward and reverse passes, filling the map of leaf Jacobians
+     *
+     * @param on_root called with the root node while its result is stored
+     */
+    template <typename RootCallback>
+    auto run(const RootCallback &on_root) -> JacobianMap {
+        this->context.sweep = &this->sweep;
+        const ScopedDynamicContext<Scalar> scope{this->context};
+        const auto &root = this->nodes().back();
+        auto jac_map = this->graph.makeJacobianMap();
+
+        // Discard results left over from earlier evaluations
+        this->remaining_parents.clear();
+        for (const auto &info : this->nodes()) {
+            info.node->dynRelease();
+            this->remaining_parents.push_back(static_cast<int>(info.parents.size()));
+        }
+
+        this->on_root = [&on_root](const Node &node) { on_root(node); };
+        this->stored = 0;
+        this->peak_stored = 0;
+        this->sweep.clear();
+        const auto size = root.node->dynTangentSize();
+        this->sweep.accumulate(root.node, DynamicMatrix<Scalar>::Identity(size, size));
+
+        const auto n = static_cast<int>(this->spine.size());
+        if (this->is_chain) {
+            this->revolve(jac_map, 0, n, this->max_checkpoints);
+        } else {
+            for (int i = 0; i < n; ++i) {
+                this->compute(i);
+            }
+            for (int i = n - 1; i >= 0; --i) {
+                this->reverseStep(jac_map, i);
+            }
+        }
+        return jac_map;
+    }
+
+    /** Returns the largest number of spine results stored at once during run() */
+    std::size_t peakStored() const noexcept {
+        return this->peak_stored;
+    }
+
+ private:
+    const std::vector<typename DynamicGraph<Scalar>::NodeInfo> &nodes() const {
+        return this->graph.nodes;
+    }
+
+    /** Finds the spine, and whether it is a chain */
+    void findSpine() {
+        // The spine is every node which is not a source, plus the root
+        const auto n = static_cast<int>(this->nodes().size());
+        for (int i = 0; i < n; ++i) {
+            if (!this->nodes()[i].children.empty() || i == n - 1) {
+                this->spine.push_back(i);
+            }
+        }
+
+        // Check whether each spine node depends only on the previous one
+        this->is_chain = true;
+        for (std::size_t k = 0; k < this->spine.size(); ++k) {
+            int spine_children = 0;
+            for (const auto c : this->nodes()[this->spine[k]].children) {
+                if (!this->nodes()[c].children.empty()) {
+                    ++spine_children;
+                    if (k == 0 || c != this->spine[k - 1]) {
+                        this->is_chain = false;
+                    }
+                }
+            }
+            if (k > 0 && spine_children != 1) {
+                this->is_chain = false;
+            }
+        }
+    }
+
+    bool isSource(int i) const {
+        const auto n = static_cast<int>(this->nodes().size());
+        return this->nodes()[i].children.empty() && i + 1 != n;
+    }
+
+    /** Stores the result of spine node k. Its spine children must be stored. */
+    void compute(int k) {
+        const auto &info = this->nodes()[this->spine[k]];
+        for (const auto c : info.children) {
+            if (this->isSource(c)) {
+                this->nodes()[c].node->dynStore();
+            }
+        }
+        info.node->dynStore();
+        for (const auto c : info.children) {
+            if (this->isSource(c)) {
+                this->nodes()[c].node->dynRelease();
+            }
+        }
+        if (k + 1 == static_cast<int>(this->spine.size())) {
+            this->on_root(*info.node);
+        }
+        ++this->stored;
+        this->peak_stored = std::max(this->peak_stored, this->stored);
+    }
+
+    void release(int k) {
+        this->nodes()[this->spine[k]].node->dynRelease();
+        --this->stored;
+    }
+
+    /** Computes spine nodes first to last, inclusive, keeping only the last */
+    void advance(int first, int last) {
+        for (int k = first; k <= last; ++k) {
+            this->compute(k);
+            if (k > first) {
+                this->release(k - 1);
+            }
+        }
+    }
+
+    /** Propagates the adjoint of stored spine node k to its leaves and children, then
+     * releases it. Sources whose parents have all been visited are reversed too. */
+    void reverseStep(JacobianMap &jac_map, int k) {
+        const auto &info = this->nodes()[this->spine[k]];
+        const auto adjoint = this->sweep.take(info.node);
+        if (adjoint.size() != 0) {
+            info.node->dynReverseDynamic(jac_map, adjoint);
+        }
+        this->release(k);
+
+        for (const auto c : info.children) {
+            if (this->isSource(c) && --this->remaining_parents[c] == 0) {
+                const auto source_adjoint = this->sweep.take(this->nodes()[c].node);
+                if (source_adjoint.size() != 0) {
+                    this->nodes()[c].node->dynStore();
+                    this->nodes()[c].node->dynReverseDynamic(jac_map, source_adjoint);
+                    this->nodes()[c].node->dynRelease();
+                }
+            }
+        }
+    }
+
+    /** Reverses spine steps [first, last) using up to s checkpoints.
+     *
+     * Requires the result of spine node first - 1 to be stored, if first > 0.
+     */
+    void revolve(JacobianMap &jac_map, int first, int last, std::size_t s) {
+        while (last - first > 1 && s > 0) {
+            // Place a checkpoint so the right part can be reversed with s - 1 checkpoints
+            // and the left part with s, each step repeating at most t times
+            const auto l = static_cast<std::size_t>(last - first);
+            const auto t = checkpointRepetitions(l, s);
+            const auto m = static_cast<int>(checkpointBeta(s, t - 1, l - 1));
+            const auto mid = first + m;
+
+            this->advance(first, mid - 1);
+            this->revolve(jac_map, mid, last, s - 1);
+            // The checkpoint is the last step of the left part
+            this->reverseStep(jac_map, mid - 1);
+            last = mid - 1;
+        }
+
+        // No checkpoints left: recompute from the start of the segment for each step
+        for (int k = last - 1; k >= first; --k) {
+            this->advance(first, k);
+            this->reverseStep(jac_map, k);
+        }
+    }
+
+    DynamicGraph<Scalar> graph;
+    std::vector<int> spine;  // indices in nodes() of non-source nodes, children-first
+    std::vector<int> remaining_parents;  // parents not yet reversed, for each node
+    bool is_chain = false;
+    std::size_t max_checkpoints;
+    std::size_t stored = 0;
+    std::size_t peak_stored = 0;
+    std::function<void(const Node &)> on_root;
+    DynamicSweep<Scalar> sweep;
+    DynamicContext<Scalar> context;  // holds the stored results
+};
+
+/** Evaluate result and all Jacobians of a dynamic expression in reverse mode, storing
+ * a bounded number of intermediate results.
+ *
+ * Unlike evaluateWithDynamicReverseJacobians(), the graph is traversed without recursion,
+ * and the adjoints of nodes shared by several parents are summed before being propagated.
+ * If the graph is a chain of Dynamic nodes, as produced by repeatedly composing onto the
+ * same Proxy, at most `max_checkpoints` intermediate results are stored at once and the
+ * rest are recomputed during the reverse pass. With `max_checkpoints` of the order of
+ * log(length), each step is evaluated only a few times.
+ *
+ * @param max_checkpoints memory budget, in number of stored node results
+ * @param structures if given, shares the graph structure with graphs of the same shape
+ * @return result and map of leaf address to Jacobians as dynamic matrices
+ */
+template <typename Derived, enable_if_proxy_t<Derived, int> = 0>
+auto evaluateWithCheckpointedReverseJacobians(const ExpressionBase<Derived> &proxy,
+                                              std::size_t max_checkpoints,
+                                              DynamicStructureCache *structures = nullptr)
+  -> std::pair<plain_output_t<Derived>, DynamicReverseResult<scalar_t<Derived>>> {
+    auto sweep = CheckpointedReverseSweep<scalar_t<Derived>>{
+      proxy.derived().follow(), max_checkpoints, structures};
+    auto result = boost::optional<plain_output_t<Derived>>{};
+    auto jac_map = sweep.run([&](const DynamicNode<scalar_t<Derived>> &) {
+        // The root's result is stored, so the Evaluator does not recompute it
+        result.emplace(prepareOutput(Evaluator<Derived>{proxy.derived()}));
+    });
+    return {std::move(*result), std::move(jac_map)};
+}
+
+}  // namespace internal
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_CHECKPOINTEDREVERSE_HPP
@@ -0,0 +1,176 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_CONSTANTFOLDING_HPP
+#define WAVE_GEOMETRY_CONSTANTFOLDING_HPP
+
+namespace wave {
+
+/** Folds the parts of dynamic graphs which depend only on constant leaves
+ *
+ * Leaves such as fixed extrinsics, calibrated intrinsics or measurements are marked
+ * constant with markConstant(). fold() then finds every Dynamic node whose leaves are all
+ * constant, and evaluates each largest such subgraph once (see DynamicNode::dynFold()).
+ * Later evaluations of the graph use the kept results, and report no Jacobians with
+ * respect to the constant leaves.
+ *
+ * A constant leaf must be changed only through update(), which re-folds the nodes using
+ * it. The folded nodes are restored by unfold() or when this object is destroyed.
+ *
+ * Folding changes the graphs, so it must not happen while they are being evaluated.
+ *
+ * @tparam Scalar The scalar type of the graphs
+ */
+template <typename Scalar>
+class ConstantFolding {
+    using Node = internal::DynamicNode<Scalar>;
+
+ public:
+    ConstantFolding() = default;
+    ConstantFolding(const ConstantFolding &) = delete;
+    ConstantFolding &operator=(const ConstantFolding &) = delete;
+
+    ~ConstantFolding() {
+        this->unfold();
+    }
+
+    /** Marks a leaf as constant, taking effect on the next fold() */
+    template <typename Derived>
+    void markConstant(const ExpressionBase<Derived> &leaf) {
+        this->constants.insert(&leaf.derived());
+    }
+
+    /** Folds the constant subgraphs of the graph of a Proxy
+     *
+     * Nodes already folded, for example in the graph of another Proxy, are kept.
+     */
+    template <typename Derived, internal::enable_if_proxy_t<Derived, int> = 0>
+    void fold(const ExpressionBase<Derived> &proxy) {
+        // Keep the graph alive for as long as its nodes may be folded
+        this->roots.emplace_back(proxy.derived().get());
+        const auto graph = internal::DynamicGraph<Scalar>{*this->roots.back()};
+        const auto deps = this->constantDependencies(graph);
+
+        // Fold constant nodes used by a non-constant node, or the root. Since children
+        // come first, the subgraph of each is evaluated using those already folded.
+        const auto n = graph.nodes.size();
+        for (std::size_t i = 0; i < n; ++i) {
+            const auto &info = graph.nodes[i];
+            if (!deps[i] || this->index.count(info.node)) {
+                continue;
+            }
+            const auto largest =
+              i == n - 1 || std::any_of(info.parents.begin(),
+                                        info.parents.end(),
+                                        [&](int p) { return !deps[p]; });
+            if (largest) {
+                info.node->dynFold();
+                this->index.emplace(info.node, this->folded.size());
+                this->folded.push_back({info.node, *deps[i]});
+            }
+        }
+    }
+
+    /** Assigns a new value to a constant leaf, and re-folds the nodes depending on it */
+    template <typename Derived, typename Value>
+    void update(ExpressionBase<Derived> &leaf, Value &&value) {
+        leaf.derived() = std::forward<Value>(value);
+        const void *ptr = &leaf.derived();
+
+        auto affected = std::vector<std::size_t>{};
+        for (std::size_t i = 0; i < this->folded.size(); ++i) {
+            const auto &leaves = this->folded[i].leaves;
+            if (std::binary_search(leaves.begin(), leaves.end(), ptr)) {
+                affected.push_back(i);
+            }
+        }
+        // Unfold all first, so no node is re-folded using a stale result
+        for (const auto i : affected) {
+            this->folded[i].node->dynUnfold();
+        }
+        for (const auto i : affected) {
+            this->folded[i].node->dynFold();
+        }
+    }
+
+    /** Restores all folded nodes */
+    void unfold() {
+        for (const auto &entry : this->folded) {
+            entry.node->dynUnfold();
+        }
+        this->folded.clear();
+        this->index.clear();
+        this->roots.clear();
+    }
+
+    /** Returns the number of folded nodes */
+    std::size_t size() const noexcept {
+        return this->folded.size();
+    }
+
+ private:
+    struct FoldedNode {
+        const Node *node;
+        std::vector<const void *> leaves;  // constant leaves used, sorted
+    };
+
+    /** For each node in the graph, the constant leaves it depends on, sorted, or none if
+     * it depends on any other leaf
+     */
+    std::vector<boost::optional<std::vector<const void *>>> constantDependencies(
+      const internal::DynamicGraph<Scalar> &graph) const {
+        auto deps =
+          std::vector<boost::optional<std::vector<const void *>>>(graph.nodes.size());
+
+        // While a sweep is active, each node lists only the leaves it holds directly
+        auto sweep = internal::DynamicSweep<Scalar>{};
+        auto context = internal::DynamicContext<Scalar>{};
+        context.sweep = &sweep;
+        const internal::ScopedDynamicContext<Scalar> scope{context};
+
+        auto own = internal::DynamicLeavesVec{};
+        for (std::size_t i = 0; i < graph.nodes.size(); ++i) {
+            const auto &info = graph.nodes[i];
+            const auto it = this->index.find(info.node);
+            if (it != this->index.end()) {
+                deps[i] = this->folded[it->second].leaves;
+                continue;
+            }
+            own.clear();
+            info.node->dynLeaves(own);
+            const auto is_constant_leaf = [&](const auto &l) {
+                return this->constants.count(l.first) > 0;
+            };
+            const auto is_constant_child = [&](int c) {
+                return static_cast<bool>(deps[c]);
+            };
+            const auto is_constant =
+              std::all_of(own.begin(), own.end(), is_constant_leaf) &&
+              std::all_of(info.children.begin(), info.children.end(), is_constant_child);
+            if (!is_constant) {
+                continue;
+            }
+            auto leaves = std::vector<const void *>{};
+            for (const auto &l : own) {
+                leaves.push_back(l.first);
+            }
+            for (const auto c : info.children) {
+                leaves.insert(leaves.end(), deps[c]->begin(), deps[c]->end());
+            }
+            std::sort(leaves.begin(), leaves.end());
+            leaves.erase(std::unique(leaves.begin(), leaves.end()), leaves.end());
+            deps[i] = std::move(leaves);
+        }
+        return deps;
+    }
+
+    std::unordered_set<const void *> constants;
+    std::vector<std::shared_ptr<const Node>> roots;
+    std::vector<FoldedNode> folded;
+    std::unordered_map<const Node *, std::size_t> index;
+};
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_CONSTANTFOLDING_HPP
@@ -11,7 +11,10 @@ namespace wave {
  *
  * Dynamic can be used with Proxy or RefProxy to build expressions at runtime.
  *
- *
+ * A Dynamic holds no evaluation state: its Evaluator is kept in the DynamicContext active
+ * on the evaluating thread. Therefore the same graph can be evaluated concurrently from
+ * several threads. The only state it holds is the result kept by dynFold(), which is
+ * constant while the graph is evaluated.
  *
  * @tparam Derived The wrapped expression type
  */
@@ -36,32 +39,98 @@ struct Dynamic final : internal::base_tmpl_t<RhsDerived, Dynamic<RhsDerived>>,
     using Storage::Storage;
 
  private:
-    decltype(auto) constructEvaluator() const {
+    using EvaluatorType = internal::Evaluator<PreparedType>;
+    using BatchEvaluatorType = internal::BatchEvaluator<PreparedType>;
+
+    /** Returns the context active on this thread, set by the outermost Proxy evaluator */
+    static internal::DynamicContext<Scalar> &context() {
+        auto *context = internal::activeContext<Scalar>();
+        assert(context && "Dynamic evaluated without a DynamicContext");
+        return *context;
+    }
+
+    const EvaluatorType &constructEvaluator() const {
         auto &&evaluable_expr = internal::prepareExpr(internal::adl{}, this->rhs());
         using ExprType = tmp::remove_cr_t<decltype(evaluable_expr)>;
         static_assert(std::is_same<ExprType, PreparedType>{}, "Internal sanity check");
-        this->lazy_evaluator.emplace(std::move(evaluable_expr));
-        return *this->lazy_evaluator;
+        return context().template emplace<EvaluatorType>(this,
+                                                         std::move(evaluable_expr));
     }
 
-    decltype(auto) evaluator() const {
-        if (!this->lazy_evaluator) {
-            this->constructEvaluator();
+    const EvaluatorType &evaluator() const {
+        const auto *v_eval = context().template find<EvaluatorType>(this);
+        if (!v_eval) {
+            return this->constructEvaluator();
         }
-        return *this->lazy_evaluator;
+        return *v_eval;
     }
 
 
     void dynLeaves(internal::DynamicLeavesVec &vec) const override {
+        if (this->folded) {
+            return;
+        }
         getLeaves(internal::adl{}, vec, this->rhs());
     }
 
+    void dynChildren(
+      std::vector<const internal::DynamicNode<Scalar> *> &vec) const override {
+        if (this->folded) {
+            return;
+        }
+        getDynamicChildren(internal::adl{}, vec, this->rhs());
+    }
+
+    void dynOwnedChildren(
+      std::vector<std::shared_ptr<const internal::DynamicNode<Scalar>>> &vec)
+      const override {
+        getDynamicChildren(internal::adl{}, vec, this->rhs());
+    }
+
+    int dynTangentSize() const override {
+        return TangentSize;
+    }
+
+    void dynStore() const override {
+        if (!this->folded) {
+            this->constructEvaluator();
+        }
+    }
+
+    void dynRelease() const override {
+        context().erase(this);
+    }
+
+    void dynFold() const override {
+        // Evaluate the whole subgraph in a fresh context, outside any sweep
+        this->folded = boost::none;
+        auto fold_context = internal::DynamicContext<Scalar>{};
+        const internal::ScopedDynamicContext<Scalar> scope{fold_context};
+        this->folded.emplace(this->constructEvaluator()());
+    }
+
+    void dynUnfold() const override {
+        this->folded = boost::none;
+    }
+
     auto dynEvaluate() const -> EvalType override {
+        if (this->folded) {
+            return *this->folded;
+        }
+        // During a sweep, the stored result is reused by all parents of this node
+        if (context().sweep) {
+            if (const auto *v_eval = context().template find<EvaluatorType>(this)) {
+                return EvalType{(*v_eval)()};
+            }
+        }
         const auto &v_eval = this->constructEvaluator();
-        return v_eval();
+        return EvalType{v_eval()};
     }
 
     auto dynJacobian(const void *target_ptr) const -> MatrixType override {
+        if (this->folded) {
+            return MatrixType{};
+        }
         // Note we don't reconstruct the evaluator here. This is OK as long as all of our
         // user-facing methods require function evaluation before derivative.
         const auto &v_eval = this->evaluator();
@@ -73,6 +142,9 @@ struct Dynamic final : internal::base_tmpl_t<RhsDerived, Dynamic<RhsDerived>>,
     inline void dynReverseImpl(
       MatrixMap<const void *, Scalar> &jac_map,
       const Eigen::MatrixBase<MatrixDerived> &init_adjoint) const {
+        if (this->folded) {
+            return;
+        }
         // Note we don't reconstruct the evaluator here. This is OK as long as all of our
         // user-facing methods require function evaluation before derivative.
         const auto &v_eval = this->evaluator();
@@ -110,14 +182,70 @@ struct Dynamic final : internal::base_tmpl_t<RhsDerived, Dynamic<RhsDerived>>,
         return this->dynReverseImpl(jac_map, init_adjoint);
     }
 
+    void dynBatchEvaluate(internal::DynamicBatch<Scalar> &batch) const override {
+        if (this->folded) {
+            *batch.template emplaceResults<EvalType>(this, false) = *this->folded;
+            return;
+        }
+        auto &&prepared = internal::prepareExpr(internal::adl{}, this->rhs());
+        auto inputs = std::vector<internal::DynamicBatchInput<Scalar>>{};
+        getBatchInputs(internal::adl{}, batch, inputs, prepared);
+
+        // If no input varies, neither does the result, which is evaluated once
+        const bool varying = std::any_of(
+          inputs.begin(), inputs.end(), [](const auto &in) { return in.stride != 0; });
+        auto *results = batch.template emplaceResults<EvalType>(this, varying);
+        const auto count = varying ? batch.size() : 1;
+        for (std::size_t k = 0; k < count; ++k) {
+            const auto *cursor = inputs.data();
+            const auto v_eval = BatchEvaluatorType{prepared, cursor, k};
+            results[k] = EvalType{v_eval()};
+        }
+    }
+
+    void dynBatchReverse(internal::DynamicBatch<Scalar> &batch) const override {
+        // Fixed-size adjoints for the same heights as dynReverse()
+        switch (batch.rows()) {
+            case 1: return this->batchReverseImpl<1>(batch);
+            case 2: return this->batchReverseImpl<2>(batch);
+            case 3: return this->batchReverseImpl<3>(batch);
+            case 6: return this->batchReverseImpl<6>(batch);
+            default: return this->batchReverseImpl<Eigen::Dynamic>(batch);
+        }
+    }
+
+    template <int Rows>
+    void batchReverseImpl(internal::DynamicBatch<Scalar> &batch) const {
+        const auto *adjoints = batch.adjoints(this);
+        if (this->folded || !adjoints) {
+            return;
+        }
+        using Adjoint = Eigen::Matrix<Scalar, Rows, TangentSize>;
+        using AdjointBlock = Eigen::Block<const MatrixType, Rows, TangentSize>;
+        auto &&prepared = internal::prepareExpr(internal::adl{}, this->rhs());
+        auto inputs = std::vector<internal::DynamicBatchInput<Scalar>>{};
+        getBatchInputs(internal::adl{}, batch, inputs, prepared);
+        for (std::size_t k = 0; k < batch.size(); ++k) {
+            const auto *cursor = inputs.data();
+            const auto v_eval = BatchEvaluatorType{prepared, cursor, k};
+            const auto col = static_cast<Eigen::Index>(k) * TangentSize;
+            const Adjoint adjoint =
+              AdjointBlock{*adjoints, 0, col, adjoints->rows(), TangentSize};
+            internal::BatchReverseEvaluator<PreparedType, Adjoint>{v_eval, adjoint, k};
+        }
+    }
+
     auto dynEvaluateWithDelta(const void *target, int coeff, Scalar delta) const
       -> EvalType override {
+        if (this->folded) {
+            return *this->folded;
+        }
         return internal::EvaluatorWithDelta<CleanType>{}(
           this->rhs(), target, coeff, delta);
     }
 
- private:
-    mutable boost::optional<internal::Evaluator<PreparedType>> lazy_evaluator;
+    /** Result kept by dynFold() */
+    mutable boost::optional<EvalType> folded;
 };
 
 /** Wrap an expression in a Dynamic
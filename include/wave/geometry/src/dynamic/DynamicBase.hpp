@@ -6,13 +6,278 @@
 #define WAVE_GEOMETRY_DYNAMICBASE_HPP
 
 namespace wave {
+namespace internal {
+
+template <typename Scalar>
+class DynamicBatch;
+
+/** Type-erased interface of a node in a graph of dynamic expressions
+ *
+ * All DynamicBase<Leaf> with the same scalar type share this base, which lets a graph
+ * mixing several leaf types be traversed one node at a time (see DynamicSweep).
+ *
+ * @tparam Scalar The scalar type of the expression
+ */
+template <typename Scalar>
+class DynamicNode {
+ public:
+    virtual ~DynamicNode() = default;
+
+    /** Appends leaf addresses and tangent sizes to vec
+     *
+     * During a DynamicSweep, only the leaves held directly by this node (not through
+     * another Dynamic node) are appended.
+     */
+    virtual void dynLeaves(DynamicLeavesVec &vec) const = 0;
+
+    /** Appends the dynamic nodes directly referenced by this node's expression */
+    virtual void dynChildren(std::vector<const DynamicNode *> &vec) const = 0;
+
+    /** Appends shared owners of the dynamic nodes held by this node's expression,
+     * including those of a folded node
+     */
+    virtual void dynOwnedChildren(
+      std::vector<std::shared_ptr<const DynamicNode>> &vec) const = 0;
+
+    /** Returns the tangent size of this node's result */
+    virtual int dynTangentSize() const = 0;
+
+    /** Constructs the evaluator for this node and keeps it in the active DynamicContext
+     *
+     * During a DynamicSweep, the children's kept evaluators are reused.
+     */
+    virtual void dynStore() const = 0;
+
+    /** Frees the evaluator kept for this node in the active DynamicContext, if any */
+    virtual void dynRelease() const = 0;
+
+    /** Evaluates this node once and keeps the result in the node
+     *
+     * Until dynUnfold(), the node acts as a constant: it returns the kept result, and has
+     * no leaves, children or Jacobians. This must not be called while the graph is being
+     * evaluated.
+     */
+    virtual void dynFold() const = 0;
+
+    /** Discards the result kept by dynFold(), if any */
+    virtual void dynUnfold() const = 0;
+
+    /** Returns set of reverse-mode Jacobians with respect to all leaves
+     *
+     * During a DynamicSweep, adjoints of child nodes are accumulated in the sweep instead
+     * of being propagated further.
+     *
+     * @param[in,out] jac_map a map of leaf address to dynamic Matrix, to be filled
+     * @param init_adjoint the adjoint matrix of this node
+     */
+    virtual void dynReverseDynamic(MatrixMap<const void *, Scalar> &jac_map,
+                                   const DynamicMatrix<Scalar> &init_adjoint) const = 0;
+
+    /** Evaluates this node for every instance of a batch, and stores the results in it
+     *
+     * The children must have been evaluated first.
+     */
+    virtual void dynBatchEvaluate(DynamicBatch<Scalar> &batch) const = 0;
+
+    /** Adds the adjoints of this node's leaves and children, for every instance of a
+     * batch, from the adjoints accumulated for this node
+     */
+    virtual void dynBatchReverse(DynamicBatch<Scalar> &batch) const = 0;
+};
+
+/** Drops one owner of a dynamic node, without recursing through the graph it owns
+ *
+ * A node owns its children through the Proxies in its expression, so destroying the last
+ * owner of a long chain would otherwise recurse once per node. Instead, before a node is
+ * destroyed, owners of its children are moved to an explicit stack, and each child is
+ * released in turn from there.
+ */
+template <typename Scalar>
+void releaseDynamicNode(std::shared_ptr<const DynamicNode<Scalar>> node) {
+    if (node.use_count() != 1) {
+        return;
+    }
+    auto stack = std::vector<std::shared_ptr<const DynamicNode<Scalar>>>{};
+    stack.push_back(std::move(node));
+    while (!stack.empty()) {
+        auto next = std::move(stack.back());
+        stack.pop_back();
+        if (next.use_count() == 1) {
+            // The children outlive next, so destroying it does not recurse into them
+            next->dynOwnedChildren(stack);
+        }
+    }
+}
+
+/** State of a node-by-node sweep over a graph of dynamic expressions
+ *
+ * While a context with a sweep is active on a thread, evaluators of Proxy expressions do
+ * not recurse into the Dynamic node they point to. Instead, they read the result the node
+ * has stored (see DynamicNode::dynStore()), and reverse-mode evaluators accumulate the
+ * node's adjoint here. The caller is then responsible for visiting each node in order.
+ *
+ * Adjoints may be accumulated and taken from several threads at once.
+ */
+template <typename Scalar>
+class DynamicSweep {
+ public:
+    /** Adds to the adjoint accumulated for the given node */
+    template <typename Adjoint>
+    void accumulate(const DynamicNode<Scalar> *node, const Adjoint &adjoint) {
+        std::lock_guard<std::mutex> lock{this->mutex};
+        auto &acc = this->adjoints[node];
+        if (acc.size() == 0) {
+            acc = adjoint;
+        } else {
+            acc += adjoint;
+        }
+    }
+
+    /** Removes and returns the adjoint accumulated for the given node
+     *
+     * An empty (size 0x0) matrix indicates no adjoint was accumulated.
+     */
+    DynamicMatrix<Scalar> take(const DynamicNode<Scalar> *node) {
+        std::lock_guard<std::mutex> lock{this->mutex};
+        auto it = this->adjoints.find(node);
+        if (it == this->adjoints.end()) {
+            return {};
+        }
+        auto res = std::move(it->second);
+        this->adjoints.erase(it);
+        return res;
+    }
+
+    /** Discards all accumulated adjoints */
+    void clear() {
+        std::lock_guard<std::mutex> lock{this->mutex};
+        this->adjoints.clear();
+    }
+
+ private:
+    std::mutex mutex;
+    std::unordered_map<const DynamicNode<Scalar> *, DynamicMatrix<Scalar>> adjoints;
+};
+
+/** Base class of the per-node state kept in a DynamicContext */
+struct DynamicNodeState {
+    virtual ~DynamicNodeState() = default;
+};
+
+/** Holds a value of type T as per-node state */
+template <typename T>
+struct DynamicNodeStateHolder final : DynamicNodeState {
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    template <typename... Args>
+    explicit DynamicNodeStateHolder(Args &&... args)
+        : value(std::forward<Args>(args)...) {}
+
+    T value;
+};
+
+/** Per-evaluation state of a graph of dynamic expressions
+ *
+ * Dynamic nodes themselves hold no evaluation state, so one graph can be evaluated and
+ * differentiated from several threads at once. Instead, each node keeps its Evaluator in
+ * the context active on the evaluating thread. The outermost Proxy evaluator creates a
+ * context if none is active, and its nested evaluators share it.
+ *
+ * A context may be shared between threads only if every node they use was first given a
+ * slot with reserve(). Then the states of distinct nodes may be accessed concurrently.
+ */
+template <typename Scalar>
+class DynamicContext {
+ public:
+    /** Adds an empty slot for the state of the given node, if it has none */
+    void reserve(const DynamicNode<Scalar> *node) {
+        this->states.emplace(node, nullptr);
+    }
+
+    /** Constructs a T as the state of the given node, replacing any existing state */
+    template <typename T, typename... Args>
+    T &emplace(const DynamicNode<Scalar> *node, Args &&... args) {
+        // Construct first: constructing T may add the states of other nodes
+        auto state =
+          std::make_unique<DynamicNodeStateHolder<T>>(std::forward<Args>(args)...);
+        auto &value = state->value;
+        const auto it = this->states.find(node);
+        if (it != this->states.end()) {
+            it->second = std::move(state);
+        } else {
+            this->states.emplace(node, std::move(state));
+        }
+        return value;
+    }
+
+    /** Returns the state of the given node, which must be a T, or nullptr if none */
+    template <typename T>
+    T *find(const DynamicNode<Scalar> *node) const {
+        const auto it = this->states.find(node);
+        if (it == this->states.end() || !it->second) {
+            return nullptr;
+        }
+        return &static_cast<DynamicNodeStateHolder<T> &>(*it->second).value;
+    }
+
+    /** Frees the state of the given node, if any, keeping its slot */
+    void erase(const DynamicNode<Scalar> *node) {
+        const auto it = this->states.find(node);
+        if (it != this->states.end()) {
+            it->second.reset();
+        }
+    }
+
+    /** The sweep in progress using this context, if any */
+    DynamicSweep<Scalar> *sweep = nullptr;
+
+ private:
+    std::unordered_map<const DynamicNode<Scalar> *, std::unique_ptr<DynamicNodeState>>
+      states;
+};
+
+/** Returns a reference to the context active on this thread, or nullptr if none */
+template <typename Scalar>
+DynamicContext<Scalar> *&activeContext() noexcept {
+    static thread_local DynamicContext<Scalar> *context = nullptr;
+    return context;
+}
+
+/** Installs a DynamicContext as active on this thread for its lifetime */
+template <typename Scalar>
+class ScopedDynamicContext {
+ public:
+    explicit ScopedDynamicContext(DynamicContext<Scalar> &context)
+        : previous{activeContext<Scalar>()} {
+        activeContext<Scalar>() = &context;
+    }
+
+    ~ScopedDynamicContext() {
+        activeContext<Scalar>() = this->previous;
+    }
+
+    ScopedDynamicContext(const ScopedDynamicContext &) = delete;
+    ScopedDynamicContext &operator=(const ScopedDynamicContext &) = delete;
+
+ private:
+    DynamicContext<Scalar> *previous;
+};
+
+/** Returns the sweep in progress on this thread, or nullptr if none */
+template <typename Scalar>
+DynamicSweep<Scalar> *activeSweep() noexcept {
+    const auto *context = activeContext<Scalar>();
+    return context ? context->sweep : nullptr;
+}
+
+}  // namespace internal
 
 /** Base class for expressions with dynamic dispatch
  *
  * @tparam Leaf The leaf type the derived expression will evaluate to
  */
 template <typename Leaf>
-class DynamicBase {
+class DynamicBase : public internal::DynamicNode<internal::scalar_t<Leaf>> {
     TICK_TRAIT_CHECK(internal::is_leaf_expression<Leaf>);
     using Scalar = internal::scalar_t<Leaf>;
     using EvalType = internal::eval_t<Leaf>;
@@ -21,11 +286,6 @@ class DynamicBase {
  public:
     virtual ~DynamicBase() = default;
 
-    /** Appends leaf addresses and tangent sizes to vec
-     * @warning should be private (@todo)
-     */
-    virtual void dynLeaves(internal::DynamicLeavesVec &vec) const = 0;
-
  private:
     // Virtualized versions of ExpressionBase methods
 
@@ -39,16 +299,6 @@ class DynamicBase {
     virtual auto dynJacobian(const void *target_ptr) const
       -> Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> = 0;
 
-    /** Returns set of reverse-mode Jacobians with respect to all leaves
-     *
-     * @param[in,out] jac_map a map of leaf address to dynamic Matrix, to be filled
-     * @param init_adjoint the adjoint matrix of the root node
-     * @returns a map of leaf address to dynamic Matrix
-     */
-    virtual void dynReverseDynamic(
-      MatrixMap<const void *, Scalar> &jac_map,
-      const internal::DynamicMatrix<Scalar> &init_adjoint) const = 0;
-
     /** Returns set of reverse-mode Jacobians with respect to all leaves
      * @see dynReverseDynamic. Specialization for 1*m adjoints.
      */
@@ -85,7 +335,8 @@ class DynamicBase {
     void dynReverse(MatrixMap<const void *, Scalar> &jac_map,
                     const Eigen::Matrix<Scalar, N, TangentSize> &init_adjoint) const {
         // @todo make dynamic adapter for MatrixMap
-        return dynReverseDynamic(jac_map, internal::DynamicMatrix<Scalar>{init_adjoint});
+        return this->dynReverseDynamic(jac_map,
+                                       internal::DynamicMatrix<Scalar>{init_adjoint});
     }
 
     /** Returns result of evaluation for numerical diff
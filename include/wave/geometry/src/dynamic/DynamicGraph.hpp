@@ -0,0 +1,183 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_DYNAMICGRAPH_HPP
+#define WAVE_GEOMETRY_DYNAMICGRAPH_HPP
+
+namespace wave {
+namespace internal {
+
+/** The shape of a graph of dynamic expressions, without its nodes
+ *
+ * Nodes are identified by their index in a topological order (each node comes after all
+ * of its children; the root is last). Graphs built alike, such as one per factor, differ
+ * only in their nodes and leaves, and can share one DynamicStructure.
+ */
+struct DynamicStructure {
+    std::vector<std::type_index> types;      // dynamic type of each node
+    std::vector<std::vector<int>> children;  // for each node, without duplicates
+    std::vector<std::vector<int>> parents;   // for each node, without duplicates
+    std::size_t hash = 0;                    // of types and children
+
+    /** Fills the parents from the children */
+    void linkParents() {
+        this->parents.assign(this->children.size(), {});
+        for (std::size_t i = 0; i < this->children.size(); ++i) {
+            for (const auto c : this->children[i]) {
+                this->parents[c].push_back(static_cast<int>(i));
+            }
+        }
+    }
+
+    /** Computes the hash of the types and children */
+    void computeHash() {
+        auto seed = this->types.size();
+        for (std::size_t i = 0; i < this->types.size(); ++i) {
+            boost::hash_combine(seed, this->types[i].hash_code());
+            boost::hash_combine(seed, this->children[i].size());
+            for (const auto c : this->children[i]) {
+                boost::hash_combine(seed, c);
+            }
+        }
+        this->hash = seed;
+    }
+
+    /** Returns true if both have the same types and children */
+    bool sameShape(const DynamicStructure &other) const {
+        return this->hash == other.hash && this->types == other.types &&
+               this->children == other.children;
+    }
+};
+
+/** Interns DynamicStructures, so each distinct shape is stored once
+ *
+ * May be used from several threads at once.
+ */
+class DynamicStructureCache {
+ public:
+    /** Returns the stored structure of the same shape, or stores a new one */
+    std::shared_ptr<const DynamicStructure> intern(DynamicStructure &&structure) {
+        std::lock_guard<std::mutex> lock{this->mutex};
+        const auto range = this->structures.equal_range(structure.hash);
+        for (auto it = range.first; it != range.second; ++it) {
+            if (it->second->sameShape(structure)) {
+                return it->second;
+            }
+        }
+        structure.linkParents();
+        auto res = std::make_shared<const DynamicStructure>(std::move(structure));
+        this->structures.emplace(res->hash, res);
+        return res;
+    }
+
+    /** Returns the number of distinct shapes stored */
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock{this->mutex};
+        return this->structures.size();
+    }
+
+ private:
+    mutable std::mutex mutex;
+    std::unordered_multimap<std::size_t, std::shared_ptr<const DynamicStructure>>
+      structures;
+};
+
+/** The nodes of a graph of dynamic expressions, in a topological order
+ *
+ * Nodes are discovered once, without recursion, since graphs can be very deep. Each node
+ * comes after all of its children; the root is last.
+ *
+ * If a DynamicStructureCache is given, graphs of the same shape share their structure,
+ * and only the node addresses are kept for each graph.
+ */
+template <typename Scalar>
+struct DynamicGraph {
+    using Node = DynamicNode<Scalar>;
+
+    struct NodeInfo {
+        const Node *node;
+        const std::vector<int> &children;  // indices in `nodes`, without duplicates
+        const std::vector<int> &parents;   // indices in `nodes`, without duplicates
+    };
+
+    /** Finds all nodes reachable from root */
+    explicit DynamicGraph(const Node &root, DynamicStructureCache *structures = nullptr) {
+        auto order = std::vector<const Node *>{};
+        auto shape = DynamicStructure{};
+        auto index = std::unordered_map<const Node *, int>{};
+        auto children = std::vector<const Node *>{};
+        auto stack = std::vector<std::pair<const Node *, bool>>{{&root, false}};
+        while (!stack.empty()) {
+            const auto entry = stack.back();
+            stack.pop_back();
+            if (index.count(entry.first)) {
+                continue;
+            }
+            children.clear();
+            entry.first->dynChildren(children);
+            if (entry.second) {
+                // All children have been ordered
+                auto child_indices = std::vector<int>{};
+                for (const auto *c : children) {
+                    const auto ci = index.at(c);
+                    if (std::find(child_indices.begin(), child_indices.end(), ci) ==
+                        child_indices.end()) {
+                        child_indices.push_back(ci);
+                    }
+                }
+                index.emplace(entry.first, static_cast<int>(order.size()));
+                order.push_back(entry.first);
+                shape.types.emplace_back(typeid(*entry.first));
+                shape.children.push_back(std::move(child_indices));
+            } else {
+                stack.emplace_back(entry.first, true);
+                for (auto it = children.rbegin(); it != children.rend(); ++it) {
+                    if (!index.count(*it)) {
+                        stack.emplace_back(*it, false);
+                    }
+                }
+            }
+        }
+
+        shape.computeHash();
+        if (structures) {
+            this->structure = structures->intern(std::move(shape));
+        } else {
+            shape.linkParents();
+            this->structure = std::make_shared<const DynamicStructure>(std::move(shape));
+        }
+        this->nodes.reserve(order.size());
+        for (std::size_t i = 0; i < order.size(); ++i) {
+            this->nodes.push_back(
+              {order[i], this->structure->children[i], this->structure->parents[i]});
+        }
+    }
+
+    /** Makes a map for the Jacobians of the root with respect to all leaves, set to zero
+     *
+     * Must be called while a DynamicSweep is active, so each node appends only its own
+     * leaves.
+     */
+    MatrixMap<const void *, Scalar> makeJacobianMap() const {
+        auto leaves = DynamicLeavesVec{};
+        for (const auto &info : this->nodes) {
+            info.node->dynLeaves(leaves);
+        }
+        std::sort(leaves.begin(), leaves.end(), [](auto &a, auto &b) {
+            return a.first < b.first;
+        });
+        auto jac_map = MatrixMap<const void *, Scalar>{
+          leaves.begin(), leaves.end(), this->nodes.back().node->dynTangentSize()};
+        jac_map.setZero();
+        return jac_map;
+    }
+
+    std::shared_ptr<const DynamicStructure> structure;
+    std::vector<NodeInfo> nodes;
+};
+
+}  // namespace internal
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_DYNAMICGRAPH_HPP
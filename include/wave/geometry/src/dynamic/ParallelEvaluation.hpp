@@ -0,0 +1,256 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_PARALLELEVALUATION_HPP
+#define WAVE_GEOMETRY_PARALLELEVALUATION_HPP
+
+namespace wave {
+namespace internal {
+
+/** Forward and reverse sweeps over a graph of Dynamic nodes, run on a WorkStealingPool
+ *
+ * In the forward pass, a node is evaluated as soon as all of its children have been, so
+ * independent subtrees are evaluated at the same time. Every result is stored. In the
+ * reverse pass, a node's adjoint is propagated as soon as all of its parents have added
+ * to it. Each thread adds leaf Jacobians to its own map, and the maps are summed at the
+ * end.
+ *
+ * When a node finishes, the thread continues with one of the parents (or children) it has
+ * made ready, and submits the others to the pool, so chains run without scheduling
+ * overhead. Graphs with fewer than `grain_size` nodes are swept in order on the calling
+ * thread, as are all graphs if the pool has one thread.
+ */
+template <typename Scalar>
+class ParallelSweep {
+    using Node = DynamicNode<Scalar>;
+    using JacobianMap = DynamicReverseResult<Scalar>;
+
+ public:
+    /** Default smallest number of nodes for which the pool is used */
+    static constexpr std::size_t DefaultGrainSize = 64;
+
+    ParallelSweep(const Node &root,
+                  WorkStealingPool &pool,
+                  std::size_t grain_size = DefaultGrainSize,
+                  DynamicStructureCache *structures = nullptr)
+        : graph{root, structures},
+          pool{pool},
+          parallel{pool.size() > 1 && graph.nodes.size() >= grain_size},
+          counters(graph.nodes.size()) {
+        this->context.sweep = &this->sweep;
+        // Give every node a slot first, so threads can store results concurrently
+        for (const auto &info : this->graph.nodes) {
+            this->context.reserve(info.node);
+        }
+    }
+
+    /** Returns true if the sweeps use the pool */
+    bool isParallel() const noexcept {
+        return this->parallel;
+    }
+
+    /** Runs the forward pass, storing every result
+     *
+     * @param on_root called with the root node while the results are stored
+     */
+    template <typename RootCallback>
+    void evaluate(const RootCallback &on_root) {
+        const ScopedDynamicContext<Scalar> scope{this->context};
+        this->forward();
+        on_root(*this->graph.nodes.back().node);
+        this->releaseAll();
+    }
+
+    /** Runs the forward and reverse passes, filling the map of leaf Jacobians
+     *
+     * @param on_root called with the root node while the results are stored
+     */
+    template <typename RootCallback>
+    auto run(const RootCallback &on_root) -> JacobianMap {
+        const ScopedDynamicContext<Scalar> scope{this->context};
+        this->forward();
+        on_root(*this->graph.nodes.back().node);
+        return this->reverse();
+    }
+
+ private:
+    void forward() {
+        const auto &nodes = this->graph.nodes;
+        if (!this->parallel) {
+            for (const auto &info : nodes) {
+                info.node->dynStore();
+            }
+            return;
+        }
+
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            this->counters[i] = static_cast<int>(nodes[i].children.size());
+        }
+        this->pool.run([this](std::size_t) {
+            for (int i = 0; i < static_cast<int>(this->graph.nodes.size()); ++i) {
+                if (this->graph.nodes[i].children.empty()) {
+                    this->pool.submit([this, i](std::size_t) { this->forwardFrom(i); });
+                }
+            }
+        });
+    }
+
+    /** Stores node i, then each parent it makes ready */
+    void forwardFrom(int i) {
+        const ScopedDynamicContext<Scalar> scope{this->context};
+        while (i >= 0) {
+            const auto &info = this->graph.nodes[i];
+            info.node->dynStore();
+            i = this->next(info.parents,
+                           [this](int p, std::size_t) { this->forwardFrom(p); });
+        }
+    }
+
+    auto reverse() -> JacobianMap {
+        const auto &nodes = this->graph.nodes;
+        const auto &root = nodes.back();
+        auto jac_map = this->graph.makeJacobianMap();
+        this->sweep.clear();
+        const auto size = root.node->dynTangentSize();
+        this->sweep.accumulate(root.node, DynamicMatrix<Scalar>::Identity(size, size));
+
+        if (!this->parallel) {
+            for (auto it = nodes.rbegin(); it != nodes.rend(); ++it) {
+                this->reverseNode(jac_map, *it);
+            }
+            return jac_map;
+        }
+
+        for (std::size_t i = 0; i < nodes.size(); ++i) {
+            this->counters[i] = static_cast<int>(nodes[i].parents.size());
+        }
+        // Each thread makes a copy of the zero map the first time it needs one
+        this->zero_map = &jac_map;
+        this->thread_maps.assign(this->pool.size(), boost::none);
+        const auto root_index = static_cast<int>(nodes.size()) - 1;
+        this->pool.run([this, root_index](std::size_t thread) {
+            this->reverseFrom(root_index, thread);
+        });
+        for (const auto &m : this->thread_maps) {
+            if (m) {
+                jac_map += *m;
+            }
+        }
+        this->thread_maps.clear();
+        return jac_map;
+    }
+
+    /** Propagates the adjoint of node i, then of each child it makes ready */
+    void reverseFrom(int i, std::size_t thread) {
+        const ScopedDynamicContext<Scalar> scope{this->context};
+        auto &jac_map = this->thread_maps[thread];
+        if (!jac_map) {
+            jac_map.emplace(*this->zero_map);
+        }
+        while (i >= 0) {
+            const auto &info = this->graph.nodes[i];
+            this->reverseNode(*jac_map, info);
+            i = this->next(info.children,
+                           [this](int c, std::size_t t) { this->reverseFrom(c, t); });
+        }
+    }
+
+    /** Propagates the summed adjoint of a node, and frees its stored result */
+    void reverseNode(JacobianMap &jac_map,
+                     const typename DynamicGraph<Scalar>::NodeInfo &info) {
+        const auto adjoint = this->sweep.take(info.node);
+        if (adjoint.size() != 0) {
+            info.node->dynReverseDynamic(jac_map, adjoint);
+        }
+        info.node->dynRelease();
+    }
+
+    /** Counts down the given neighbours. Submits a task continuing from each one that
+     * becomes ready, except the last, which is returned (or -1 if none) */
+    template <typename Continue>
+    int next(const std::vector<int> &neighbours, const Continue &continue_from) {
+        int ready = -1;
+        for (const auto j : neighbours) {
+            if (--this->counters[j] == 0) {
+                if (ready >= 0) {
+                    this->pool.submit([continue_from, ready](std::size_t thread) {
+                        continue_from(ready, thread);
+                    });
+                }
+                ready = j;
+            }
+        }
+        return ready;
+    }
+
+    void releaseAll() {
+        for (const auto &info : this->graph.nodes) {
+            info.node->dynRelease();
+        }
+    }
+
+    DynamicGraph<Scalar> graph;
+    WorkStealingPool &pool;
+    bool parallel;
+    // Children (forward) or parents (reverse) not yet visited, for each node
+    std::vector<std::atomic<int>> counters;
+    DynamicSweep<Scalar> sweep;
+    DynamicContext<Scalar> context;  // holds the stored results
+    const JacobianMap *zero_map = nullptr;
+    std::vector<boost::optional<JacobianMap>> thread_maps;  // indexed by pool thread
+};
+
+/** Evaluate a dynamic expression, evaluating independent subtrees on a thread pool
+ *
+ * @param grain_size smallest number of Dynamic nodes for which the pool is used
+ * @param structures if given, shares the graph structure with graphs of the same shape
+ * @return the result
+ */
+template <typename Derived, enable_if_proxy_t<Derived, int> = 0>
+auto evaluateParallel(
+  const ExpressionBase<Derived> &proxy,
+  WorkStealingPool &pool,
+  std::size_t grain_size = ParallelSweep<scalar_t<Derived>>::DefaultGrainSize,
+  DynamicStructureCache *structures = nullptr) -> plain_output_t<Derived> {
+    auto sweep = ParallelSweep<scalar_t<Derived>>{
+      proxy.derived().follow(), pool, grain_size, structures};
+    auto result = boost::optional<plain_output_t<Derived>>{};
+    sweep.evaluate([&](const DynamicNode<scalar_t<Derived>> &) {
+        // The root's result is stored, so the Evaluator does not recompute it
+        result.emplace(prepareOutput(Evaluator<Derived>{proxy.derived()}));
+    });
+    return std::move(*result);
+}
+
+/** Evaluate result and all Jacobians of a dynamic expression in reverse mode, sweeping
+ * independent subtrees on a thread pool
+ *
+ * Like evaluateWithCheckpointedReverseJacobians(), the graph is traversed without
+ * recursion and the adjoints of shared nodes are summed before being propagated. Every
+ * intermediate result is stored.
+ *
+ * @param grain_size smallest number of Dynamic nodes for which the pool is used
+ * @param structures if given, shares the graph structure with graphs of the same shape
+ * @return result and map of leaf address to Jacobians as dynamic matrices
+ */
+template <typename Derived, enable_if_proxy_t<Derived, int> = 0>
+auto evaluateWithParallelReverseJacobians(
+  const ExpressionBase<Derived> &proxy,
+  WorkStealingPool &pool,
+  std::size_t grain_size = ParallelSweep<scalar_t<Derived>>::DefaultGrainSize,
+  DynamicStructureCache *structures = nullptr)
+  -> std::pair<plain_output_t<Derived>, DynamicReverseResult<scalar_t<Derived>>> {
+    auto sweep = ParallelSweep<scalar_t<Derived>>{
+      proxy.derived().follow(), pool, grain_size, structures};
+    auto result = boost::optional<plain_output_t<Derived>>{};
+    auto jac_map = sweep.run([&](const DynamicNode<scalar_t<Derived>> &) {
+        result.emplace(prepareOutput(Evaluator<Derived>{proxy.derived()}));
+    });
+    return {std::move(*result), std::move(jac_map)};
+}
+
+}  // namespace internal
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_PARALLELEVALUATION_HPP
@@ -33,8 +33,28 @@ class Proxy final : public internal::base_tmpl_t<Leaf, Proxy<Leaf>> {
     Proxy() = delete;
     Proxy(const Proxy &) noexcept = default;
     Proxy(Proxy &&) noexcept = default;
-    Proxy &operator=(const Proxy &) = default;
-    Proxy &operator=(Proxy &&) = default;
+
+    Proxy &operator=(const Proxy &other) {
+        auto old = std::move(this->storage);
+        this->storage = other.storage;
+        internal::releaseDynamicNode<Scalar>(std::move(old));
+        return *this;
+    }
+
+    Proxy &operator=(Proxy &&other) {
+        auto old = std::move(this->storage);
+        this->storage = std::move(other.storage);
+        internal::releaseDynamicNode<Scalar>(std::move(old));
+        return *this;
+    }
+
+    /** Releases the graph, if this is its last owner, without recursion
+     *
+     * @see internal::releaseDynamicNode()
+     */
+    ~Proxy() {
+        internal::releaseDynamicNode<Scalar>(std::move(this->storage));
+    }
 
     /** Construct by making an rvalue expression Dynamic and moving it to the heap */
     template <typename Derived>
@@ -56,6 +76,8 @@ class Proxy final : public internal::base_tmpl_t<Leaf, Proxy<Leaf>> {
     }
 
  private:
+    using Scalar = internal::scalar_t<Leaf>;
+
     std::shared_ptr<DynamicBase<Leaf>> storage;
 };
 
@@ -96,15 +118,33 @@ template <typename Derived>
 struct Evaluator<Derived, std::enable_if_t<is_proxy<Derived>{}>> {
     EIGEN_MAKE_ALIGNED_OPERATOR_NEW
     using EvalType = eval_t<Derived>;
+    using Scalar = scalar_t<Derived>;
 
+    /** Evaluates the graph in the context active on this thread, or, if there is none
+     * (this is the outermost Proxy), in a new context owned by this Evaluator */
     WAVE_STRONG_INLINE explicit Evaluator(const Derived &proxy)
-        : expr{proxy.follow()}, result{expr.dynEvaluate()} {}
+        : owned_context{activeContext<Scalar>()
+                          ? nullptr
+                          : std::make_unique<DynamicContext<Scalar>>()},
+          context{owned_context ? *owned_context : *activeContext<Scalar>()},
+          expr{proxy.follow()},
+          result{this->evaluate()} {}
 
     const EvalType &operator()() const {
         return this->result;
     }
 
+ private:
+    EvalType evaluate() const {
+        const ScopedDynamicContext<Scalar> scope{this->context};
+        return this->expr.dynEvaluate();
+    }
+
+    std::unique_ptr<DynamicContext<Scalar>> owned_context;
+
  public:
+    /** The context holding the Evaluators of the derived graph */
+    DynamicContext<Scalar> &context;
     const DynamicBase<plain_output_t<Derived>> &expr;
     const EvalType result;
 };
@@ -126,6 +166,7 @@ struct DynamicJacobianEvaluator<Derived, enable_if_proxy_t<Derived>> {
             return DynamicMatrix<Scalar>::Identity(TangentSize, TangentSize).eval();
         }
         // Otherwise, dynamically get the Jacobian of the derived expression
+        const ScopedDynamicContext<Scalar> scope{this->v_eval.context};
         return this->v_eval.expr.dynJacobian(this->target_ptr);
     }
 
@@ -154,6 +195,7 @@ struct JacobianEvaluator<
         }
         // Otherwise, dynamically get the Jacobian of the derived expression and convert
         // to the expected optional-fixed-size return type
+        const ScopedDynamicContext<Scalar> scope{this->v_eval.context};
         const auto dyn_jac = this->v_eval.expr.dynJacobian(this->target_ptr);
         if (dyn_jac.size() > 0) {
             return jacobian_t<Derived, Target>{dyn_jac};
@@ -170,12 +212,56 @@ struct JacobianEvaluator<
 
 template <typename Derived, typename Adjoint>
 struct DynamicReverseJacobianEvaluator<Derived, Adjoint, enable_if_proxy_t<Derived>> {
+    // Evaluate to a plain matrix type matching one of the DynamicBase::dynReverse()
+    // overloads (the adjoint could be, e.g., row-major or have dynamic width)
+    using AdjointMatrix = Eigen::Matrix<scalar_t<Derived>,
+                                        tmp::remove_cr_t<Adjoint>::RowsAtCompileTime,
+                                        eval_traits<Derived>::TangentSize>;
+
     WAVE_STRONG_INLINE DynamicReverseJacobianEvaluator(
       DynamicReverseResult<scalar_t<Derived>> &jac_map,
       const Evaluator<Derived> &v_eval,
       const Adjoint &adjoint) {
-        // Dynamically get the Jacobians of the derived expression
-        v_eval.expr.dynReverse(jac_map, adjoint.eval());
+        if (auto *sweep = v_eval.context.sweep) {
+            // The sweep visits the derived expression later, with its summed adjoint
+            sweep->accumulate(&v_eval.expr, adjoint);
+        } else {
+            // Dynamically get the Jacobians of the derived expression
+            const ScopedDynamicContext<scalar_t<Derived>> scope{v_eval.context};
+            v_eval.expr.dynReverse(jac_map, AdjointMatrix{adjoint});
+        }
+    }
+};
+
+/** Reads the results of the derived expression for one instance of a batch */
+template <typename Derived>
+struct BatchEvaluator<Derived, enable_if_proxy_t<Derived>> {
+    using EvalType = eval_t<Derived>;
+    using Input = DynamicBatchInput<scalar_t<Derived>>;
+
+    WAVE_STRONG_INLINE BatchEvaluator(const Derived &,
+                                      const Input *&cursor,
+                                      std::size_t k)
+        : input{*cursor++},
+          result{static_cast<const EvalType *>(this->input.values)[k * input.stride]} {}
+
+    const EvalType &operator()() const {
+        return this->result;
+    }
+
+ public:
+    const Input &input;
+    const EvalType &result;
+};
+
+/** Adds the adjoint to those of the derived expression, which visits them later */
+template <typename Derived, typename Adjoint>
+struct BatchReverseEvaluator<Derived, Adjoint, enable_if_proxy_t<Derived>> {
+    WAVE_STRONG_INLINE BatchReverseEvaluator(const BatchEvaluator<Derived> &evaluator,
+                                             const Adjoint &adjoint,
+                                             std::size_t k) {
+        accumulateBatchAdjoint<eval_traits<Derived>::TangentSize>(
+          evaluator.input, adjoint, k);
     }
 };
 
@@ -239,7 +325,10 @@ decltype(auto) getWrtTarget(adl, const ExpressionBase<Proxy<Leaf>> &proxy) {
 
 template <typename Derived, enable_if_proxy_t<Derived, int> = 0>
 void getLeaves(adl, DynamicLeavesVec &vec, const ExpressionBase<Derived> &proxy) {
-    return proxy.derived().follow().dynLeaves(vec);
+    // During a sweep, the leaves of each node are collected separately
+    if (!activeSweep<scalar_t<Derived>>()) {
+        proxy.derived().follow().dynLeaves(vec);
+    }
 }
 
 // Enabled for DynamicBase references only, not Dynamic<Leaf>
@@ -254,6 +343,51 @@ void getLeaves(adl, DynamicLeavesVec &vec, const Dynamic<Leaf> &expr) {
     return getLeaves(adl{}, vec, expr.derived().rhs());
 }
 
+template <typename Scalar, typename Derived, enable_if_proxy_t<Derived, int> = 0>
+void getBatchInputs(adl,
+                    DynamicBatch<Scalar> &batch,
+                    std::vector<DynamicBatchInput<Scalar>> &inputs,
+                    const ExpressionBase<Derived> &proxy) {
+    inputs.push_back(batch.template node<eval_t<Derived>>(&proxy.derived().follow()));
+}
+
+/** getDynamicChildren() functions build up a vector of the dynamic nodes referenced
+ * directly by an expression, with duplicates, as pointers or as shared owners.
+ */
+template <typename Vec, typename Derived, enable_if_leaf_or_scalar_t<Derived, int> = 0>
+void getDynamicChildren(adl, Vec &, const Derived &) {}
+
+template <typename Vec, typename Derived, enable_if_unary_t<Derived, int> = 0>
+void getDynamicChildren(adl, Vec &vec, const ExpressionBase<Derived> &expr) {
+    return getDynamicChildren(adl{}, vec, expr.derived().rhs());
+}
+
+template <typename Vec, typename Derived, enable_if_binary_t<Derived, int> = 0>
+void getDynamicChildren(adl, Vec &vec, const ExpressionBase<Derived> &expr) {
+    getDynamicChildren(adl{}, vec, expr.derived().lhs());
+    getDynamicChildren(adl{}, vec, expr.derived().rhs());
+}
+
+template <typename Scalar, typename Derived, enable_if_proxy_t<Derived, int> = 0>
+void getDynamicChildren(adl,
+                        std::vector<const DynamicNode<Scalar> *> &vec,
+                        const ExpressionBase<Derived> &proxy) {
+    vec.push_back(&proxy.derived().follow());
+}
+
+template <typename Scalar, typename Leaf>
+void getDynamicChildren(adl,
+                        std::vector<std::shared_ptr<const DynamicNode<Scalar>>> &vec,
+                        const Proxy<Leaf> &proxy) {
+    vec.push_back(proxy.get());
+}
+
+// A RefProxy does not own the node it refers to
+template <typename Scalar, typename Leaf>
+void getDynamicChildren(adl,
+                        std::vector<std::shared_ptr<const DynamicNode<Scalar>>> &,
+                        const RefProxy<Leaf> &) {}
+
 }  // namespace internal
 
 // For Proxies, identity is determined by what they point at
@@ -0,0 +1,175 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_BACKGROUNDSOLVER_HPP
+#define WAVE_GEOMETRY_BACKGROUNDSOLVER_HPP
+
+namespace wave {
+
+/** Runs an iterative solver on a background thread, publishing each iterate to readers
+ *
+ * The solver thread owns a private Problem, such as a VariableStore with its factors.
+ * Other threads change it only by posting updates (e.g. adding a variable and the
+ * factors on it), which are queued without locking and applied by the solver thread
+ * before its next iteration. After each iteration, the solution is copied out of the
+ * problem into a DoubleBuffer, so any number of threads can read the latest solution
+ * without waiting, while the next iteration runs.
+ *
+ * The thread iterates until an iteration reports convergence, then sleeps until the
+ * next update is posted.
+ *
+ * @tparam Problem the state the solver iterates on
+ * @tparam Solution the state published to readers, e.g. the variables of the problem
+ */
+template <typename Problem, typename Solution>
+class BackgroundSolver {
+ public:
+    /** Changes the problem on the solver thread */
+    using Update = std::function<void(Problem &)>;
+    /** Runs one iteration, and returns true if the problem has converged */
+    using Iterate = std::function<bool(Problem &)>;
+    /** Copies the solution out of the problem, reusing the memory of the destination */
+    using Publish = std::function<void(const Problem &, Solution &)>;
+
+    /** Publishes the solution of the initial problem, and starts the solver thread
+     *
+     * The thread does not iterate until the first update is posted.
+     */
+    BackgroundSolver(Problem problem, Iterate iterate, Publish publish)
+        : problem{std::move(problem)},
+          iterate{std::move(iterate)},
+          publish{std::move(publish)} {
+        this->publishSolution();
+        this->thread = std::thread{[this] { this->work(); }};
+    }
+
+    /** Stops the solver thread, after the iteration in progress */
+    ~BackgroundSolver() {
+        this->stopping = true;
+        { std::lock_guard<std::mutex> lock{this->mutex}; }
+        this->wake.notify_one();
+        this->thread.join();
+    }
+
+    BackgroundSolver(const BackgroundSolver &) = delete;
+    BackgroundSolver &operator=(const BackgroundSolver &) = delete;
+
+    /** Queues an update, to be applied before the next iteration
+     *
+     * The update is queued without locking. The lock is taken only to wake the solver
+     * thread if it is sleeping.
+     */
+    void post(Update update) {
+        this->queue.push(std::move(update));
+        if (this->sleeping.load()) {
+            { std::lock_guard<std::mutex> lock{this->mutex}; }
+            this->wake.notify_one();
+        }
+    }
+
+    /** Returns f(solution) for the latest published solution, without waiting
+     *
+     * See DoubleBuffer::read().
+     */
+    template <typename F>
+    decltype(auto) read(F &&f) const {
+        return this->solution.read(std::forward<F>(f));
+    }
+
+    /** Returns a copy of the latest published solution */
+    Solution latest() const {
+        return this->solution.load();
+    }
+
+    /** Returns the number of solutions published since construction */
+    std::uint64_t published() const noexcept {
+        return this->num_published.load();
+    }
+
+    /** Blocks until all posted updates are applied and the solver has converged
+     *
+     * @throws the first exception thrown by an update or iteration since the last call.
+     * The solver treats a throwing iteration as converged.
+     */
+    void waitUntilIdle() {
+        auto error = std::exception_ptr{};
+        {
+            std::unique_lock<std::mutex> lock{this->mutex};
+            this->idle_changed.wait(
+              lock, [this] { return this->idle && this->queue.empty(); });
+            std::swap(error, this->error);
+        }
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+ private:
+    void publishSolution() {
+        this->solution.write(
+          [this](Solution &solution) { this->publish(this->problem, solution); });
+        ++this->num_published;
+    }
+
+    /** Loop of the solver thread */
+    void work() {
+        bool converged = true;
+        while (true) {
+            try {
+                const auto num_updates = this->queue.consumeAll(
+                  [this](Update &&update) { update(this->problem); });
+                if (num_updates > 0) {
+                    converged = false;
+                }
+                if (!converged && !this->stopping.load()) {
+                    converged = this->iterate(this->problem);
+                    this->publishSolution();
+                    continue;
+                }
+            } catch (...) {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                if (!this->error) {
+                    this->error = std::current_exception();
+                }
+                converged = true;
+            }
+
+            std::unique_lock<std::mutex> lock{this->mutex};
+            if (this->stopping.load()) {
+                return;
+            }
+            // A post() after this store sees it and wakes us; a post() before it has
+            // pushed an update we see below
+            this->sleeping = true;
+            if (this->queue.empty()) {
+                this->idle = true;
+                this->idle_changed.notify_all();
+                this->wake.wait(lock, [this] {
+                    return this->stopping.load() || !this->queue.empty();
+                });
+                this->idle = false;
+            }
+            this->sleeping = false;
+        }
+    }
+
+    Problem problem;  // only used by the solver thread after construction
+    Iterate iterate;
+    Publish publish;
+    MpscQueue<Update> queue;
+    DoubleBuffer<Solution> solution;
+    std::atomic<std::uint64_t> num_published{0};
+    std::atomic<bool> sleeping{false};
+    std::atomic<bool> stopping{false};
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable idle_changed;
+    bool idle = false;  // guarded by mutex
+    std::exception_ptr error;
+    std::thread thread;
+};
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_BACKGROUNDSOLVER_HPP
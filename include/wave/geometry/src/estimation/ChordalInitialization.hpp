@@ -0,0 +1,316 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_CHORDALINITIALIZATION_HPP
+#define WAVE_GEOMETRY_CHORDALINITIALIZATION_HPP
+
+namespace wave {
+
+/** A measured rotation between two rotation variables, such that R_j = R_i * rotation
+ *
+ * The indices are those of the variables among variables of the same type in a
+ * VariableStore.
+ */
+template <typename Rotation>
+struct RelativeRotationMeasurement {
+    std::size_t i;
+    std::size_t j;
+    Rotation rotation;
+    double weight = 1;
+};
+
+/** A measured transform between two pose variables, such that T_j = T_i * transform
+ *
+ * The indices are those of the variables among variables of the same type in a
+ * VariableStore.
+ */
+template <typename Transform>
+struct RelativePoseMeasurement {
+    std::size_t i;
+    std::size_t j;
+    Transform transform;
+    double rotation_weight = 1;
+    double translation_weight = 1;
+};
+
+namespace internal {
+
+using Matrix3dVector =
+  std::vector<Eigen::Matrix3d, Eigen::aligned_allocator<Eigen::Matrix3d>>;
+
+/** (i, j, R_ij, weight) of a measured relative rotation, as a matrix */
+using ChordalRotation = std::tuple<std::size_t, std::size_t, Eigen::Matrix3d, double>;
+
+/** (i, j, d_ij, weight) of a measured world-frame offset between translations */
+using ChordalOffset = std::tuple<std::size_t, std::size_t, Eigen::Vector3d, double>;
+
+/** Returns the rotation matrix of a rotation expression */
+template <typename Derived>
+Eigen::Matrix3d rotationMatrix(const RotationBase<Derived> &R) {
+    return RotationMd{R.derived()}.value();
+}
+
+/** Returns the nearest rotation matrix to M in the Frobenius norm */
+inline Eigen::Matrix3d projectToRotation(const Eigen::Matrix3d &M) {
+    const auto svd =
+      Eigen::JacobiSVD<Eigen::Matrix3d>{M, Eigen::ComputeFullU | Eigen::ComputeFullV};
+    Eigen::Matrix3d U = svd.matrixU();
+    if ((U * svd.matrixV().transpose()).determinant() < 0) {
+        U.col(2) = -U.col(2);
+    }
+    return U * svd.matrixV().transpose();
+}
+
+/** Throws std::runtime_error unless measurements of positive weight connect all n
+ * variables
+ *
+ * @param measurements tuples starting with (i, j), and ending with the weight
+ */
+template <typename Measurement>
+void checkConnected(std::size_t n, const std::vector<Measurement> &measurements) {
+    auto parent = std::vector<std::size_t>(n);
+    std::iota(parent.begin(), parent.end(), std::size_t{0});
+    const auto root = [&parent](std::size_t k) {
+        while (parent[k] != k) {
+            k = parent[k] = parent[parent[k]];
+        }
+        return k;
+    };
+    auto components = n;
+    for (const auto &m : measurements) {
+        if (std::get<3>(m) > 0) {
+            const auto a = root(std::get<0>(m));
+            const auto b = root(std::get<1>(m));
+            if (a != b) {
+                parent[a] = b;
+                --components;
+            }
+        }
+    }
+    if (components > 1) {
+        throw std::runtime_error{"The measurements must connect all variables"};
+    }
+}
+
+/** Solves the chordal relaxation of rotation averaging
+ *
+ * Minimizes sum of w_ij |R_j - R_i R_ij|_F^2 over 3x3 matrices, with R_anchor fixed, and
+ * projects each result onto SO(3). Writing X_k = R_k^T, each residual is
+ * X_j - R_ij^T X_i, so the three columns of X are independent problems sharing one
+ * sparse matrix.
+ *
+ * @param rotations the initial rotations; only the anchor is used. Holds the results.
+ * @param measurements (i, j, R_ij, w_ij) for each measurement
+ */
+inline void solveChordalRotations(Matrix3dVector &rotations,
+                                  const std::vector<ChordalRotation> &measurements,
+                                  std::size_t anchor) {
+    const auto n = rotations.size();
+    assert(anchor < n);
+    if (n < 2) {
+        return;
+    }
+    checkConnected(n, measurements);
+    // Unknowns are numbered skipping the anchor
+    const auto col = [anchor](std::size_t k) { return 3 * (k < anchor ? k : k - 1); };
+    const Eigen::Matrix3d X_anchor = rotations[anchor].transpose();
+
+    auto triplets = std::vector<Eigen::Triplet<double>>{};
+    triplets.reserve(4 * 9 * measurements.size());
+    Eigen::MatrixXd b = Eigen::MatrixXd::Zero(3 * (n - 1), 3);
+    const auto addBlock = [&triplets](std::size_t r, std::size_t c, const auto &block) {
+        for (int x = 0; x < 3; ++x) {
+            for (int y = 0; y < 3; ++y) {
+                triplets.emplace_back(r + x, c + y, block(x, y));
+            }
+        }
+    };
+    const Eigen::Matrix3d I = Eigen::Matrix3d::Identity();
+    for (const auto &m : measurements) {
+        const auto i = std::get<0>(m);
+        const auto j = std::get<1>(m);
+        const Eigen::Matrix3d M = std::get<2>(m).transpose();
+        const auto w = std::get<3>(m);
+        assert(i < n && j < n);
+        if (i != anchor) {
+            addBlock(col(i), col(i), w * I);
+        }
+        if (j != anchor) {
+            addBlock(col(j), col(j), w * I);
+        }
+        if (i != anchor && j != anchor) {
+            addBlock(col(i), col(j), -w * M.transpose());
+            addBlock(col(j), col(i), -w * M);
+        } else if (i == anchor && j != anchor) {
+            b.middleRows<3>(col(j)) += w * M * X_anchor;
+        } else if (j == anchor && i != anchor) {
+            b.middleRows<3>(col(i)) += w * M.transpose() * X_anchor;
+        }
+    }
+
+    Eigen::SparseMatrix<double> H(3 * (n - 1), 3 * (n - 1));
+    H.setFromTriplets(triplets.begin(), triplets.end());
+    const Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> solver{H};
+    if (solver.info() != Eigen::Success) {
+        throw std::runtime_error{"Chordal rotation system could not be factorized"};
+    }
+    const Eigen::MatrixXd X = solver.solve(b);
+
+    for (std::size_t k = 0; k < n; ++k) {
+        if (k != anchor) {
+            rotations[k] = projectToRotation(X.middleRows<3>(col(k)).transpose());
+        }
+    }
+}
+
+/** Solves for translations given rotations, by linear least squares
+ *
+ * Minimizes sum of w_ij |t_j - t_i - d_ij|^2 with t_anchor fixed, where d_ij is the
+ * measured translation rotated into the world frame. The three coordinates are
+ * independent problems sharing the weighted graph Laplacian.
+ *
+ * @param translations the initial translations; only the anchor is used. Holds the
+ * results, as rows.
+ * @param measurements (i, j, d_ij, w_ij) for each measurement
+ */
+inline void solveTranslations(Eigen::MatrixX3d &translations,
+                              const std::vector<ChordalOffset> &measurements,
+                              std::size_t anchor) {
+    const auto n = static_cast<std::size_t>(translations.rows());
+    assert(anchor < n);
+    if (n < 2) {
+        return;
+    }
+    checkConnected(n, measurements);
+    const auto col = [anchor](std::size_t k) { return k < anchor ? k : k - 1; };
+    const Eigen::RowVector3d t_anchor = translations.row(anchor);
+
+    auto triplets = std::vector<Eigen::Triplet<double>>{};
+    triplets.reserve(4 * measurements.size());
+    Eigen::MatrixX3d b = Eigen::MatrixX3d::Zero(n - 1, 3);
+    for (const auto &m : measurements) {
+        const auto i = std::get<0>(m);
+        const auto j = std::get<1>(m);
+        const Eigen::RowVector3d d = std::get<2>(m).transpose();
+        const auto w = std::get<3>(m);
+        assert(i < n && j < n);
+        if (i != anchor && j != anchor) {
+            triplets.emplace_back(col(i), col(i), w);
+            triplets.emplace_back(col(j), col(j), w);
+            triplets.emplace_back(col(i), col(j), -w);
+            triplets.emplace_back(col(j), col(i), -w);
+            b.row(col(i)) -= w * d;
+            b.row(col(j)) += w * d;
+        } else if (i == anchor && j != anchor) {
+            triplets.emplace_back(col(j), col(j), w);
+            b.row(col(j)) += w * (t_anchor + d);
+        } else if (j == anchor && i != anchor) {
+            triplets.emplace_back(col(i), col(i), w);
+            b.row(col(i)) += w * (t_anchor - d);
+        }
+    }
+
+    Eigen::SparseMatrix<double> L(n - 1, n - 1);
+    L.setFromTriplets(triplets.begin(), triplets.end());
+    const Eigen::SimplicialLDLT<Eigen::SparseMatrix<double>> solver{L};
+    if (solver.info() != Eigen::Success) {
+        throw std::runtime_error{"Chordal translation system could not be factorized"};
+    }
+    const Eigen::MatrixX3d t = solver.solve(b);
+
+    for (std::size_t k = 0; k < n; ++k) {
+        if (k != anchor) {
+            translations.row(k) = t.row(col(k));
+        }
+    }
+}
+
+}  // namespace internal
+
+/** Initializes rotation variables by chordal relaxation
+ *
+ * Solves a sparse linear least-squares problem over unconstrained 3x3 matrices, then
+ * projects each onto SO(3) by SVD. The result is usually close to the optimum of the
+ * nonlinear problem, unlike rotations composed along odometry, which drift.
+ *
+ * @tparam Leaf the rotation type of the variables, among those in the store
+ * @param store holds the variables; all of type Leaf are overwritten except the anchor
+ * @param measurements relative rotations, which must connect all variables of type Leaf
+ * @param anchor index of the variable held fixed, fixing the gauge
+ * @throws std::runtime_error if the measurements do not connect all variables, leaving
+ * the store unchanged
+ */
+template <typename Leaf, typename... Leaves, typename Rotation>
+void initializeRotationsChordal(
+  VariableStore<Leaves...> &store,
+  const std::vector<RelativeRotationMeasurement<Rotation>> &measurements,
+  std::size_t anchor = 0) {
+    auto &x = store.template values<Leaf>();
+    auto rotations = internal::Matrix3dVector{};
+    rotations.reserve(x.size());
+    for (const auto &xi : x) {
+        rotations.push_back(internal::rotationMatrix(xi));
+    }
+    auto relative = std::vector<internal::ChordalRotation>{};
+    relative.reserve(measurements.size());
+    for (const auto &m : measurements) {
+        relative.emplace_back(m.i, m.j, internal::rotationMatrix(m.rotation), m.weight);
+    }
+
+    internal::solveChordalRotations(rotations, relative, anchor);
+    for (std::size_t k = 0; k < x.size(); ++k) {
+        x[k] = RotationMd{rotations[k]};
+    }
+}
+
+/** Initializes pose variables by chordal relaxation over rotations, then translations
+ *
+ * Rotations are found as in initializeRotationsChordal(). With those fixed, translations
+ * appear linearly in the measurements, and are found by a second sparse linear solve.
+ *
+ * @tparam Leaf the rigid transform type of the variables, among those in the store
+ * @param store holds the variables; all of type Leaf are overwritten except the anchor
+ * @param measurements relative poses, which must connect all variables of type Leaf
+ * @param anchor index of the variable held fixed, fixing the gauge
+ * @throws std::runtime_error if the measurements do not connect all variables, leaving
+ * the store unchanged
+ */
+template <typename Leaf, typename... Leaves, typename Transform>
+void initializePosesChordal(
+  VariableStore<Leaves...> &store,
+  const std::vector<RelativePoseMeasurement<Transform>> &measurements,
+  std::size_t anchor = 0) {
+    auto &x = store.template values<Leaf>();
+    auto rotations = internal::Matrix3dVector{};
+    rotations.reserve(x.size());
+    Eigen::MatrixX3d translations{x.size(), 3};
+    for (std::size_t k = 0; k < x.size(); ++k) {
+        rotations.push_back(internal::rotationMatrix(x[k].rotation()));
+        translations.row(k) = Translationd{x[k].translation()}.value().transpose();
+    }
+    auto relative = std::vector<internal::ChordalRotation>{};
+    relative.reserve(measurements.size());
+    for (const auto &m : measurements) {
+        relative.emplace_back(
+          m.i, m.j, internal::rotationMatrix(m.transform.rotation()), m.rotation_weight);
+    }
+    internal::solveChordalRotations(rotations, relative, anchor);
+
+    auto offsets = std::vector<internal::ChordalOffset>{};
+    offsets.reserve(measurements.size());
+    for (const auto &m : measurements) {
+        const Eigen::Vector3d t_ij = Translationd{m.transform.translation()}.value();
+        offsets.emplace_back(m.i, m.j, rotations[m.i] * t_ij, m.translation_weight);
+    }
+    internal::solveTranslations(translations, offsets, anchor);
+
+    for (std::size_t k = 0; k < x.size(); ++k) {
+        x[k].rotationBlock() = RotationMd{rotations[k]};
+        x[k].translationBlock() = Translationd{translations.row(k).transpose()};
+    }
+}
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_CHORDALINITIALIZATION_HPP
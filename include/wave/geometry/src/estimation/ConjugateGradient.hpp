@@ -0,0 +1,415 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_CONJUGATEGRADIENT_HPP
+#define WAVE_GEOMETRY_CONJUGATEGRADIENT_HPP
+
+namespace wave {
+
+namespace internal {
+
+/** Returns y += J^T v for one Jacobian block with column-major data */
+template <int Cols>
+void addTransposeProduct(const double *data,
+                         Eigen::Index rows,
+                         Eigen::Index cols,
+                         const double *v,
+                         double *y) {
+    using Block = Eigen::Matrix<double, Eigen::Dynamic, Cols>;
+    using Vector = Eigen::Matrix<double, Cols, 1>;
+    const auto J = Eigen::Map<const Block>{data, rows, cols};
+    const auto x = Eigen::Map<const Eigen::VectorXd>{v, rows};
+    Eigen::Map<Vector>{y, cols} += J.transpose() * x;
+}
+
+/** Returns v += J x for one Jacobian block with column-major data */
+template <int Cols>
+void addProduct(const double *data,
+                Eigen::Index rows,
+                Eigen::Index cols,
+                const double *x,
+                double *v) {
+    using Block = Eigen::Matrix<double, Eigen::Dynamic, Cols>;
+    using Vector = Eigen::Matrix<double, Cols, 1>;
+    const auto J = Eigen::Map<const Block>{data, rows, cols};
+    Eigen::Map<Eigen::VectorXd>{v, rows} += J * Eigen::Map<const Vector>{x, cols};
+}
+
+}  // namespace internal
+
+/** The Jacobian of a least-squares problem, kept as the dense blocks of each factor
+ *
+ * Each factor adds its whitened residual and one Jacobian block for each variable it
+ * depends on, at the variable's position in the stacked tangent vector (see
+ * VariableStore::tangentOffset()). Products with J^T J are computed factor by factor,
+ * so the normal equations are never formed: memory grows with the number of Jacobian
+ * blocks, not with the fill of a Cholesky factor.
+ */
+class BlockJacobian {
+ public:
+    /** Constructs an empty Jacobian for a tangent vector of the given size */
+    explicit BlockJacobian(std::size_t num_columns) : block_sizes(num_columns, 0) {}
+
+    /** Adds a factor
+     *
+     * @param residual the whitened residual
+     * @param columns the position of each variable in the stacked tangent vector
+     * @param jacobians the Jacobian of the residual with respect to each variable
+     */
+    template <typename R, typename... Js>
+    void addFactor(const Eigen::MatrixBase<R> &residual,
+                   const std::array<std::size_t, sizeof...(Js)> &columns,
+                   const Eigen::MatrixBase<Js> &... jacobians) {
+        const auto rows = residual.size();
+        this->factors.push_back({this->residuals.size(), rows, this->blocks.size(), 0});
+        for (Eigen::Index i = 0; i < rows; ++i) {
+            this->residuals.push_back(residual(i));
+        }
+        std::size_t k = 0;
+        (void) std::initializer_list<int>{
+          (this->addBlock(columns[k++], rows, jacobians.derived()), 0)...};
+        this->factors.back().end_block = this->blocks.size();
+    }
+
+    /** Returns the size of the stacked tangent vector */
+    std::size_t cols() const noexcept {
+        return this->block_sizes.size();
+    }
+
+    /** Returns the number of factors */
+    std::size_t size() const noexcept {
+        return this->factors.size();
+    }
+
+    /** Returns the number of bytes used by the residuals and Jacobian blocks */
+    std::size_t bytes() const noexcept {
+        return sizeof(double) * (this->values.size() + this->residuals.size()) +
+               sizeof(Factor) * this->factors.size() +
+               sizeof(Block) * this->blocks.size();
+    }
+
+    /** Returns J^T r, the gradient of half the squared norm of the residuals
+     *
+     * @param pool if not null, factors are split into tasks on the pool, and their
+     * partial sums are added in a fixed order, so the result does not depend on timing
+     * @param grain_size the smallest number of factors in one task
+     */
+    Eigen::VectorXd gradient(WorkStealingPool *pool = nullptr,
+                             std::size_t grain_size = DefaultGrainSize) const {
+        return this->reduce(
+          [this](const Factor &f, const double *, double *y) {
+              this->addTransposeProduct(f, this->residuals.data() + f.row, y);
+          },
+          nullptr,
+          pool,
+          grain_size);
+    }
+
+    /** Returns J^T J x, without forming J^T J
+     *
+     * @see gradient() for the parameters
+     */
+    Eigen::VectorXd normalProduct(const Eigen::VectorXd &x,
+                                  WorkStealingPool *pool = nullptr,
+                                  std::size_t grain_size = DefaultGrainSize) const {
+        assert(static_cast<std::size_t>(x.size()) == this->cols());
+        return this->reduce(
+          [this](const Factor &f, const double *x, double *y) {
+              // Each task has its own scratch vector for J x
+              thread_local auto v = Eigen::VectorXd{};
+              v.setZero(f.rows);
+              for (auto b = f.begin_block; b < f.end_block; ++b) {
+                  this->dispatch<false>(this->blocks[b], f.rows, x, v.data());
+              }
+              this->addTransposeProduct(f, v.data(), y);
+          },
+          x.data(),
+          pool,
+          grain_size);
+    }
+
+    /** Calls f(column, size, J_block) for each Jacobian block, with J_block a Map */
+    template <typename F>
+    void forEachBlock(F f) const {
+        for (const auto &factor : this->factors) {
+            for (auto b = factor.begin_block; b < factor.end_block; ++b) {
+                const auto &block = this->blocks[b];
+                f(block.col,
+                  block.cols,
+                  Eigen::Map<const Eigen::MatrixXd>{
+                    this->values.data() + block.data, factor.rows, block.cols});
+            }
+        }
+    }
+
+    /** Returns the size of the variable starting at each column, or 0 if none does */
+    const std::vector<Eigen::Index> &variableSizes() const noexcept {
+        return this->block_sizes;
+    }
+
+    static constexpr std::size_t DefaultGrainSize = 1024;
+
+ private:
+    struct Factor {
+        std::size_t row;
+        Eigen::Index rows;
+        std::size_t begin_block;
+        std::size_t end_block;
+    };
+
+    struct Block {
+        std::size_t col;
+        Eigen::Index cols;
+        std::size_t data;
+    };
+
+    template <typename Derived>
+    void addBlock(std::size_t col, Eigen::Index rows, const Derived &J) {
+        assert(J.rows() == rows);
+        assert(col + J.cols() <= this->cols());
+        assert((this->block_sizes[col] == 0 || this->block_sizes[col] == J.cols()) &&
+               "Variables must have the same size in every factor");
+        this->block_sizes[col] = J.cols();
+        this->blocks.push_back({col, J.cols(), this->values.size()});
+        for (Eigen::Index c = 0; c < J.cols(); ++c) {
+            for (Eigen::Index r = 0; r < rows; ++r) {
+                this->values.push_back(J(r, c));
+            }
+        }
+    }
+
+    /** Adds J^T v to y, or J y to v if not Transpose, using fixed-size kernels for
+     * 3 and 6 columns
+     */
+    template <bool Transpose>
+    void dispatch(const Block &block,
+                  Eigen::Index rows,
+                  const double *in,
+                  double *out) const {
+        const auto *data = this->values.data() + block.data;
+        const auto call = [&](auto cols) {
+            constexpr int Cols = decltype(cols)::value;
+            if (Transpose) {
+                internal::addTransposeProduct<Cols>(data, rows, block.cols, in, out);
+            } else {
+                internal::addProduct<Cols>(data, rows, block.cols, in, out);
+            }
+        };
+        if (Transpose) {
+            out += block.col;
+        } else {
+            in += block.col;
+        }
+        switch (block.cols) {
+            case 3: call(std::integral_constant<int, 3>{}); break;
+            case 6: call(std::integral_constant<int, 6>{}); break;
+            default: call(std::integral_constant<int, Eigen::Dynamic>{}); break;
+        }
+    }
+
+    void addTransposeProduct(const Factor &f, const double *v, double *y) const {
+        for (auto b = f.begin_block; b < f.end_block; ++b) {
+            this->dispatch<true>(this->blocks[b], f.rows, v, y);
+        }
+    }
+
+    /** Sums kernel(factor, x, y) over all factors into y, splitting them into tasks
+     * that each sum into their own vector
+     */
+    template <typename Kernel>
+    Eigen::VectorXd reduce(Kernel kernel,
+                           const double *x,
+                           WorkStealingPool *pool,
+                           std::size_t grain_size) const {
+        Eigen::VectorXd y = Eigen::VectorXd::Zero(this->cols());
+        // Chunk 0 adds into y, and each other chunk into its own vector
+        auto partial = std::vector<Eigen::VectorXd>(pool ? pool->size() : 1);
+        parallelChunks(
+          pool,
+          this->factors.size(),
+          grain_size,
+          [&](std::size_t c, std::size_t start, std::size_t end) {
+              double *out = y.data();
+              if (c > 0) {
+                  partial[c] = Eigen::VectorXd::Zero(this->cols());
+                  out = partial[c].data();
+              }
+              for (auto k = start; k < end; ++k) {
+                  kernel(this->factors[k], x, out);
+              }
+          });
+        for (const auto &p : partial) {
+            if (p.size() > 0) {
+                y += p;
+            }
+        }
+        return y;
+    }
+
+    std::vector<Factor> factors;
+    std::vector<Block> blocks;
+    std::vector<double> values;
+    std::vector<double> residuals;
+    std::vector<Eigen::Index> block_sizes;
+};
+
+/** The inverse of each variable's diagonal block of J^T J + damping * I
+ *
+ * Variables of 3 and 6 dimensions, such as rotations, translations and rigid transforms,
+ * use fixed-size kernels. Columns not in any Jacobian block are left unscaled.
+ */
+class BlockJacobiPreconditioner {
+ public:
+    explicit BlockJacobiPreconditioner(const BlockJacobian &J, double damping = 0) {
+        const auto &sizes = J.variableSizes();
+        auto slot = std::vector<std::size_t>(sizes.size());
+        for (std::size_t col = 0; col < sizes.size(); ++col) {
+            if (sizes[col] > 0) {
+                slot[col] = this->values.size();
+                this->blocks.push_back({col, sizes[col], this->values.size()});
+                this->values.resize(this->values.size() + sizes[col] * sizes[col]);
+            }
+        }
+        J.forEachBlock([&](std::size_t col, Eigen::Index cols, const auto &block) {
+            Eigen::Map<Eigen::MatrixXd>{this->values.data() + slot[col], cols, cols}
+              .noalias() += block.transpose() * block;
+        });
+        for (const auto &b : this->blocks) {
+            switch (b.size) {
+                case 3: this->invert<3>(b, damping); break;
+                case 6: this->invert<6>(b, damping); break;
+                default: this->invert<Eigen::Dynamic>(b, damping); break;
+            }
+        }
+    }
+
+    /** Returns M^-1 r */
+    Eigen::VectorXd apply(const Eigen::VectorXd &r) const {
+        Eigen::VectorXd z = r;
+        for (const auto &b : this->blocks) {
+            switch (b.size) {
+                case 3: this->multiply<3>(b, r, z); break;
+                case 6: this->multiply<6>(b, r, z); break;
+                default: this->multiply<Eigen::Dynamic>(b, r, z); break;
+            }
+        }
+        return z;
+    }
+
+ private:
+    struct Block {
+        std::size_t col;
+        Eigen::Index size;
+        std::size_t data;
+    };
+
+    template <int Size>
+    void invert(const Block &b, double damping) {
+        using Matrix = Eigen::Matrix<double, Size, Size>;
+        auto M = Eigen::Map<Matrix>{this->values.data() + b.data, b.size, b.size};
+        Matrix A = M;
+        A.diagonal().array() += damping;
+        const auto llt = Eigen::LLT<Matrix>{A};
+        if (llt.info() == Eigen::Success) {
+            M = llt.solve(Matrix::Identity(b.size, b.size));
+        } else {
+            // A variable with no information along some direction is left unscaled
+            M.setIdentity();
+        }
+    }
+
+    template <int Size>
+    void multiply(const Block &b, const Eigen::VectorXd &r, Eigen::VectorXd &z) const {
+        using Matrix = Eigen::Matrix<double, Size, Size>;
+        const auto *data = this->values.data() + b.data;
+        const auto M = Eigen::Map<const Matrix>{data, b.size, b.size};
+        z.segment(b.col, b.size).noalias() = M * r.segment(b.col, b.size);
+    }
+
+    std::vector<Block> blocks;
+    std::vector<double> values;
+};
+
+/** Options for solvePcg() */
+struct PcgOptions {
+    int max_iterations = 500;
+
+    /** Stop once |b - A x| <= relative_tolerance * |b|. A loose tolerance gives an
+     * inexact Newton step, which is often enough far from the solution.
+     */
+    double relative_tolerance = 1e-6;
+
+    /** Added to the diagonal of J^T J, as in Levenberg-Marquardt */
+    double damping = 0;
+
+    /** Pool to split each product over factors on. If null, the caller does all work. */
+    WorkStealingPool *pool = nullptr;
+
+    /** Smallest number of factors in one task */
+    std::size_t grain_size = BlockJacobian::DefaultGrainSize;
+};
+
+/** The result of solvePcg() */
+struct PcgResult {
+    /** The step, laid out as the stacked tangent vector */
+    Eigen::VectorXd step;
+
+    int iterations;
+
+    /** |b - A x| / |b| at the returned step */
+    double relative_residual;
+};
+
+/** Solves the normal equations for a Gauss-Newton (or Levenberg-Marquardt) step without
+ * forming them
+ *
+ * Runs the conjugate gradient method on (J^T J + damping * I) step = -J^T r, with a
+ * block-Jacobi preconditioner. Each iteration costs one pass over the factors, split
+ * across the pool if one is given.
+ *
+ * The result can be applied with boxPlus().
+ */
+inline PcgResult solvePcg(const BlockJacobian &J, const PcgOptions &options = {}) {
+    const auto A = [&](const Eigen::VectorXd &x) -> Eigen::VectorXd {
+        auto y = J.normalProduct(x, options.pool, options.grain_size);
+        if (options.damping != 0) {
+            y += options.damping * x;
+        }
+        return y;
+    };
+    const auto preconditioner = BlockJacobiPreconditioner{J, options.damping};
+
+    const Eigen::VectorXd b = -J.gradient(options.pool, options.grain_size);
+    const auto b_norm = b.norm();
+    auto result = PcgResult{Eigen::VectorXd::Zero(J.cols()), 0, 0};
+    if (b_norm == 0) {
+        return result;
+    }
+
+    Eigen::VectorXd r = b;
+    Eigen::VectorXd z = preconditioner.apply(r);
+    Eigen::VectorXd p = z;
+    auto rz = r.dot(z);
+    auto &x = result.step;
+    while (result.iterations < options.max_iterations) {
+        const Eigen::VectorXd Ap = A(p);
+        const auto alpha = rz / p.dot(Ap);
+        x += alpha * p;
+        r -= alpha * Ap;
+        ++result.iterations;
+        if (r.norm() <= options.relative_tolerance * b_norm) {
+            break;
+        }
+        z = preconditioner.apply(r);
+        const auto rz_next = r.dot(z);
+        p = z + (rz_next / rz) * p;
+        rz = rz_next;
+    }
+    result.relative_residual = r.norm() / b_norm;
+    return result;
+}
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_CONJUGATEGRADIENT_HPP
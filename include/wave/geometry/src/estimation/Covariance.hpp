@@ -0,0 +1,228 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_COVARIANCE_HPP
+#define WAVE_GEOMETRY_COVARIANCE_HPP
+
+namespace wave {
+
+namespace internal {
+
+/** Entries of the inverse of a sparse symmetric positive definite matrix, on the pattern
+ * of its sparse Cholesky factor
+ *
+ * With A permuted to P A P^T = L L^T, the entries of S = (P A P^T)^-1 on the pattern of
+ * L follow from S L = L^-T, column by column from the last (the Takahashi recursion):
+ *
+ *     S_ij = -1/L_jj sum_k L_kj S_ik                for i > j
+ *     S_jj = 1/L_jj (1/L_jj - sum_k L_kj S_kj)
+ *
+ * where k runs over the off-diagonal rows of column j of L. Those rows are ancestors of
+ * j in the elimination tree, and only entries between them are needed, so a column is
+ * computed on demand after the columns on its path to the root. The work is of the
+ * order of the factorization, and shared by all entries whose paths meet near the root.
+ *
+ * Entries are computed lazily in const member functions, so one object must not be
+ * used from several threads at once.
+ */
+class SparseInverseSubset {
+ public:
+    using Index = Eigen::Index;
+    using SparseMatrix = Eigen::SparseMatrix<double>;
+
+    /** Factorizes A, reading its lower triangle
+     *
+     * @throws std::runtime_error if A is not positive definite
+     */
+    explicit SparseInverseSubset(const SparseMatrix &A)
+        : llt{A}, computed(A.rows(), false) {
+        if (this->llt.info() != Eigen::Success) {
+            throw std::runtime_error{"The matrix must be positive definite"};
+        }
+        const auto &L = this->factor();
+        assert(L.isCompressed());
+        this->sigma.resize(L.nonZeros());
+    }
+
+    Index size() const noexcept {
+        return this->llt.rows();
+    }
+
+    /** Gets entry (r, c) of the inverse, in the original order of A, if it is on the
+     * pattern of the factor; otherwise returns false
+     */
+    bool entry(Index r, Index c, double &value) const {
+        const auto &p = this->llt.permutationP().indices();
+        const auto pr = static_cast<Index>(p[r]);
+        const auto pc = static_cast<Index>(p[c]);
+        const auto position = this->find(std::max(pr, pc), std::min(pr, pc));
+        if (position < 0) {
+            return false;
+        }
+        this->computeColumn(std::min(pr, pc));
+        value = this->sigma[position];
+        return true;
+    }
+
+    /** Gets the block of the inverse at (row, col), in the original order of A
+     *
+     * Entries off the pattern of the factor are found by solving for the block's
+     * columns of the inverse.
+     */
+    template <typename Derived>
+    void block(Index row, Index col, Eigen::MatrixBase<Derived> &out) const {
+        for (Index b = 0; b < out.cols(); ++b) {
+            for (Index a = 0; a < out.rows(); ++a) {
+                if (!this->entry(row + a, col + b, out.derived().coeffRef(a, b))) {
+                    out = this->solveColumns(col, out.cols()).middleRows(row, out.rows());
+                    return;
+                }
+            }
+        }
+    }
+
+ private:
+    const SparseMatrix &factor() const noexcept {
+        return this->llt.matrixL().nestedExpression();
+    }
+
+    /** Returns the position of (r, c) in the factor, with r >= c, or -1 */
+    Index find(Index r, Index c) const {
+        const auto &L = this->factor();
+        const auto *begin = L.innerIndexPtr() + L.outerIndexPtr()[c];
+        const auto *end = L.innerIndexPtr() + L.outerIndexPtr()[c + 1];
+        const auto *it = std::lower_bound(begin, end, r);
+        if (it == end || *it != r) {
+            return -1;
+        }
+        return it - L.innerIndexPtr();
+    }
+
+    /** Computes column j of S, after its ancestors in the elimination tree */
+    void computeColumn(Index j) const {
+        const auto &L = this->factor();
+        const auto *outer = L.outerIndexPtr();
+        const auto *inner = L.innerIndexPtr();
+        auto path = std::vector<Index>{};
+        for (auto k = j; k >= 0 && !this->computed[k];) {
+            path.push_back(k);
+            // The parent is the first off-diagonal row of the column
+            k = outer[k] + 1 < outer[k + 1] ? inner[outer[k] + 1] : -1;
+        }
+
+        const auto *value = L.valuePtr();
+        auto sums = std::vector<double>{};
+        for (auto it = path.rbegin(); it != path.rend(); ++it) {
+            const auto k = *it;
+            const auto begin = outer[k] + 1;
+            const auto end = outer[k + 1];
+            assert(inner[begin - 1] == k);
+            sums.assign(end - begin, 0.0);
+
+            // For each off-diagonal row q, walk column inner[q] of S once, merging with
+            // the rows p >= q, and use each entry S_pq for both sums it appears in
+            for (auto q = begin; q < end; ++q) {
+                auto s = outer[inner[q]];
+                for (auto p = q; p < end; ++p) {
+                    while (inner[s] < inner[p]) {
+                        ++s;
+                    }
+                    assert(inner[s] == inner[p]);
+                    sums[p - begin] += value[q] * this->sigma[s];
+                    if (p != q) {
+                        sums[q - begin] += value[p] * this->sigma[s];
+                    }
+                }
+            }
+
+            const auto d = 1 / value[begin - 1];
+            double sum = 0;
+            for (auto p = begin; p < end; ++p) {
+                this->sigma[p] = -d * sums[p - begin];
+                sum += value[p] * this->sigma[p];
+            }
+            this->sigma[begin - 1] = d * (d - sum);
+            this->computed[k] = true;
+        }
+    }
+
+    /** Returns columns [col, col + count) of the inverse, in the original order */
+    Eigen::MatrixXd solveColumns(Index col, Index count) const {
+        Eigen::MatrixXd E = Eigen::MatrixXd::Zero(this->size(), count);
+        for (Index b = 0; b < count; ++b) {
+            E(col + b, b) = 1;
+        }
+        return this->llt.solve(E);
+    }
+
+    Eigen::SimplicialLLT<SparseMatrix> llt;
+    mutable std::vector<double> sigma;
+    mutable std::vector<bool> computed;
+};
+
+}  // namespace internal
+
+/** Marginal covariances of selected variables, recovered from a sparse information matrix
+ *
+ * The information matrix (e.g. J^T J at the solution) is factorized once, and each
+ * requested block of its inverse comes from the sparse inverse subset on the pattern of
+ * the factor, without forming the dense inverse. Marginal covariances and the
+ * cross-covariances of variables sharing a factor are always on that pattern; other
+ * cross-covariances cost a sparse solve per column.
+ *
+ * The first query costs about as much as the factorization, as it computes the dense
+ * separators near the root of the elimination tree; later queries are cheap. To get the
+ * marginals of only a handful of variables of a large problem, solving for their columns
+ * of the inverse can be cheaper.
+ *
+ * The information matrix must be positive definite, so the gauge of the problem must be
+ * fixed, e.g. with a prior on one pose.
+ *
+ * @tparam Leaves the leaf types of the VariableStore the matrix is ordered by
+ */
+template <typename... Leaves>
+class MarginalCovariance {
+ public:
+    /** Factorizes the information matrix of the variables in `store`
+     *
+     * @param information symmetric, in the order of the stacked tangent vector of
+     * `store` (see VariableStore). Only its lower triangle is read.
+     * @throws std::runtime_error if the information matrix is not positive definite
+     */
+    MarginalCovariance(const VariableStore<Leaves...> &store,
+                       const Eigen::SparseMatrix<double> &information)
+        : offsets{{store.template offset<Leaves>()...}}, inverse{information} {
+        assert(static_cast<std::size_t>(information.rows()) == store.tangentSize());
+        assert(information.rows() == information.cols());
+    }
+
+    /** Returns the marginal covariance of variable i of type Leaf */
+    template <typename Leaf>
+    BlockMatrix<Leaf, Leaf> covariance(std::size_t i) const {
+        return this->template crossCovariance<Leaf, Leaf>(i, i);
+    }
+
+    /** Returns the cross-covariance of variable i of type A with variable j of type B */
+    template <typename A, typename B>
+    BlockMatrix<A, B> crossCovariance(std::size_t i, std::size_t j) const {
+        auto result = BlockMatrix<A, B>{};
+        this->inverse.block(this->tangentIndex<A>(i), this->tangentIndex<B>(j), result);
+        return result;
+    }
+
+ private:
+    template <typename Leaf>
+    Eigen::Index tangentIndex(std::size_t i) const noexcept {
+        constexpr auto k = tmp::find<tmp::type_list<Leaves...>, Leaf>::value;
+        static_assert(k >= 0, "Leaf must be one of the store's types");
+        return this->offsets[k] + i * internal::traits<Leaf>::TangentSize;
+    }
+
+    std::array<std::size_t, sizeof...(Leaves)> offsets;
+    internal::SparseInverseSubset inverse;
+};
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_COVARIANCE_HPP
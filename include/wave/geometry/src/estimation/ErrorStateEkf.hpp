@@ -0,0 +1,149 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_ERRORSTATEEKF_HPP
+#define WAVE_GEOMETRY_ERRORSTATEEKF_HPP
+
+namespace wave {
+
+namespace internal {
+
+/** Sets out = A B^T, for a product known to be symmetric
+ *
+ * Only the lower triangle is computed, and copied to the upper, so the result is
+ * exactly symmetric.
+ */
+template <typename A, typename B, typename Out>
+void symmetricProduct(const Eigen::MatrixBase<A> &a,
+                      const Eigen::MatrixBase<B> &b,
+                      Eigen::MatrixBase<Out> &out) {
+    for (Eigen::Index j = 0; j < out.cols(); ++j) {
+        for (Eigen::Index i = j; i < out.rows(); ++i) {
+            out(i, j) = out(j, i) = a.row(i).dot(b.row(j));
+        }
+    }
+}
+
+/** Adds a dense covariance to a matrix */
+template <typename Out, typename Cov>
+void addCovariance(Eigen::MatrixBase<Out> &out, const Eigen::MatrixBase<Cov> &cov) {
+    out += cov;
+}
+
+/** Adds a diagonal covariance to a matrix */
+template <typename Out, typename Cov>
+void addCovariance(Eigen::MatrixBase<Out> &out, const Eigen::DiagonalBase<Cov> &cov) {
+    out.diagonal() += cov.diagonal();
+}
+
+}  // namespace internal
+
+/** An error-state extended Kalman filter on a Lie group or compound state
+ *
+ * The state is a leaf, such as a RotationQd or RigidTransformQd, or a compound leaf of
+ * several (see CompoundLeafStorage). Its covariance is a BlockMatrix over the state's
+ * tangent space, and corrections are applied with box-plus, so the state stays on its
+ * manifold.
+ *
+ * The process and measurement models are functions returning a wave expression of the
+ * state. Each step evaluates the expression once, getting its value and its Jacobian
+ * (see evalWithJacobians()). All matrices have sizes fixed at compile time; products
+ * known to be symmetric are computed on one triangle, and the covariance is kept exactly
+ * symmetric.
+ *
+ * @tparam State the leaf type of the state
+ */
+template <typename State>
+class ErrorStateEkf {
+ public:
+    using Covariance = BlockMatrix<State, State>;
+    using Tangent = internal::plain_tangent_t<State>;
+    enum : int { Size = internal::traits<State>::TangentSize };
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    /** Starts from the given state and covariance */
+    ErrorStateEkf(const State &state, const Covariance &covariance)
+        : x{state}, P{covariance} {}
+
+    const State &state() const noexcept {
+        return this->x;
+    }
+
+    const Covariance &covariance() const noexcept {
+        return this->P;
+    }
+
+    /** Propagates the state through a process model
+     *
+     * The covariance becomes F P F^T + Q, where F is the Jacobian of the model.
+     *
+     * @param f function taking the state and returning an expression of it, such as a
+     * lambda capturing a measured angular rate
+     * @param process_noise noise model over the state's tangent space, with a
+     * covariance()
+     */
+    template <typename F, typename Noise>
+    void predict(F &&f, const Noise &process_noise) {
+        const auto [value, F_x] = f(this->x).evalWithJacobians(this->x);
+        const Covariance FP = F_x * this->P;
+        internal::symmetricProduct(FP, F_x, this->P);
+        internal::addCovariance(this->P, process_noise.covariance());
+        this->x = State{value};
+    }
+
+    /** Corrects the state with a measurement
+     *
+     * The residual r = h(x) - z and its Jacobian H give the gain K = P H^T S^-1, with S =
+     * H P H^T + R. The state is corrected by box-plus of -K r, and the covariance by the
+     * Joseph form (I - K H) P (I - K H)^T + K R K^T, which stays positive definite with
+     * rounding errors.
+     *
+     * @param h function taking the state and returning an expression of the measured
+     * quantity
+     * @param z the measurement, in the same space as h
+     * @return the normalized innovation squared, r^T S^-1 r, for gating outliers
+     */
+    template <typename H, typename Measurement, template <typename> class NoiseModel>
+    double update(H &&h, const Uncertain<Measurement, NoiseModel> &z) {
+        using Residual = BlockVector<Measurement>;
+        using Jacobian = BlockMatrix<Measurement, State>;
+        using Gain = BlockMatrix<State, Measurement>;
+        using Innovation = BlockMatrix<Measurement, Measurement>;
+
+        const auto [value, jacobian] = h(this->x).evalWithJacobians(this->x);
+        const Residual r{valueAsVector(internal::adl{}, eval(value - z.value))};
+        const Jacobian H_x{jacobian};
+        const auto &R = z.noise.covariance();
+
+        const Jacobian HP = H_x * this->P;
+        Innovation S;
+        internal::symmetricProduct(HP, H_x, S);
+        internal::addCovariance(S, R);
+        const auto llt = Eigen::LLT<typename Innovation::Base>{S};
+
+        // K = P H^T S^-1, found as (S^-1 H P)^T as P and S are symmetric
+        const Gain K = llt.solve(HP).transpose();
+        Covariance A = -K * H_x;
+        A.diagonal().array() += 1;
+        const Covariance AP = A * this->P;
+        const Gain KR = K * R;
+        Covariance noise_term;
+        internal::symmetricProduct(AP, A, this->P);
+        internal::symmetricProduct(KR, K, noise_term);
+        this->P += noise_term;
+
+        const BlockVector<State> dx = -K * r;
+        this->x = State{this->x + internal::makeTangent<Tangent>(dx)};
+        return r.dot(llt.solve(r));
+    }
+
+ private:
+    State x;
+    Covariance P;
+};
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_ERRORSTATEEKF_HPP
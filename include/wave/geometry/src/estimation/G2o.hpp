@@ -0,0 +1,364 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_G2O_PARSE_HPP
+#define WAVE_GEOMETRY_G2O_PARSE_HPP
+
+namespace wave {
+
+/** Measurement function of a relative pose edge: the log map of T_i^-1 * T_j */
+struct RelativePoseFunctor {
+    template <typename T, typename U>
+    auto operator()(const RigidTransformBase<T> &a,
+                    const RigidTransformBase<U> &b) const {
+        return log(inverse(a.derived()) * b.derived());
+    }
+};
+
+/** Options for loading g2o files */
+struct G2oOptions {
+    /** Information given to the out-of-plane components (z, roll and pitch) of 2D
+     * edges, which g2o does not store */
+    double planar_information = 1e6;
+};
+
+/** A pose graph read from a g2o file
+ *
+ * 2D vertices and edges (VERTEX_SE2, EDGE_SE2) are read as 3D poses in the plane z = 0.
+ */
+struct G2oPoseGraph {
+    using Pose = RigidTransformMd;
+    using Measurement = Uncertain<Twistd, FullNoise>;
+    using PoseFactor = Factor<RelativePoseFunctor, Measurement, Pose, Pose>;
+    using Variables =
+      std::vector<FactorVariable<Pose>, Eigen::aligned_allocator<FactorVariable<Pose>>>;
+
+    /** Vertex ids from the file, in the order of the variables */
+    std::vector<long> ids;
+
+    /** The variables, in one block. The factors share ownership of the whole block. */
+    std::shared_ptr<Variables> variables;
+
+    /** A factor for each edge, in file order */
+    std::vector<PoseFactor, Eigen::aligned_allocator<PoseFactor>> factors;
+
+    /** The measured transform of each edge, with the indices of its variables */
+    std::vector<RelativePoseMeasurement<Pose>> measurements;
+
+    /** Returns the variable with the given index */
+    const Pose &pose(std::size_t i) const {
+        return (*this->variables)[i].value();
+    }
+};
+
+namespace internal {
+
+/** Reads whitespace-separated tokens and numbers from one line of a buffer at a time */
+class G2oReader {
+ public:
+    G2oReader(const char *begin, const char *end) : pos{begin}, end{end} {}
+
+    /** Moves to the next non-empty line, returning false at the end of input */
+    bool nextLine() {
+        // Skip the rest of the current line
+        this->pos = std::find(this->pos, this->end, '\n');
+        while (this->pos != this->end) {
+            ++this->pos;
+            ++this->line;
+            this->skipSpaces();
+            if (this->pos != this->end && *this->pos != '\n' && *this->pos != '\r') {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** Moves to the first non-empty line, returning false if there is none */
+    bool firstLine() {
+        this->skipSpaces();
+        if (this->pos != this->end && *this->pos != '\n' && *this->pos != '\r') {
+            return true;
+        }
+        return this->nextLine();
+    }
+
+    /** Returns the next token on the line */
+    std::pair<const char *, const char *> token() {
+        this->skipSpaces();
+        const auto *start = this->pos;
+        while (this->pos != this->end &&
+               !std::isspace(static_cast<unsigned char>(*this->pos))) {
+            ++this->pos;
+        }
+        return {start, this->pos};
+    }
+
+    /** Returns the number of the current line, from 1 */
+    std::size_t lineNumber() const noexcept {
+        return this->line;
+    }
+
+    /** Reads the next number on the line, throwing if there is none */
+    template <typename T>
+    T number() {
+        this->skipSpaces();
+        T value;
+        const auto result = std::from_chars(this->pos, this->end, value);
+        if (result.ec != std::errc{}) {
+            throw std::runtime_error{"g2o: expected a number on line " +
+                                     std::to_string(this->line)};
+        }
+        this->pos = result.ptr;
+        return value;
+    }
+
+ private:
+    void skipSpaces() {
+        while (this->pos != this->end && (*this->pos == ' ' || *this->pos == '\t')) {
+            ++this->pos;
+        }
+    }
+
+    const char *pos;
+    const char *end;
+    std::size_t line = 1;
+};
+
+inline bool tokenIs(std::pair<const char *, const char *> token, const char *tag) {
+    const auto n = std::strlen(tag);
+    return static_cast<std::size_t>(token.second - token.first) == n &&
+           std::equal(token.first, token.second, tag);
+}
+
+/** Reads the upper triangle of a symmetric matrix, row by row */
+template <int N>
+Eigen::Matrix<double, N, N> readUpperTriangle(G2oReader &reader) {
+    Eigen::Matrix<double, N, N> m;
+    for (int r = 0; r < N; ++r) {
+        for (int c = r; c < N; ++c) {
+            m(r, c) = m(c, r) = reader.number<double>();
+        }
+    }
+    return m;
+}
+
+/** Converts a g2o SE3 information matrix to the information of a Twist
+ *
+ * g2o orders the error as (translation, quaternion vector part). The vector part is
+ * about half the rotation angle, so its rows are halved; then rotation comes first.
+ */
+inline Eigen::Matrix<double, 6, 6> twistInformation(
+  const Eigen::Matrix<double, 6, 6> &g2o) {
+    Eigen::Matrix<double, 6, 6> J = Eigen::Matrix<double, 6, 6>::Zero();
+    J.block<3, 3>(0, 3) = Eigen::Matrix3d::Identity();
+    J.block<3, 3>(3, 0) = 0.5 * Eigen::Matrix3d::Identity();
+    return J.transpose() * g2o * J;
+}
+
+/** Converts a g2o SE2 information matrix of (x, y, theta) to that of a planar Twist */
+inline Eigen::Matrix<double, 6, 6> planarTwistInformation(const Eigen::Matrix3d &g2o,
+                                                          double planar_information) {
+    // Indices of x, y, theta in the Twist
+    const int index[3] = {3, 4, 2};
+    Eigen::Matrix<double, 6, 6> info = Eigen::Matrix<double, 6, 6>::Zero();
+    info(0, 0) = info(1, 1) = info(5, 5) = planar_information;
+    for (int r = 0; r < 3; ++r) {
+        for (int c = 0; c < 3; ++c) {
+            info(index[r], index[c]) = g2o(r, c);
+        }
+    }
+    return info;
+}
+
+inline RigidTransformMd planarPose(double x, double y, double theta) {
+    return RigidTransformMd{Eigen::AngleAxisd{theta, Eigen::Vector3d::UnitZ()},
+                            Eigen::Vector3d{x, y, 0}};
+}
+
+/** Converts a TORO 3D information matrix of (x, y, z, roll, pitch, yaw) to that of a
+ * Twist
+ *
+ * For small angles, (roll, pitch, yaw) is the rotation vector, so only the rotation and
+ * translation blocks are swapped.
+ */
+inline Eigen::Matrix<double, 6, 6> eulerTwistInformation(
+  const Eigen::Matrix<double, 6, 6> &toro) {
+    Eigen::Matrix<double, 6, 6> J = Eigen::Matrix<double, 6, 6>::Zero();
+    J.block<3, 3>(0, 3) = Eigen::Matrix3d::Identity();
+    J.block<3, 3>(3, 0) = Eigen::Matrix3d::Identity();
+    return J.transpose() * toro * J;
+}
+
+/** Makes a pose from a translation and roll, pitch and yaw, applied in that order */
+inline RigidTransformMd eulerPose(const double (&v)[6]) {
+    const auto R = Eigen::AngleAxisd{v[5], Eigen::Vector3d::UnitZ()} *
+                   Eigen::AngleAxisd{v[4], Eigen::Vector3d::UnitY()} *
+                   Eigen::AngleAxisd{v[3], Eigen::Vector3d::UnitX()};
+    return RigidTransformMd{Eigen::Matrix3d{R}, Eigen::Vector3d{v[0], v[1], v[2]}};
+}
+
+/** Reads the information matrix of an EDGE2 line, in TORO order: I11 I12 I22 I33 I13
+ * I23 */
+inline Eigen::Matrix3d readToroInformation2(G2oReader &reader) {
+    Eigen::Matrix3d m;
+    m(0, 0) = reader.number<double>();
+    m(0, 1) = m(1, 0) = reader.number<double>();
+    m(1, 1) = reader.number<double>();
+    m(2, 2) = reader.number<double>();
+    m(0, 2) = m(2, 0) = reader.number<double>();
+    m(1, 2) = m(2, 1) = reader.number<double>();
+    return m;
+}
+
+}  // namespace internal
+
+/** Reads a pose graph from g2o text in memory
+ *
+ * Reads VERTEX_SE3:QUAT, EDGE_SE3:QUAT, VERTEX_SE2 and EDGE_SE2 lines, as well as the
+ * TORO lines VERTEX2, EDGE2, VERTEX3 and EDGE3. Comments (#) and FIX lines are ignored.
+ * Each edge becomes a Factor with FullNoise, whose covariance is the inverse of the
+ * information matrix converted to Twist coordinates.
+ *
+ * @throws std::runtime_error if a line is malformed or of an unknown type, a vertex id
+ * is repeated, or an edge refers to a missing vertex
+ */
+inline G2oPoseGraph parseG2o(const char *begin,
+                             const char *end,
+                             const G2oOptions &options = {}) {
+    using Pose = G2oPoseGraph::Pose;
+    struct Edge {
+        long from;
+        long to;
+        Pose transform;
+        Eigen::Matrix<double, 6, 6> information;
+    };
+
+    // Read plain records first, since edges may come before their vertices
+    auto poses = std::vector<Pose, Eigen::aligned_allocator<Pose>>{};
+    auto edges = std::vector<Edge, Eigen::aligned_allocator<Edge>>{};
+    auto graph = G2oPoseGraph{};
+
+    auto reader = internal::G2oReader{begin, end};
+    for (bool more = reader.firstLine(); more; more = reader.nextLine()) {
+        const auto tag = reader.token();
+        if (internal::tokenIs(tag, "VERTEX_SE3:QUAT")) {
+            graph.ids.push_back(reader.number<long>());
+            double v[7];
+            for (auto &x : v) {
+                x = reader.number<double>();
+            }
+            poses.emplace_back(Eigen::Quaterniond{v[6], v[3], v[4], v[5]}.normalized(),
+                               Eigen::Vector3d{v[0], v[1], v[2]});
+        } else if (internal::tokenIs(tag, "EDGE_SE3:QUAT")) {
+            const auto from = reader.number<long>();
+            const auto to = reader.number<long>();
+            double v[7];
+            for (auto &x : v) {
+                x = reader.number<double>();
+            }
+            const auto information = internal::readUpperTriangle<6>(reader);
+            const auto q = Eigen::Quaterniond{v[6], v[3], v[4], v[5]}.normalized();
+            edges.push_back({from,
+                             to,
+                             Pose{q, Eigen::Vector3d{v[0], v[1], v[2]}},
+                             internal::twistInformation(information)});
+        } else if (internal::tokenIs(tag, "VERTEX_SE2")) {
+            graph.ids.push_back(reader.number<long>());
+            const auto x = reader.number<double>();
+            const auto y = reader.number<double>();
+            poses.push_back(internal::planarPose(x, y, reader.number<double>()));
+        } else if (internal::tokenIs(tag, "EDGE_SE2")) {
+            const auto from = reader.number<long>();
+            const auto to = reader.number<long>();
+            const auto x = reader.number<double>();
+            const auto y = reader.number<double>();
+            const auto theta = reader.number<double>();
+            const auto information = internal::planarTwistInformation(
+              internal::readUpperTriangle<3>(reader), options.planar_information);
+            edges.push_back({from, to, internal::planarPose(x, y, theta), information});
+        } else if (internal::tokenIs(tag, "VERTEX2")) {
+            graph.ids.push_back(reader.number<long>());
+            const auto x = reader.number<double>();
+            const auto y = reader.number<double>();
+            poses.push_back(internal::planarPose(x, y, reader.number<double>()));
+        } else if (internal::tokenIs(tag, "EDGE2")) {
+            const auto from = reader.number<long>();
+            const auto to = reader.number<long>();
+            const auto x = reader.number<double>();
+            const auto y = reader.number<double>();
+            const auto theta = reader.number<double>();
+            const auto information = internal::planarTwistInformation(
+              internal::readToroInformation2(reader), options.planar_information);
+            edges.push_back({from, to, internal::planarPose(x, y, theta), information});
+        } else if (internal::tokenIs(tag, "VERTEX3")) {
+            graph.ids.push_back(reader.number<long>());
+            double v[6];
+            for (auto &x : v) {
+                x = reader.number<double>();
+            }
+            poses.push_back(internal::eulerPose(v));
+        } else if (internal::tokenIs(tag, "EDGE3")) {
+            const auto from = reader.number<long>();
+            const auto to = reader.number<long>();
+            double v[6];
+            for (auto &x : v) {
+                x = reader.number<double>();
+            }
+            const auto information = internal::readUpperTriangle<6>(reader);
+            edges.push_back({from,
+                             to,
+                             internal::eulerPose(v),
+                             internal::eulerTwistInformation(information)});
+        } else if (*tag.first != '#' && !internal::tokenIs(tag, "FIX")) {
+            throw std::runtime_error{"g2o: unknown type " +
+                                     std::string{tag.first, tag.second} + " on line " +
+                                     std::to_string(reader.lineNumber())};
+        }
+    }
+
+    // The variables are created in one block, and never move
+    const auto n = poses.size();
+    graph.variables = std::make_shared<G2oPoseGraph::Variables>(n);
+    auto index = std::unordered_map<long, std::size_t>{};
+    index.reserve(n);
+    for (std::size_t i = 0; i < n; ++i) {
+        (*graph.variables)[i].value() = poses[i];
+        if (!index.emplace(graph.ids[i], i).second) {
+            throw std::runtime_error{"g2o: repeated vertex " +
+                                     std::to_string(graph.ids[i])};
+        }
+    }
+    const auto variable = [&](long id) {
+        const auto it = index.find(id);
+        if (it == index.end()) {
+            throw std::runtime_error{"g2o: edge refers to missing vertex " +
+                                     std::to_string(id)};
+        }
+        return it->second;
+    };
+
+    graph.factors.reserve(edges.size());
+    graph.measurements.reserve(edges.size());
+    for (const auto &e : edges) {
+        const auto i = variable(e.from);
+        const auto j = variable(e.to);
+        // Aliasing pointers share ownership of the whole block
+        auto var_i =
+          std::shared_ptr<FactorVariable<Pose>>{graph.variables, &(*graph.variables)[i]};
+        auto var_j =
+          std::shared_ptr<FactorVariable<Pose>>{graph.variables, &(*graph.variables)[j]};
+        const auto z = Twistd{log(e.transform)};
+        const Eigen::Matrix<double, 6, 6> covariance = e.information.inverse();
+        graph.factors.emplace_back(
+          G2oPoseGraph::Measurement{z, FullNoise<Twistd>::FromCovariance(covariance)},
+          std::move(var_i),
+          std::move(var_j));
+        graph.measurements.push_back({i, j, e.transform});
+    }
+    return graph;
+}
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_G2O_PARSE_HPP
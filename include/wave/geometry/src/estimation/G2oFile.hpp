@@ -0,0 +1,92 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_G2OFILE_HPP
+#define WAVE_GEOMETRY_G2OFILE_HPP
+
+namespace wave {
+namespace internal {
+
+/** A read-only view of a whole file, memory-mapped where possible */
+class MappedFile {
+ public:
+    explicit MappedFile(const std::string &path) {
+#if defined(__unix__) || defined(__APPLE__)
+        const int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw std::runtime_error{"Cannot open " + path};
+        }
+        struct stat st;
+        if (::fstat(fd, &st) != 0) {
+            ::close(fd);
+            throw std::runtime_error{"Cannot read " + path};
+        }
+        this->length = static_cast<std::size_t>(st.st_size);
+        if (this->length > 0) {
+            void *p = ::mmap(nullptr, this->length, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (p == MAP_FAILED) {
+                ::close(fd);
+                throw std::runtime_error{"Cannot map " + path};
+            }
+            ::madvise(p, this->length, MADV_SEQUENTIAL);
+            this->mapped = static_cast<const char *>(p);
+        }
+        ::close(fd);
+#else
+        auto file = std::ifstream{path, std::ios::binary};
+        if (!file) {
+            throw std::runtime_error{"Cannot open " + path};
+        }
+        this->buffer.assign(std::istreambuf_iterator<char>{file}, {});
+        this->length = this->buffer.size();
+#endif
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile() {
+#if defined(__unix__) || defined(__APPLE__)
+        if (this->mapped) {
+            ::munmap(const_cast<char *>(this->mapped), this->length);
+        }
+#endif
+    }
+
+    const char *begin() const noexcept {
+#if defined(__unix__) || defined(__APPLE__)
+        return this->mapped;
+#else
+        return this->buffer.data();
+#endif
+    }
+
+    const char *end() const noexcept {
+        return this->begin() + this->length;
+    }
+
+ private:
+#if defined(__unix__) || defined(__APPLE__)
+    const char *mapped = nullptr;
+#else
+    std::vector<char> buffer;
+#endif
+    std::size_t length = 0;
+};
+
+}  // namespace internal
+
+/** Reads a pose graph from a g2o file, which is memory-mapped where possible
+ *
+ * @see parseG2o()
+ * @throws std::runtime_error if the file cannot be read or is malformed
+ */
+inline G2oPoseGraph loadG2o(const std::string &path, const G2oOptions &options = {}) {
+    const auto file = internal::MappedFile{path};
+    return parseG2o(file.begin(), file.end(), options);
+}
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_G2OFILE_HPP
@@ -0,0 +1,189 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_LINEARIZATIONCACHE_HPP
+#define WAVE_GEOMETRY_LINEARIZATIONCACHE_HPP
+
+namespace wave {
+
+/** Memoizes subexpressions shared by many factors within one linearization
+ *
+ * Many factors often contain the same subexpression, such as `T_world_body * T_body_cam`
+ * for every landmark seen from one keyframe. evaluate() returns the value of a
+ * subexpression together with its Jacobians with respect to the given leaves, and
+ * evaluates it only the first time it is asked for in a pass. Each factor then uses the
+ * cached value as a leaf and chains its own Jacobian with the cached ones.
+ *
+ * An entry is keyed on the expression type (its structure), the addresses of all its
+ * leaves in order, the Jacobian targets, and the versions of the leaves. Every leaf has
+ * a new version after nextPass(), or after touch() for just that leaf, so stale entries
+ * are re-evaluated on their next use. An expression holding a leaf or scalar by value
+ * (such as `T * 2.0`) has no stable key, and is evaluated on every call.
+ *
+ * Since leaves are identified by address, every leaf must outlive each pass it is used
+ * in. A leaf destroyed during a pass, and another made at the same address, would be
+ * taken for the same leaf; call touch() on the new one before using it.
+ *
+ * evaluate() may be called from several threads at once. The lock is not held while
+ * evaluating, and results are returned by value.
+ */
+class LinearizationCache {
+ public:
+    /** Starts a new linearization, in which all leaves are assumed to have changed */
+    void nextPass() {
+        std::lock_guard<std::mutex> lock{this->mutex};
+        this->pass_version = ++this->clock;
+        // Every leaf is now at the pass version
+        this->leaf_versions.clear();
+    }
+
+    /** Marks one leaf as changed since the last pass */
+    template <typename Derived>
+    void touch(const ExpressionBase<Derived> &leaf) {
+        std::lock_guard<std::mutex> lock{this->mutex};
+        this->leaf_versions[&leaf.derived()] = ++this->clock;
+    }
+
+    /** Returns the value of expr and its Jacobians with respect to leaves
+     *
+     * The expression is evaluated, using evalWithJacobians(leaves...), only if there is
+     * no entry for the same expression and leaves at their current versions. If two
+     * threads ask for a missing entry at once, both evaluate it.
+     *
+     * @return a tuple of the value and the Jacobians, in the order of leaves
+     */
+    template <typename Derived, typename... Leaves>
+    auto evaluate(const ExpressionBase<Derived> &expr, const Leaves &... leaves)
+      -> std::tuple<internal::plain_output_t<Derived>,
+                    internal::jacobian_t<Derived, Leaves>...> {
+        using Result = std::tuple<internal::plain_output_t<Derived>,
+                                  internal::jacobian_t<Derived, Leaves>...>;
+        static_assert(sizeof...(Leaves) > 0, "At least one leaf is required");
+
+        auto key = Key{typeid(std::tuple<Derived, Leaves...>), {}};
+        if (!leafAddresses(expr.derived(), key.leaves)) {
+            {
+                std::lock_guard<std::mutex> lock{this->mutex};
+                ++this->evaluation_count;
+            }
+            return expr.derived().evalWithJacobians(leaves...);
+        }
+        key.leaves.insert(key.leaves.end(), {static_cast<const void *>(&leaves)...});
+
+        auto versions = std::vector<std::uint64_t>{};
+        {
+            std::lock_guard<std::mutex> lock{this->mutex};
+            for (const auto *leaf : key.leaves) {
+                versions.push_back(this->versionOf(leaf));
+            }
+            const auto it = this->entries.find(key);
+            if (it != this->entries.end() && it->second->versions == versions) {
+                return static_cast<const EntryHolder<Result> &>(*it->second).result;
+            }
+            ++this->evaluation_count;
+        }
+
+        auto entry = std::make_shared<EntryHolder<Result>>(
+          expr.derived().evalWithJacobians(leaves...));
+        entry->versions = std::move(versions);
+        {
+            std::lock_guard<std::mutex> lock{this->mutex};
+            this->entries[std::move(key)] = entry;
+        }
+        return entry->result;
+    }
+
+    /** Discards all entries */
+    void clear() {
+        std::lock_guard<std::mutex> lock{this->mutex};
+        this->entries.clear();
+        this->leaf_versions.clear();
+    }
+
+    /** Returns the number of entries */
+    std::size_t size() const {
+        std::lock_guard<std::mutex> lock{this->mutex};
+        return this->entries.size();
+    }
+
+    /** Returns the number of times a subexpression was evaluated (not found in cache) */
+    std::size_t evaluations() const {
+        std::lock_guard<std::mutex> lock{this->mutex};
+        return this->evaluation_count;
+    }
+
+ private:
+    struct Key {
+        std::type_index type;
+        std::vector<const void *> leaves;
+
+        bool operator==(const Key &other) const {
+            return this->type == other.type && this->leaves == other.leaves;
+        }
+    };
+
+    struct KeyHash {
+        std::size_t operator()(const Key &key) const noexcept {
+            auto seed = key.type.hash_code();
+            for (const auto *leaf : key.leaves) {
+                boost::hash_combine(seed, leaf);
+            }
+            return seed;
+        }
+    };
+
+    struct Entry {
+        virtual ~Entry() = default;
+        std::vector<std::uint64_t> versions;
+    };
+
+    template <typename Result>
+    struct EntryHolder final : Entry {
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+        explicit EntryHolder(Result &&result) : result{std::move(result)} {}
+
+        Result result;
+    };
+
+    /** Appends the addresses of the leaves of expr, in order
+     *
+     * @return false if a leaf is held by value in expr, so its address is not stable
+     */
+    template <typename Derived>
+    static bool leafAddresses(const Derived &expr, std::vector<const void *> &out) {
+        auto vec = internal::DynamicLeavesVec{};
+        getLeaves(internal::adl{}, vec, expr);
+        const auto *begin = reinterpret_cast<const char *>(&expr);
+        const auto *end = begin + sizeof(Derived);
+        for (const auto &leaf : vec) {
+            const auto *address = static_cast<const char *>(leaf.first);
+            if (!std::less<>{}(address, begin) && std::less<>{}(address, end)) {
+                return false;
+            }
+            out.push_back(leaf.first);
+        }
+        return true;
+    }
+
+    /** Current version of a leaf. Call with the mutex held. */
+    std::uint64_t versionOf(const void *leaf) const {
+        const auto it = this->leaf_versions.find(leaf);
+        if (it == this->leaf_versions.end()) {
+            return this->pass_version;
+        }
+        return std::max(it->second, this->pass_version);
+    }
+
+    mutable std::mutex mutex;
+    std::unordered_map<Key, std::shared_ptr<const Entry>, KeyHash> entries;
+    std::unordered_map<const void *, std::uint64_t> leaf_versions;
+    std::uint64_t clock = 0;
+    std::uint64_t pass_version = 0;
+    std::size_t evaluation_count = 0;
+};
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_LINEARIZATIONCACHE_HPP
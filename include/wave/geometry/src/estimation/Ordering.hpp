@@ -0,0 +1,291 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_ORDERING_HPP
+#define WAVE_GEOMETRY_ORDERING_HPP
+
+namespace wave {
+
+/** Sparsity pattern of a least-squares problem, at the level of whole variables
+ *
+ * Variables are numbered from 0. Each factor connects every pair of the variables it
+ * uses, as in the block pattern of the normal equations.
+ */
+class VariableGraph {
+ public:
+    explicit VariableGraph(std::size_t num_variables) : adjacency(num_variables) {}
+
+    /** Connects all the given variables to each other */
+    void addFactor(const std::vector<std::size_t> &variables) {
+        for (const auto a : variables) {
+            assert(a < this->adjacency.size());
+            for (const auto b : variables) {
+                if (a != b) {
+                    this->adjacency[a].push_back(b);
+                }
+            }
+        }
+        this->sorted = false;
+    }
+
+    /** Returns the number of variables */
+    std::size_t size() const noexcept {
+        return this->adjacency.size();
+    }
+
+    /** Returns the neighbours of a variable, sorted and without duplicates */
+    const std::vector<std::size_t> &neighbours(std::size_t v) const {
+        this->sort();
+        return this->adjacency[v];
+    }
+
+ private:
+    void sort() const {
+        if (this->sorted) {
+            return;
+        }
+        for (auto &list : this->adjacency) {
+            std::sort(list.begin(), list.end());
+            list.erase(std::unique(list.begin(), list.end()), list.end());
+        }
+        this->sorted = true;
+    }
+
+    mutable std::vector<std::vector<std::size_t>> adjacency;
+    mutable bool sorted = true;
+};
+
+/** Returns a fill-reducing elimination ordering, by minimum degree
+ *
+ * Variables are eliminated one at a time, each time choosing a variable with the fewest
+ * neighbours in the graph left by the previous eliminations. This is the greedy rule
+ * approximated by AMD and COLAMD, here with exact degrees.
+ *
+ * Constraint groups give a constrained ordering, as CCOLAMD does: all variables of a
+ * lower group come before any of a higher group. For a sliding window, putting the
+ * newest variables in the highest group keeps them last, so they can be marginalized or
+ * relinearized without reordering the rest.
+ *
+ * @param groups constraint group of each variable, or empty for no constraints
+ * @return the variables in elimination order
+ */
+inline std::vector<std::size_t> minimumDegreeOrdering(
+  const VariableGraph &graph, const std::vector<int> &groups = {}) {
+    const auto n = graph.size();
+    assert(groups.empty() || groups.size() == n);
+    const auto group = [&groups](std::size_t v) {
+        return groups.empty() ? 0 : groups[v];
+    };
+
+    // The elimination graph, and the remaining variables by (group, degree)
+    auto adjacency = std::vector<std::vector<std::size_t>>(n);
+    auto queue = std::set<std::tuple<int, std::size_t, std::size_t>>{};
+    for (std::size_t v = 0; v < n; ++v) {
+        adjacency[v] = graph.neighbours(v);
+        queue.emplace(group(v), adjacency[v].size(), v);
+    }
+
+    auto ordering = std::vector<std::size_t>{};
+    ordering.reserve(n);
+    auto merged = std::vector<std::size_t>{};
+    while (!queue.empty()) {
+        const auto v = std::get<2>(*queue.begin());
+        queue.erase(queue.begin());
+        ordering.push_back(v);
+
+        // The neighbours of v become a clique
+        const auto clique = std::move(adjacency[v]);
+        for (const auto u : clique) {
+            queue.erase({group(u), adjacency[u].size(), u});
+            merged.clear();
+            std::set_union(adjacency[u].begin(),
+                           adjacency[u].end(),
+                           clique.begin(),
+                           clique.end(),
+                           std::back_inserter(merged));
+            const auto is_eliminated_or_u = [u, v](std::size_t w) {
+                return w == u || w == v;
+            };
+            merged.erase(std::remove_if(merged.begin(), merged.end(), is_eliminated_or_u),
+                         merged.end());
+            adjacency[u].swap(merged);
+            queue.emplace(group(u), adjacency[u].size(), u);
+        }
+    }
+    return ordering;
+}
+
+/** Returns a bandwidth-reducing ordering, by reverse Cuthill-McKee
+ *
+ * Each connected component is visited breadth-first from a pseudo-peripheral variable,
+ * taking the neighbours of each variable by increasing degree, and the whole order is
+ * reversed. Variables connected by a factor end up close together, so the ordering suits
+ * laying out memory for locality (see relayout()), though it usually gives more Cholesky
+ * fill than minimumDegreeOrdering().
+ *
+ * @return the variables in order
+ */
+inline std::vector<std::size_t> reverseCuthillMcKeeOrdering(const VariableGraph &graph) {
+    const auto n = graph.size();
+    const auto degree = [&graph](std::size_t v) { return graph.neighbours(v).size(); };
+    auto level = std::vector<std::size_t>(n);
+    auto ordering = std::vector<std::size_t>{};
+    ordering.reserve(n);
+    auto visited = std::vector<bool>(n, false);
+    auto neighbours = std::vector<std::size_t>{};
+
+    const auto by_degree = [&](std::size_t a, std::size_t b) {
+        return degree(a) < degree(b);
+    };
+
+    // Appends the breadth-first order of the component of start to ordering
+    const auto visit = [&](std::size_t start, bool sort_neighbours) {
+        const auto first = ordering.size();
+        ordering.push_back(start);
+        visited[start] = true;
+        level[start] = 0;
+        for (auto i = first; i < ordering.size(); ++i) {
+            const auto v = ordering[i];
+            neighbours.clear();
+            for (const auto u : graph.neighbours(v)) {
+                if (!visited[u]) {
+                    visited[u] = true;
+                    level[u] = level[v] + 1;
+                    neighbours.push_back(u);
+                }
+            }
+            if (sort_neighbours) {
+                std::stable_sort(neighbours.begin(), neighbours.end(), by_degree);
+            }
+            ordering.insert(ordering.end(), neighbours.begin(), neighbours.end());
+        }
+        return first;
+    };
+    // Unvisits the component appended to ordering from first
+    const auto undo = [&](std::size_t first) {
+        for (auto i = first; i < ordering.size(); ++i) {
+            visited[ordering[i]] = false;
+        }
+        ordering.resize(first);
+    };
+
+    for (std::size_t v = 0; v < n; ++v) {
+        if (visited[v]) {
+            continue;
+        }
+        // Move to a variable of least degree in the last level, while that deepens the
+        // search
+        auto start = v;
+        auto first = visit(start, false);
+        auto depth = level[ordering.back()];
+        while (true) {
+            auto next = ordering.back();
+            for (auto i = first; i < ordering.size(); ++i) {
+                const auto u = ordering[i];
+                if (level[u] == depth && degree(u) < degree(next)) {
+                    next = u;
+                }
+            }
+            undo(first);
+            first = visit(next, false);
+            if (level[ordering.back()] <= depth) {
+                break;
+            }
+            start = next;
+            depth = level[ordering.back()];
+        }
+        undo(first);
+        visit(start, true);
+    }
+    std::reverse(ordering.begin(), ordering.end());
+    return ordering;
+}
+
+/** Returns the number of off-diagonal blocks in the Cholesky factor for an ordering
+ *
+ * This counts the blocks of the normal equations plus the fill-in, by symbolic
+ * factorization along the elimination tree.
+ *
+ * @param ordering the variables in elimination order
+ */
+inline std::size_t choleskyFill(const VariableGraph &graph,
+                                const std::vector<std::size_t> &ordering) {
+    const auto n = graph.size();
+    assert(ordering.size() == n);
+    auto position = std::vector<std::size_t>(n);
+    for (std::size_t k = 0; k < n; ++k) {
+        position[ordering[k]] = k;
+    }
+
+    // The structure of each column of L is its own pattern below the diagonal, plus the
+    // structure of its children in the elimination tree
+    auto pending = std::vector<std::vector<std::size_t>>(n);
+    std::size_t fill = 0;
+    for (std::size_t k = 0; k < n; ++k) {
+        auto column = std::move(pending[k]);
+        for (const auto u : graph.neighbours(ordering[k])) {
+            if (position[u] > k) {
+                column.push_back(position[u]);
+            }
+        }
+        std::sort(column.begin(), column.end());
+        column.erase(std::unique(column.begin(), column.end()), column.end());
+        fill += column.size();
+        if (!column.empty()) {
+            // The parent is the first entry; pass it the rest
+            auto &parent = pending[column.front()];
+            parent.insert(parent.end(), column.begin() + 1, column.end());
+        }
+    }
+    return fill;
+}
+
+/** Reorders the variables of each type in a store by their place in an ordering
+ *
+ * Afterwards, the variables of each type are stored in the order they appear in
+ * `ordering`, so factors on variables close in the ordering read memory close together.
+ * Variables are identified by their global index (see VariableStore::globalIndex()).
+ *
+ * The variables are moved into new storage, so every reference, pointer or iterator into
+ * the store, and every expression or Proxy holding a variable by reference, is
+ * invalidated. Keep global indices instead, map them through the returned vector, and
+ * rebuild expressions on the store afterwards.
+ *
+ * @param ordering global indices of all variables in the store, in the desired order
+ * @return for each old global index, the new global index
+ */
+template <typename... Leaves>
+std::vector<std::size_t> relayout(VariableStore<Leaves...> &store,
+                                  const std::vector<std::size_t> &ordering) {
+    assert(ordering.size() == store.size());
+    auto rank = std::vector<std::size_t>(ordering.size());
+    for (std::size_t k = 0; k < ordering.size(); ++k) {
+        rank[ordering[k]] = k;
+    }
+
+    auto new_index = std::vector<std::size_t>(ordering.size());
+    const auto relayoutType = [&](auto &values, std::size_t first) {
+        auto old = std::vector<std::size_t>(values.size());
+        std::iota(old.begin(), old.end(), std::size_t{0});
+        std::sort(old.begin(), old.end(), [&](std::size_t a, std::size_t b) {
+            return rank[first + a] < rank[first + b];
+        });
+        auto reordered = std::decay_t<decltype(values)>{};
+        reordered.reserve(values.size());
+        for (std::size_t i = 0; i < old.size(); ++i) {
+            reordered.push_back(std::move(values[old[i]]));
+            new_index[first + old[i]] = first + i;
+        }
+        values.swap(reordered);
+    };
+    (void) std::initializer_list<int>{
+      (relayoutType(store.template values<Leaves>(),
+                    store.template globalIndex<Leaves>(0)),
+       0)...};
+    return new_index;
+}
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_ORDERING_HPP
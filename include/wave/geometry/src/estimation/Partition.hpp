@@ -0,0 +1,507 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_PARTITION_HPP
+#define WAVE_GEOMETRY_PARTITION_HPP
+
+namespace wave {
+
+namespace internal {
+
+inline const FactorBase &factorRef(const FactorBase &factor) noexcept {
+    return factor;
+}
+
+/** Dereferences a pointer to a factor */
+template <typename Pointer,
+          std::enable_if_t<!std::is_base_of<FactorBase, Pointer>{}, int> = 0>
+const FactorBase &factorRef(const Pointer &factor) noexcept {
+    return *factor;
+}
+
+}  // namespace internal
+
+/** Returns the graph of the variables used by a range of factors
+ *
+ * Variables are found through FactorBase::begin() and end(). Those already in
+ * `variables` keep their positions as indices in the graph, so a caller that owns the
+ * variables in a block can number them in advance; others are appended in the order
+ * they are first used.
+ *
+ * @param factors factors, or pointers to factors
+ * @param variables the variable with each index of the graph
+ */
+template <typename Factors>
+VariableGraph incidenceGraph(const Factors &factors,
+                             std::vector<const FactorVariableBase *> &variables) {
+    auto index = std::unordered_map<const FactorVariableBase *, std::size_t>{};
+    for (std::size_t i = 0; i < variables.size(); ++i) {
+        index.emplace(variables[i], i);
+    }
+    auto incidence = std::vector<std::vector<std::size_t>>{};
+    for (const auto &f : factors) {
+        const auto &factor = internal::factorRef(f);
+        incidence.emplace_back();
+        for (const auto &v : factor) {
+            const auto inserted = index.emplace(v.get(), variables.size());
+            if (inserted.second) {
+                variables.push_back(v.get());
+            }
+            incidence.back().push_back(inserted.first->second);
+        }
+    }
+    auto graph = VariableGraph{variables.size()};
+    for (const auto &used : incidence) {
+        graph.addFactor(used);
+    }
+    return graph;
+}
+
+/** Returns the connected components of a graph
+ *
+ * @return the variables of each component, in ascending order, with the components
+ * ordered by their first variable
+ */
+inline std::vector<std::vector<std::size_t>> connectedComponents(
+  const VariableGraph &graph) {
+    const auto n = graph.size();
+    auto seen = std::vector<bool>(n, false);
+    auto components = std::vector<std::vector<std::size_t>>{};
+    for (std::size_t root = 0; root < n; ++root) {
+        if (seen[root]) {
+            continue;
+        }
+        seen[root] = true;
+        auto component = std::vector<std::size_t>{root};
+        for (std::size_t k = 0; k < component.size(); ++k) {
+            for (const auto u : graph.neighbours(component[k])) {
+                if (!seen[u]) {
+                    seen[u] = true;
+                    component.push_back(u);
+                }
+            }
+        }
+        std::sort(component.begin(), component.end());
+        components.push_back(std::move(component));
+    }
+    return components;
+}
+
+/** A split of a set of variables into two parts with no edges between them, and the
+ * separator whose removal disconnects them
+ */
+struct Bisection {
+    std::vector<std::size_t> left;
+    std::vector<std::size_t> right;
+    std::vector<std::size_t> separator;
+};
+
+/** Finds vertex separators of subsets of a graph, from breadth-first level sets
+ *
+ * Each level of a breadth-first search separates the levels before it from those after
+ * it. Starting the search from a pseudo-peripheral variable (one at the end of a longest
+ * search) gives many thin levels; the separator is the smallest level that leaves at
+ * least a quarter of the subset on each side. Where components are joined by a few
+ * factors, such as the maps of two robots, the joining variables form a small level.
+ *
+ * The dissector keeps scratch space the size of the graph, so repeated calls on small
+ * subsets cost time in proportion to the subsets.
+ */
+class Dissector {
+ public:
+    explicit Dissector(const VariableGraph &graph)
+        : graph{graph}, level(graph.size(), Outside) {}
+
+    /** Splits a subset of the graph's variables
+     *
+     * Variables not reachable from the first variable of the subset are put on the
+     * right. If no level leaves enough on each side, the separator is empty, and the
+     * reachable variables are put on the left.
+     */
+    Bisection bisect(const std::vector<std::size_t> &subset) {
+        auto result = Bisection{};
+        if (subset.empty()) {
+            return result;
+        }
+        for (const auto v : subset) {
+            this->level[v] = Unvisited;
+        }
+
+        // Two sweeps find a pseudo-peripheral start
+        this->search(subset.front());
+        const auto start = this->order.back();
+        this->resetLevels();
+        this->search(start);
+
+        // Count the variables on each level
+        const auto deepest = this->level[this->order.back()];
+        const auto num_levels = static_cast<std::size_t>(deepest) + 1;
+        auto count = std::vector<std::size_t>(num_levels, 0);
+        for (const auto v : this->order) {
+            ++count[this->level[v]];
+        }
+
+        const auto n = subset.size();
+        auto best = num_levels;
+        std::size_t before = 0;
+        for (std::size_t l = 0; l < num_levels; ++l) {
+            const auto after = this->order.size() - before - count[l];
+            if (4 * before >= n && 4 * (after + n - this->order.size()) >= n &&
+                (best == num_levels || count[l] < count[best])) {
+                best = l;
+            }
+            before += count[l];
+        }
+
+        for (const auto v : subset) {
+            const auto l = this->level[v];
+            if (l >= 0 && (best == num_levels || static_cast<std::size_t>(l) < best)) {
+                result.left.push_back(v);
+            } else if (l >= 0 && static_cast<std::size_t>(l) == best) {
+                result.separator.push_back(v);
+            } else {
+                result.right.push_back(v);
+            }
+            this->level[v] = Outside;
+        }
+        return result;
+    }
+
+ private:
+    static constexpr int Outside = -2;
+    static constexpr int Unvisited = -1;
+
+    /** Breadth-first search within the subset, setting levels and the visit order */
+    void search(std::size_t root) {
+        this->order.assign(1, root);
+        this->level[root] = 0;
+        for (std::size_t k = 0; k < this->order.size(); ++k) {
+            const auto v = this->order[k];
+            for (const auto u : this->graph.neighbours(v)) {
+                if (this->level[u] == Unvisited) {
+                    this->level[u] = this->level[v] + 1;
+                    this->order.push_back(u);
+                }
+            }
+        }
+    }
+
+    void resetLevels() {
+        for (const auto v : this->order) {
+            this->level[v] = Unvisited;
+        }
+    }
+
+    const VariableGraph &graph;
+    std::vector<int> level;
+    std::vector<std::size_t> order;
+};
+
+/** Returns a nested dissection elimination ordering
+ *
+ * Each connected component is bisected, the two sides are ordered recursively, and the
+ * separator is eliminated last. Subsets of at most `leaf_size` variables are ordered by
+ * minimum degree within the subset. Since the sides do not interact until the
+ * separator, their eliminations are independent, which is what solvePartitioned() uses.
+ *
+ * @return the variables in elimination order
+ */
+inline std::vector<std::size_t> nestedDissectionOrdering(const VariableGraph &graph,
+                                                         std::size_t leaf_size = 64) {
+    auto dissector = Dissector{graph};
+    auto ordering = std::vector<std::size_t>{};
+    ordering.reserve(graph.size());
+
+    // Orders a subset by minimum degree on the subgraph it induces
+    auto local = std::vector<std::size_t>(graph.size());
+    const auto orderLeaf = [&](const std::vector<std::size_t> &subset) {
+        for (std::size_t k = 0; k < subset.size(); ++k) {
+            local[subset[k]] = k;
+        }
+        auto subgraph = VariableGraph{subset.size()};
+        for (std::size_t k = 0; k < subset.size(); ++k) {
+            for (const auto u : graph.neighbours(subset[k])) {
+                if (std::binary_search(subset.begin(), subset.end(), u)) {
+                    subgraph.addFactor({k, local[u]});
+                }
+            }
+        }
+        for (const auto k : minimumDegreeOrdering(subgraph)) {
+            ordering.push_back(subset[k]);
+        }
+    };
+
+    std::function<void(const std::vector<std::size_t> &)> dissect =
+      [&](const std::vector<std::size_t> &subset) {
+          auto split = Bisection{};
+          if (subset.size() > leaf_size) {
+              split = dissector.bisect(subset);
+          }
+          if (split.separator.empty() && split.right.empty()) {
+              orderLeaf(subset);
+              return;
+          }
+          dissect(split.left);
+          dissect(split.right);
+          dissect(split.separator);
+      };
+    for (const auto &component : connectedComponents(graph)) {
+        dissect(component);
+    }
+    return ordering;
+}
+
+/** Options for solvePartitioned() */
+struct PartitionOptions {
+    /** Components with more variables than this are bisected by a separator */
+    std::size_t min_bisection_size = 64;
+
+    /** Largest separator, in variables, to bisect by. The Schur complement of a
+     * separator is solved densely, so a component with no small separator is better
+     * solved whole. */
+    std::size_t max_separator_size = 16;
+
+    /** Pool to solve the parts on. If null, the caller does all work. */
+    WorkStealingPool *pool = nullptr;
+};
+
+namespace internal {
+
+/** Runs f(i) for i in [0, count), in contiguous chunks on the pool if there is one */
+template <typename F>
+void forEachTask(WorkStealingPool *pool, std::size_t count, const F &f) {
+    parallelChunks(pool, count, 1, [&f](std::size_t, std::size_t start, std::size_t end) {
+        for (auto i = start; i < end; ++i) {
+            f(i);
+        }
+    });
+}
+
+/** A linear system split into parts: the two sides and the separator of each bisected
+ * component, or a whole component
+ */
+class PartitionedSystem {
+ public:
+    using Index = Eigen::Index;
+    using SparseMatrix = Eigen::SparseMatrix<double>;
+    static constexpr std::size_t None = static_cast<std::size_t>(-1);
+
+    PartitionedSystem(const SparseMatrix &H, const std::vector<Index> &offsets)
+        : H{H}, offsets{offsets}, owner(H.rows(), None), position(H.rows()) {}
+
+    /** Adds a part made of the given variables, and returns its index
+     *
+     * @param separator the part separating this one from the rest of its component, or
+     * None for a whole component
+     */
+    std::size_t addPart(const std::vector<std::size_t> &variables,
+                        std::size_t separator = None) {
+        const auto p = this->parts.size();
+        if (separator != None) {
+            this->parts[separator].sides.push_back(p);
+        }
+        this->parts.emplace_back();
+        auto &part = this->parts.back();
+        part.separator = separator;
+        for (const auto v : variables) {
+            for (auto i = this->offsets[v]; i < this->offsets[v + 1]; ++i) {
+                this->owner[i] = p;
+                this->position[i] = static_cast<Index>(part.indices.size());
+                part.indices.push_back(i);
+            }
+        }
+        return p;
+    }
+
+    /** Solves the system, eliminating the sides of each separator in parallel */
+    Eigen::VectorXd solve(const Eigen::VectorXd &b, WorkStealingPool *pool) {
+        auto x = Eigen::VectorXd{b.size()};
+        const auto num_parts = this->parts.size();
+        // Sides and whole components first, then separators, then back-substitution
+        forEachTask(pool, num_parts, [&](std::size_t p) {
+            if (!this->isSeparator(p)) {
+                this->eliminate(p, b, x);
+            }
+        });
+        forEachTask(pool, num_parts, [&](std::size_t p) {
+            if (this->isSeparator(p)) {
+                this->solveSeparator(p, b, x);
+            }
+        });
+        forEachTask(pool, num_parts, [&](std::size_t p) {
+            if (this->parts[p].separator != None) {
+                this->backSubstitute(p, b, x);
+            }
+        });
+        return x;
+    }
+
+ private:
+    struct Part {
+        std::vector<Index> indices;  // into the full system, ascending
+        std::size_t separator = None;
+        std::vector<std::size_t> sides;  // of a separator
+        Eigen::SimplicialLDLT<SparseMatrix> solver;
+        SparseMatrix H_sp;        // separator rows, own columns
+        Eigen::MatrixXd schur;    // H_sp H_pp^-1 H_ps
+        Eigen::VectorXd reduced;  // H_sp H_pp^-1 b_p
+    };
+
+    bool isSeparator(std::size_t p) const noexcept {
+        return !this->parts[p].sides.empty();
+    }
+
+    /** Returns the block of H with the rows of part `rows` and the columns of `cols` */
+    SparseMatrix extract(std::size_t rows, std::size_t cols) const {
+        const auto &row_part = this->parts[rows];
+        const auto &col_part = this->parts[cols];
+        auto triplets = std::vector<Eigen::Triplet<double>>{};
+        for (std::size_t c = 0; c < col_part.indices.size(); ++c) {
+            for (SparseMatrix::InnerIterator it{this->H, col_part.indices[c]}; it; ++it) {
+                if (this->owner[it.row()] == rows) {
+                    triplets.emplace_back(this->position[it.row()], c, it.value());
+                }
+            }
+        }
+        auto block = SparseMatrix(row_part.indices.size(), col_part.indices.size());
+        block.setFromTriplets(triplets.begin(), triplets.end());
+        return block;
+    }
+
+    Eigen::VectorXd gather(std::size_t p, const Eigen::VectorXd &v) const {
+        const auto &indices = this->parts[p].indices;
+        auto result = Eigen::VectorXd{indices.size()};
+        for (std::size_t k = 0; k < indices.size(); ++k) {
+            result[k] = v[indices[k]];
+        }
+        return result;
+    }
+
+    void scatter(std::size_t p, const Eigen::VectorXd &local, Eigen::VectorXd &v) const {
+        const auto &indices = this->parts[p].indices;
+        for (std::size_t k = 0; k < indices.size(); ++k) {
+            v[indices[k]] = local[k];
+        }
+    }
+
+    /** Factorizes a part; solves it if it is a whole component, or else computes its
+     * contribution to the Schur complement of its separator
+     */
+    void eliminate(std::size_t p, const Eigen::VectorXd &b, Eigen::VectorXd &x) {
+        // Solve with a few columns of H_ps at a time, to bound memory
+        constexpr Index ChunkSize = 32;
+        auto &part = this->parts[p];
+        part.solver.compute(this->extract(p, p));
+        if (part.solver.info() != Eigen::Success) {
+            throw std::runtime_error{"Each part must be positive definite"};
+        }
+        const Eigen::VectorXd y = part.solver.solve(this->gather(p, b));
+        if (part.separator == None) {
+            this->scatter(p, y, x);
+            return;
+        }
+        part.H_sp = this->extract(part.separator, p);
+        const SparseMatrix H_ps = part.H_sp.transpose();
+        const auto s = H_ps.cols();
+        part.schur.resize(s, s);
+        for (Index c = 0; c < s; c += ChunkSize) {
+            const auto k = std::min(ChunkSize, s - c);
+            const Eigen::MatrixXd X = part.solver.solve(H_ps.middleCols(c, k).toDense());
+            part.schur.middleCols(c, k) = part.H_sp * X;
+        }
+        part.reduced = part.H_sp * y;
+    }
+
+    /** Solves the Schur complement of a separator, dense as separators are small */
+    void solveSeparator(std::size_t s, const Eigen::VectorXd &b, Eigen::VectorXd &x) {
+        const auto &separator = this->parts[s];
+        Eigen::MatrixXd S = this->extract(s, s).toDense();
+        Eigen::VectorXd rhs = this->gather(s, b);
+        for (const auto p : separator.sides) {
+            S -= this->parts[p].schur;
+            rhs -= this->parts[p].reduced;
+        }
+        const auto llt = Eigen::LLT<Eigen::MatrixXd>{S};
+        if (llt.info() != Eigen::Success) {
+            throw std::runtime_error{"The system must be positive definite"};
+        }
+        this->scatter(s, llt.solve(rhs), x);
+    }
+
+    /** Solves a side given the solution of its separator */
+    void backSubstitute(std::size_t p, const Eigen::VectorXd &b, Eigen::VectorXd &x) {
+        auto &part = this->parts[p];
+        const Eigen::VectorXd x_s = this->gather(part.separator, x);
+        const Eigen::VectorXd rhs = this->gather(p, b) - part.H_sp.transpose() * x_s;
+        this->scatter(p, part.solver.solve(rhs), x);
+        part.schur.resize(0, 0);
+    }
+
+    const SparseMatrix &H;
+    const std::vector<Index> &offsets;
+    std::vector<std::size_t> owner;  // part of each index
+    std::vector<Index> position;     // within its part
+    std::deque<Part> parts;  // solvers cannot be moved, so parts must stay in place
+};
+
+}  // namespace internal
+
+/** Solves a sparse symmetric positive definite system by parts, in parallel
+ *
+ * The connected components of the graph are independent systems. Each component larger
+ * than `options.min_bisection_size` is split by a separator (see Dissector) into two
+ * sides that interact only through it, if the separator is small enough. All sides and
+ * unsplit components are factorized in parallel, each side contributing a dense Schur
+ * complement to its separator; the separators are then solved, and finally the sides,
+ * again in parallel.
+ *
+ * This pays off when components are joined by few factors, as in multi-robot maps,
+ * where the separators are small. Only one level of separators is used, so the parts
+ * themselves are solved by sparse Cholesky decomposition.
+ *
+ * @param H the system matrix, with both triangles, e.g. J^T J of a problem
+ * @param b the right-hand side
+ * @param graph the variables of the problem, with an edge for each pair of variables
+ * sharing a nonzero block of H
+ * @param offsets the first row of each variable in H, and the size of H last. For a
+ * VariableStore, this is VariableStore::tangentOffset() by global index.
+ * @throws std::runtime_error if the factorization of a part fails, e.g. as it is
+ * singular, or the Schur complement of a separator is not positive definite
+ */
+inline Eigen::VectorXd solvePartitioned(const Eigen::SparseMatrix<double> &H,
+                                        const Eigen::VectorXd &b,
+                                        const VariableGraph &graph,
+                                        const std::vector<Eigen::Index> &offsets,
+                                        const PartitionOptions &options = {}) {
+    assert(offsets.size() == graph.size() + 1);
+    assert(offsets.back() == H.rows() && H.rows() == H.cols() && b.size() == H.rows());
+    using System = internal::PartitionedSystem;
+    auto system = System{H, offsets};
+    auto dissector = Dissector{graph};
+    for (const auto &component : connectedComponents(graph)) {
+        auto split = Bisection{};
+        if (component.size() > options.min_bisection_size) {
+            split = dissector.bisect(component);
+        }
+        if (split.separator.size() > options.max_separator_size) {
+            split = Bisection{};
+        }
+        if (split.separator.empty()) {
+            // Either unsplit, or the right side is disconnected from the rest
+            system.addPart(split.left.empty() ? component : split.left);
+            if (!split.right.empty()) {
+                system.addPart(split.right);
+            }
+            continue;
+        }
+        const auto s = system.addPart(split.separator);
+        system.addPart(split.left, s);
+        system.addPart(split.right, s);
+    }
+    return system.solve(b, options.pool);
+}
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_PARTITION_HPP
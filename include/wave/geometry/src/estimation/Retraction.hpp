@@ -0,0 +1,195 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_RETRACTION_HPP
+#define WAVE_GEOMETRY_RETRACTION_HPP
+
+namespace wave {
+
+/** Policies for the map from tangent-space updates to rotations, used by boxPlus()
+ *
+ * A solver only needs an update @f$ R \leftarrow \rho(\phi) R @f$ which agrees with the
+ * exponential map to first order, so that Jacobians taken with respect to a left
+ * perturbation `exp(phi) * R` stay valid at @f$ \phi = 0 @f$. The cheaper policies below
+ * all rotate about the axis of @f$ \phi @f$, by an angle @f$ a(\theta) @f$ of its norm
+ * @f$ \theta @f$ which is @f$ \theta + O(\theta^3) @f$. Each gives the rotation as the
+ * half-angle coefficients of a unit quaternion @f$ (s \phi, c) @f$, which need no
+ * trigonometric functions except for the exact map.
+ *
+ * Every policy gives the same rotation whether a variable is stored as a quaternion or a
+ * matrix.
+ */
+struct ExpRetraction {
+    /** Sets s = sin(a/2)/theta and c = cos(a/2), given theta^2 */
+    template <typename Scalar>
+    static void halfAngle(const Scalar &theta2, Scalar &s, Scalar &c) {
+        using std::cos;
+        using std::sin;
+        using std::sqrt;
+        // As in evalImpl(expr<ExpMap>, RelativeRotation)
+        if (theta2 * theta2 > Eigen::NumTraits<Scalar>::epsilon()) {
+            const Scalar theta = sqrt(theta2);
+            s = sin(theta / 2) / theta;
+            c = cos(theta / 2);
+        } else {
+            s = Scalar{0.5} - theta2 / 48;
+            c = 1 - theta2 / 8;
+        }
+    }
+
+    /** Rotation angle a and its derivative, given theta */
+    template <typename Scalar>
+    static void angle(const Scalar &theta, Scalar &a, Scalar &da) {
+        a = theta;
+        da = 1;
+    }
+};
+
+/** Cayley map, @f$ (I - [\phi/2]_\times)^{-1} (I + [\phi/2]_\times) @f$
+ *
+ * As a quaternion this is the common small-angle update, normalizing
+ * @f$ (\phi / 2, 1) @f$. It rotates by @f$ 2 \arctan(\theta / 2) @f$.
+ */
+struct CayleyRetraction {
+    template <typename Scalar>
+    static void halfAngle(const Scalar &theta2, Scalar &s, Scalar &c) {
+        using std::sqrt;
+        c = 1 / sqrt(1 + theta2 / 4);
+        s = c / 2;
+    }
+
+    template <typename Scalar>
+    static void angle(const Scalar &theta, Scalar &a, Scalar &da) {
+        using std::atan;
+        a = 2 * atan(theta / 2);
+        da = 1 / (1 + theta * theta / 4);
+    }
+};
+
+/** First-order update @f$ I + [\phi]_\times @f$, re-orthonormalized
+ *
+ * The nearest rotation matrix to @f$ I + [\phi]_\times @f$ (its polar factor) is a
+ * rotation by @f$ \arctan \theta @f$, which is computed here in closed form instead of
+ * with an SVD.
+ */
+struct FirstOrderRetraction {
+    template <typename Scalar>
+    static void halfAngle(const Scalar &theta2, Scalar &s, Scalar &c) {
+        using std::sqrt;
+        // With k = sqrt(1 + theta^2) = 1 / cos(a), avoid the cancellation in 1 - cos(a)
+        const Scalar k = sqrt(1 + theta2);
+        s = 1 / sqrt(2 * k * (k + 1));
+        c = sqrt((k + 1) / (2 * k));
+    }
+
+    template <typename Scalar>
+    static void angle(const Scalar &theta, Scalar &a, Scalar &da) {
+        using std::atan;
+        a = atan(theta);
+        da = 1 / (1 + theta * theta);
+    }
+};
+
+/** Selects one retraction policy for each type in a VariableStore, in the same order */
+template <typename... Policies>
+struct Retractions {};
+
+namespace internal {
+
+/** Rotation matrix of a retraction policy, from its half-angle coefficients */
+template <typename Policy, typename Derived>
+auto retractionMatrix(const Eigen::MatrixBase<Derived> &phi)
+  -> Eigen::Matrix<typename Derived::Scalar, 3, 3> {
+    using Scalar = typename Derived::Scalar;
+    using Mat3 = Eigen::Matrix<Scalar, 3, 3>;
+    Scalar s, c;
+    Policy::halfAngle(phi.squaredNorm(), s, c);
+    const auto cross = crossMatrix(phi);
+    return Mat3::Identity() + 2 * s * c * cross + 2 * s * s * Mat3{cross * cross};
+}
+
+/** Unit quaternion of a retraction policy */
+template <typename Policy, typename Derived>
+auto retractionQuaternion(const Eigen::MatrixBase<Derived> &phi)
+  -> Eigen::Quaternion<typename Derived::Scalar> {
+    using Scalar = typename Derived::Scalar;
+    Scalar s, c;
+    Policy::halfAngle(phi.squaredNorm(), s, c);
+    Eigen::Quaternion<Scalar> q;
+    q.coeffs() << s * phi, c;
+    return q;
+}
+
+}  // namespace internal
+
+/** Jacobian of a rotation retraction, in the tangent space of its result
+ *
+ * Returns @f$ J @f$ such that
+ * @f$ \rho(\phi + d\phi) \approx \exp(J d\phi) \rho(\phi) @f$. For ExpRetraction this is
+ * the left Jacobian of SO(3). It is the identity at @f$ \phi = 0 @f$ for every policy.
+ */
+template <typename Policy, typename Derived>
+auto retractionJacobian(const Eigen::MatrixBase<Derived> &phi)
+  -> Eigen::Matrix<typename Derived::Scalar, 3, 3> {
+    using Scalar = typename Derived::Scalar;
+    using Mat3 = Eigen::Matrix<Scalar, 3, 3>;
+    using std::cos;
+    using std::sin;
+    using std::sqrt;
+
+    const Scalar theta2 = phi.squaredNorm();
+    const auto cross = crossMatrix(phi);
+    if (theta2 <= sqrt(Eigen::NumTraits<Scalar>::epsilon())) {
+        // Every policy has a = theta + O(theta^3), so they agree to this order
+        return Mat3::Identity() + cross / 2;
+    }
+
+    // The result is exp(psi) with psi = (a / theta) phi. Chain the left Jacobian of
+    // SO(3) at psi, written in terms of phi, with the derivative of psi.
+    const Scalar theta = sqrt(theta2);
+    Scalar a, da;
+    Policy::angle(theta, a, da);
+    const Mat3 left = Mat3::Identity() + (1 - cos(a)) / (a * theta) * cross +
+                      (a - sin(a)) / (a * theta2) * Mat3{cross * cross};
+    const Mat3 dpsi = a / theta * Mat3::Identity() +
+                      (da - a / theta) / theta2 * phi * phi.transpose();
+    return left * dpsi;
+}
+
+/** Jacobian of a rigid transform retraction, in the tangent space of its result
+ *
+ * The update is a twist @f$ (\phi, \delta_t) @f$, rotation first. Cheap policies apply
+ * @f$ (\rho(\phi), \delta_t) @f$ on the left, so the translation block is simply
+ * @f$ [\delta_t]_\times J_\rho @f$. ExpRetraction uses the Jacobian of the exponential
+ * map of the twist.
+ */
+template <typename Policy,
+          typename Derived,
+          TICK_REQUIRES(!std::is_same<Policy, ExpRetraction>{})>
+auto rigidRetractionJacobian(const Eigen::MatrixBase<Derived> &xi)
+  -> Eigen::Matrix<typename Derived::Scalar, 6, 6> {
+    using Scalar = typename Derived::Scalar;
+    const Eigen::Matrix<Scalar, 3, 3> J =
+      retractionJacobian<Policy>(xi.template head<3>());
+    Eigen::Matrix<Scalar, 6, 6> out;
+    out.template topLeftCorner<3, 3>() = J;
+    out.template topRightCorner<3, 3>().setZero();
+    out.template bottomLeftCorner<3, 3>() = crossMatrix(xi.template tail<3>()) * J;
+    out.template bottomRightCorner<3, 3>().setIdentity();
+    return out;
+}
+
+template <typename Policy,
+          typename Derived,
+          TICK_REQUIRES(std::is_same<Policy, ExpRetraction>{})>
+auto rigidRetractionJacobian(const Eigen::MatrixBase<Derived> &xi)
+  -> Eigen::Matrix<typename Derived::Scalar, 6, 6> {
+    using Scalar = typename Derived::Scalar;
+    const auto twist = Twist<Eigen::Matrix<Scalar, 6, 1>>{xi};
+    return internal::jacobianImpl(internal::expr<ExpMap>{}, eval(exp(twist)), twist);
+}
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_RETRACTION_HPP
@@ -0,0 +1,195 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_UNSCENTEDTRANSFORM_HPP
+#define WAVE_GEOMETRY_UNSCENTEDTRANSFORM_HPP
+
+namespace wave {
+
+/** Parameters of the unscented transform
+ *
+ * The sigma points are spread by gamma = sqrt(n + lambda) standard deviations, with
+ * lambda = alpha^2 (n + kappa) - n, where n is the tangent size. The defaults give
+ * lambda = 0, and weights that are exact for the second moments of a Gaussian.
+ */
+struct UnscentedOptions {
+    double alpha = 1;
+    double beta = 2;
+    double kappa = 0;
+
+    /** Limit on box-minus averaging iterations for the mean */
+    int max_iterations = 20;
+
+    /** Stop averaging once the correction to the mean is smaller than this */
+    double tolerance = 1e-12;
+};
+
+/** The 2n + 1 sigma points of an uncertain leaf, for a tangent space of size n
+ *
+ * Point 0 is the mean, and points i and n + i are the mean box-plus and box-minus gamma
+ * times column i of the Cholesky factor of the covariance. The points are stored as one
+ * fixed-size row-major matrix of tangent offsets from the mean, with one column per
+ * point, so each component of the offsets is contiguous across points.
+ *
+ * @tparam Leaf the leaf or compound leaf type
+ */
+template <typename Leaf>
+class SigmaPoints {
+ public:
+    using Scalar = internal::scalar_t<Leaf>;
+    enum : int {
+        Size = internal::traits<Leaf>::TangentSize,
+        Count = 2 * Size + 1,
+    };
+    using Offsets = Eigen::Matrix<Scalar, Size, Count, Eigen::RowMajor>;
+    using Weights = Eigen::Matrix<Scalar, Count, 1>;
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+
+    /** Generates the sigma points of an uncertain value, whose noise model has a
+     * covariance()
+     *
+     * @throws std::runtime_error if the covariance is not positive definite
+     */
+    template <template <typename> class NoiseModel>
+    explicit SigmaPoints(const Uncertain<Leaf, NoiseModel> &x,
+                         const UnscentedOptions &options = {})
+        : mean_{x.value} {
+        using Covariance = Eigen::Matrix<Scalar, Size, Size>;
+        const Covariance P{x.noise.covariance()};
+        const auto llt = Eigen::LLT<Covariance>{P};
+        if (llt.info() != Eigen::Success) {
+            throw std::runtime_error{"Covariance must be positive definite"};
+        }
+
+        const auto n = Scalar{Size};
+        const auto lambda = options.alpha * options.alpha * (n + options.kappa) - n;
+        const Covariance L = std::sqrt(n + lambda) * llt.matrixL().toDenseMatrix();
+        this->offsets_.col(0).setZero();
+        this->offsets_.template middleCols<Size>(1) = L;
+        this->offsets_.template rightCols<Size>() = -L;
+
+        this->mean_weights.setConstant(1 / (2 * (n + lambda)));
+        this->mean_weights[0] = lambda / (n + lambda);
+        this->covariance_weights = this->mean_weights;
+        this->covariance_weights[0] +=
+          1 - options.alpha * options.alpha + options.beta;
+    }
+
+    /** Returns the number of points, 2n + 1 */
+    static constexpr int size() noexcept {
+        return Count;
+    }
+
+    /** Returns point i, as the mean box-plus its offset */
+    Leaf point(int i) const {
+        using Tangent = internal::plain_tangent_t<Leaf>;
+        const BlockVector<Leaf> offset = this->offsets_.col(i);
+        return Leaf{this->mean_ + internal::makeTangent<Tangent>(offset)};
+    }
+
+    const Leaf &mean() const noexcept {
+        return this->mean_;
+    }
+
+    /** Returns the tangent offsets of the points from the mean, one per column */
+    const Offsets &offsets() const noexcept {
+        return this->offsets_;
+    }
+
+    const Weights &meanWeights() const noexcept {
+        return this->mean_weights;
+    }
+
+    const Weights &covarianceWeights() const noexcept {
+        return this->covariance_weights;
+    }
+
+ private:
+    Leaf mean_;
+    Offsets offsets_;
+    Weights mean_weights;
+    Weights covariance_weights;
+};
+
+/** The result of unscentedTransform() */
+template <typename In, typename Out>
+struct UnscentedResult {
+    Out mean;
+    BlockMatrix<Out, Out> covariance;
+
+    /** Covariance of the input and output, as used in the gain of an unscented filter */
+    BlockMatrix<In, Out> cross_covariance;
+
+    /** The number of box-minus averaging iterations */
+    int iterations;
+
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+};
+
+/** Propagates sigma points through a function, recovering the mean and covariance of
+ * the result
+ *
+ * The expression f(point) has the same type for every point, and is evaluated for all
+ * points in turn into one array of results. The mean of the results is found on their
+ * manifold by iterative averaging: starting from the image of the mean, the weighted
+ * average of the box-minus offsets of all results is added by box-plus until it
+ * vanishes. The covariances are then weighted sums over the final offsets, computed as
+ * products of the fixed-size offset matrices.
+ *
+ * @param f function taking a point and returning an expression of it
+ */
+template <typename F, typename In>
+auto unscentedTransform(F &&f,
+                        const SigmaPoints<In> &points,
+                        const UnscentedOptions &options = {}) {
+    using Out = std::decay_t<decltype(eval(f(std::declval<const In &>())))>;
+    using Scalar = internal::scalar_t<Out>;
+    using Tangent = internal::plain_tangent_t<Out>;
+    enum : int { Count = SigmaPoints<In>::Count };
+
+    auto images = std::vector<Out, Eigen::aligned_allocator<Out>>{};
+    images.reserve(Count);
+    for (int i = 0; i < Count; ++i) {
+        images.push_back(eval(f(points.point(i))));
+    }
+
+    auto result = UnscentedResult<In, Out>{images.front(), {}, {}, 0};
+    Eigen::Matrix<Scalar, internal::traits<Out>::TangentSize, Count, Eigen::RowMajor> D;
+    const auto computeOffsets = [&] {
+        for (int i = 0; i < Count; ++i) {
+            D.col(i) = valueAsVector(internal::adl{}, eval(images[i] - result.mean));
+        }
+    };
+    computeOffsets();
+    while (result.iterations < options.max_iterations) {
+        const BlockVector<Out> delta = D * points.meanWeights();
+        result.mean = Out{result.mean + internal::makeTangent<Tangent>(delta)};
+        computeOffsets();
+        ++result.iterations;
+        if (delta.norm() < options.tolerance) {
+            break;
+        }
+    }
+
+    const auto &w = points.covarianceWeights();
+    result.covariance = D * w.asDiagonal() * D.transpose();
+    result.cross_covariance = points.offsets() * w.asDiagonal() * D.transpose();
+    return result;
+}
+
+/** Propagates an uncertain value through a function, by its sigma points
+ *
+ * @see SigmaPoints
+ */
+template <typename F, typename In, template <typename> class NoiseModel>
+auto unscentedTransform(F &&f,
+                        const Uncertain<In, NoiseModel> &x,
+                        const UnscentedOptions &options = {}) {
+    return unscentedTransform(std::forward<F>(f), SigmaPoints<In>{x, options}, options);
+}
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_UNSCENTEDTRANSFORM_HPP
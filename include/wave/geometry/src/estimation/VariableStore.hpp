@@ -0,0 +1,388 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_VARIABLESTORE_HPP
+#define WAVE_GEOMETRY_VARIABLESTORE_HPP
+
+namespace wave {
+
+/** Contiguous storage of the values of many variables, grouped by type
+ *
+ * Each leaf type has its own vector, so all variables of one type are adjacent in
+ * memory and can be updated in one loop without virtual calls or pointer chasing.
+ *
+ * The tangent-space update vector used by boxPlus() stacks the variables in the same
+ * order: first every variable of the first type, in index order, then every variable of
+ * the second type, and so on.
+ *
+ * @tparam Leaves distinct leaf types, with double as scalar type
+ */
+template <typename... Leaves>
+class VariableStore {
+    static_assert(tmp::conjunction<internal::is_leaf_expression<Leaves>...>{},
+                  "Template parameters must be leaves");
+
+ public:
+    template <typename Leaf>
+    using Container = std::vector<Leaf, Eigen::aligned_allocator<Leaf>>;
+
+    /** Number of variable types */
+    static constexpr std::size_t NumTypes = sizeof...(Leaves);
+
+    /** Adds a variable and returns its index among variables of the same type */
+    template <typename Leaf>
+    std::size_t add(const Leaf &value) {
+        auto &v = this->values<Leaf>();
+        v.push_back(value);
+        return v.size() - 1;
+    }
+
+    /** Returns the values of all variables of one type */
+    template <typename Leaf>
+    Container<Leaf> &values() noexcept {
+        return std::get<Container<Leaf>>(this->containers);
+    }
+
+    template <typename Leaf>
+    const Container<Leaf> &values() const noexcept {
+        return std::get<Container<Leaf>>(this->containers);
+    }
+
+    /** Returns the position of the first variable of type Leaf in the stacked tangent
+     * vector */
+    template <typename Leaf>
+    std::size_t offset() const noexcept {
+        std::size_t offset = 0;
+        bool found = false;
+        (void) std::initializer_list<int>{
+          (found = found || std::is_same<Leaf, Leaves>{},
+           offset += found ? 0 : this->template blockSize<Leaves>(),
+           0)...};
+        return offset;
+    }
+
+    /** Returns the position of variable i of type Leaf in the stacked tangent vector */
+    template <typename Leaf>
+    std::size_t tangentOffset(std::size_t i) const noexcept {
+        return this->template offset<Leaf>() + i * internal::traits<Leaf>::TangentSize;
+    }
+
+    /** Returns the number of variables of all types */
+    std::size_t size() const noexcept {
+        std::size_t size = 0;
+        (void) std::initializer_list<int>{
+          (size += this->template values<Leaves>().size(), 0)...};
+        return size;
+    }
+
+    /** Returns the global index of variable i of type Leaf
+     *
+     * Global indices number all variables in the order of the stacked tangent vector.
+     */
+    template <typename Leaf>
+    std::size_t globalIndex(std::size_t i) const noexcept {
+        std::size_t index = i;
+        bool found = false;
+        (void) std::initializer_list<int>{
+          (found = found || std::is_same<Leaf, Leaves>{},
+           index += found ? 0 : this->template values<Leaves>().size(),
+           0)...};
+        return index;
+    }
+
+    /** Returns the size of the stacked tangent vector */
+    std::size_t tangentSize() const noexcept {
+        std::size_t size = 0;
+        (void) std::initializer_list<int>{(size += this->template blockSize<Leaves>(), 0)...};
+        return size;
+    }
+
+ private:
+    template <typename Leaf>
+    std::size_t blockSize() const noexcept {
+        return this->values<Leaf>().size() * internal::traits<Leaf>::TangentSize;
+    }
+
+    std::tuple<Container<Leaves>...> containers;
+};
+
+/** Options for boxPlus() on a VariableStore */
+struct BoxPlusOptions {
+    /** Default smallest number of variables in one task */
+    static constexpr std::size_t DefaultGrainSize = 1024;
+
+    /** If true, quaternions are normalized after they are updated, removing drift */
+    bool renormalize_quaternions = false;
+
+    /** Pool to update large groups of variables on. If null, the caller does all work. */
+    WorkStealingPool *pool = nullptr;
+
+    /** Smallest number of variables of one type given to one task */
+    std::size_t grain_size = DefaultGrainSize;
+};
+
+namespace internal {
+
+/** Gives T for each U in a pack expansion */
+template <typename T, typename U>
+struct repeat_for {
+    using type = T;
+};
+
+/** Does nothing for leaves not stored as quaternions */
+template <typename Leaf>
+void renormalizeQuaternions(Leaf &, const BoxPlusOptions &) {}
+
+template <typename ImplType>
+void renormalizeQuaternions(QuaternionRotation<ImplType> &x, const BoxPlusOptions &opt) {
+    if (opt.renormalize_quaternions) {
+        x.value().normalize();
+    }
+}
+
+template <typename QuatType, typename VecType>
+void renormalizeQuaternions(CompactRigidTransform<QuatType, VecType> &x,
+                            const BoxPlusOptions &opt) {
+    renormalizeQuaternions(x.rotationBlock(), opt);
+}
+
+/** Box-plus of a contiguous range of variables, one at a time, with the exact map
+ *
+ * Each variable becomes `exp(delta_i) * x_i`, as with `x + delta` on one leaf. Leaves
+ * without a kernel for other retraction policies use this.
+ */
+template <typename Policy, typename Leaf, typename Scalar>
+void boxPlusRange(
+  Policy, Leaf *x, const Scalar *delta, std::size_t n, const BoxPlusOptions &opt) {
+    using TangentType = typename traits<Leaf>::TangentType;
+    using TangentVector = Eigen::Matrix<Scalar, traits<Leaf>::TangentSize, 1>;
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto d = Eigen::Map<const TangentVector>{
+          delta + i * traits<Leaf>::TangentSize};
+        x[i] = eval(x[i] + TangentType{d});
+        renormalizeQuaternions(x[i], opt);
+    }
+}
+
+/** Box-plus of vector leaves stored without padding is a single vector sum */
+template <typename Policy, typename ImplType, typename Scalar>
+void boxPlusRange(Policy,
+                  Translation<ImplType> *x,
+                  const Scalar *delta,
+                  std::size_t n,
+                  const BoxPlusOptions &) {
+    using Leaf = Translation<ImplType>;
+    constexpr int Size = traits<Leaf>::TangentSize;
+    using Vector = Eigen::Matrix<Scalar, Eigen::Dynamic, 1>;
+    if (n == 0) {
+        // x may be null for an empty range
+        return;
+    }
+    if (sizeof(Leaf) == Size * sizeof(Scalar)) {
+        Eigen::Map<Vector>{x->value().data(), static_cast<Eigen::Index>(n * Size)} +=
+          Eigen::Map<const Vector>{delta, static_cast<Eigen::Index>(n * Size)};
+    } else {
+        for (std::size_t i = 0; i < n; ++i) {
+            x[i].value() += Eigen::Map<const Eigen::Matrix<Scalar, Size, 1>>{
+              delta + i * Size};
+        }
+    }
+}
+
+/** Box-plus of quaternion rotations, in two passes over the range
+ *
+ * The first pass computes the quaternion of each update into a buffer, and the second
+ * multiplies it into each variable. Each pass is a loop of arithmetic with no calls
+ * through the expression machinery, which the compiler can vectorize across variables.
+ */
+template <typename Policy, typename Scalar>
+void boxPlusRange(Policy,
+                  QuaternionRotation<Eigen::Quaternion<Scalar>> *x,
+                  const Scalar *delta,
+                  std::size_t n,
+                  const BoxPlusOptions &opt) {
+    using std::sqrt;
+    constexpr std::size_t Chunk = 64;
+    Scalar dq[4][Chunk];
+
+    for (std::size_t start = 0; start < n; start += Chunk) {
+        const auto m = std::min(Chunk, n - start);
+        const Scalar *d = delta + 3 * start;
+
+        for (std::size_t i = 0; i < m; ++i) {
+            const Scalar vx = d[3 * i], vy = d[3 * i + 1], vz = d[3 * i + 2];
+            Scalar s, c;
+            Policy::halfAngle(vx * vx + vy * vy + vz * vz, s, c);
+            dq[0][i] = s * vx;
+            dq[1][i] = s * vy;
+            dq[2][i] = s * vz;
+            dq[3][i] = c;
+        }
+
+        // Quaternion product dq * q, storage order x, y, z, w
+        for (std::size_t i = 0; i < m; ++i) {
+            Scalar *q = x[start + i].value().coeffs().data();
+            const Scalar ax = dq[0][i], ay = dq[1][i], az = dq[2][i], aw = dq[3][i];
+            const Scalar bx = q[0], by = q[1], bz = q[2], bw = q[3];
+            Scalar rx = aw * bx + ax * bw + ay * bz - az * by;
+            Scalar ry = aw * by - ax * bz + ay * bw + az * bx;
+            Scalar rz = aw * bz + ax * by - ay * bx + az * bw;
+            Scalar rw = aw * bw - ax * bx - ay * by - az * bz;
+            if (opt.renormalize_quaternions) {
+                const Scalar inv_norm = 1 / sqrt(rx * rx + ry * ry + rz * rz + rw * rw);
+                rx *= inv_norm;
+                ry *= inv_norm;
+                rz *= inv_norm;
+                rw *= inv_norm;
+            }
+            q[0] = rx;
+            q[1] = ry;
+            q[2] = rz;
+            q[3] = rw;
+        }
+    }
+}
+
+/** Box-plus of rotation matrices */
+template <typename Policy, typename Scalar>
+void boxPlusRange(Policy,
+                  MatrixRotation<Eigen::Matrix<Scalar, 3, 3>> *x,
+                  const Scalar *delta,
+                  std::size_t n,
+                  const BoxPlusOptions &) {
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto phi = Eigen::Map<const Eigen::Matrix<Scalar, 3, 1>>{delta + 3 * i};
+        x[i].value() = retractionMatrix<Policy>(phi) * x[i].value();
+    }
+}
+
+/** Box-plus of rigid transforms with a cheap retraction
+ *
+ * The rotation is updated by the policy, and the translation by
+ * @f$ t \leftarrow \rho(\phi) t + \delta_t @f$. This agrees with the exponential map
+ * of the twist to first order.
+ */
+template <typename Policy,
+          typename QuatType,
+          typename VecType,
+          typename Scalar,
+          TICK_REQUIRES(!std::is_same<Policy, ExpRetraction>{})>
+void boxPlusRange(Policy,
+                  CompactRigidTransform<QuatType, VecType> *x,
+                  const Scalar *delta,
+                  std::size_t n,
+                  const BoxPlusOptions &opt) {
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto phi = Eigen::Map<const Eigen::Matrix<Scalar, 3, 1>>{delta + 6 * i};
+        const auto rho = Eigen::Map<const Eigen::Matrix<Scalar, 3, 1>>{delta + 6 * i + 3};
+        const auto dq = retractionQuaternion<Policy>(phi);
+        auto &q = x[i].rotationBlock().value();
+        auto &t = x[i].translationBlock().value();
+        q = dq * q;
+        t = dq * t + rho;
+        renormalizeQuaternions(x[i], opt);
+    }
+}
+
+template <typename Policy,
+          typename ImplType,
+          typename Scalar,
+          TICK_REQUIRES(!std::is_same<Policy, ExpRetraction>{})>
+void boxPlusRange(Policy,
+                  MatrixRigidTransform<ImplType> *x,
+                  const Scalar *delta,
+                  std::size_t n,
+                  const BoxPlusOptions &) {
+    for (std::size_t i = 0; i < n; ++i) {
+        const auto phi = Eigen::Map<const Eigen::Matrix<Scalar, 3, 1>>{delta + 6 * i};
+        const auto rho = Eigen::Map<const Eigen::Matrix<Scalar, 3, 1>>{delta + 6 * i + 3};
+        const Eigen::Matrix<Scalar, 3, 3> dR = retractionMatrix<Policy>(phi);
+        auto &m = x[i].value();
+        m.template topLeftCorner<3, 3>() = dR * m.template topLeftCorner<3, 3>();
+        m.template topRightCorner<3, 1>() = dR * m.template topRightCorner<3, 1>() + rho;
+    }
+}
+
+/** Applies box-plus to all variables of one type, splitting them into tasks */
+template <typename Policy, typename Leaf, typename Scalar>
+void boxPlusGroup(Policy policy,
+                  std::vector<Leaf, Eigen::aligned_allocator<Leaf>> &values,
+                  const Scalar *delta,
+                  const BoxPlusOptions &opt) {
+    parallelChunks(opt.pool,
+                   values.size(),
+                   opt.grain_size,
+                   [&](std::size_t, std::size_t start, std::size_t end) {
+                       boxPlusRange(policy,
+                                    values.data() + start,
+                                    delta + start * traits<Leaf>::TangentSize,
+                                    end - start,
+                                    opt);
+                   });
+}
+
+}  // namespace internal
+
+/** Applies box-plus to every variable in the store, with a retraction policy per type
+ *
+ * Sets each variable @f$ x_i @f$ to @f$ \rho(\delta_i) x_i @f$, where @f$ \rho @f$ is
+ * the retraction chosen for its type (see ExpRetraction), so that the update has the
+ * same (left) convention as `x + delta` on a single leaf. The variables are updated a
+ * type at a time, in tight loops over contiguous memory. If a pool is given in
+ * `options`, each large group is split across its threads.
+ *
+ * Cheap policies apply to rotations and rigid transforms stored as quaternions or
+ * matrices. Vector leaves are always summed, and other leaves use the exact map.
+ *
+ * @param store the variables to update
+ * @param delta stacked tangent-space update, laid out as described in VariableStore
+ * @param options see BoxPlusOptions
+ */
+template <typename... Leaves, typename Derived, typename... Policies>
+void boxPlus(VariableStore<Leaves...> &store,
+             const Eigen::MatrixBase<Derived> &delta,
+             Retractions<Policies...>,
+             const BoxPlusOptions &options = {}) {
+    static_assert(sizeof...(Policies) == sizeof...(Leaves),
+                  "There must be one retraction policy for each type in the store");
+    using Scalar = typename Derived::Scalar;
+    assert(static_cast<std::size_t>(delta.size()) == store.tangentSize());
+
+    // Use the vector's memory directly if it is contiguous
+    const Eigen::Ref<const Eigen::Matrix<Scalar, Eigen::Dynamic, 1>> d{delta};
+    std::size_t offset = 0;
+    (void) std::initializer_list<int>{
+      (internal::boxPlusGroup(
+         Policies{}, store.template values<Leaves>(), d.data() + offset, options),
+       offset += store.template values<Leaves>().size() *
+                 internal::traits<Leaves>::TangentSize,
+       0)...};
+}
+
+/** Applies box-plus to every variable in the store, with the exact exponential map */
+template <typename... Leaves, typename Derived>
+void boxPlus(VariableStore<Leaves...> &store,
+             const Eigen::MatrixBase<Derived> &delta,
+             const BoxPlusOptions &options = {}) {
+    boxPlus(store,
+            delta,
+            Retractions<typename internal::repeat_for<ExpRetraction, Leaves>::type...>{},
+            options);
+}
+
+/** Returns a single leaf updated by a retraction policy, as boxPlus() would */
+template <typename Policy, typename Leaf, typename Derived>
+Leaf retract(const Leaf &x,
+             const Eigen::MatrixBase<Derived> &delta,
+             const BoxPlusOptions &options = {}) {
+    auto result = x;
+    const Eigen::Matrix<typename Derived::Scalar, internal::traits<Leaf>::TangentSize, 1>
+      d = delta;
+    internal::boxPlusRange(Policy{}, &result, d.data(), 1, options);
+    return result;
+}
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_VARIABLESTORE_HPP
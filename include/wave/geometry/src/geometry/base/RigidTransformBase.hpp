@@ -16,6 +16,31 @@ class RigidTransformBase : public TransformBase<Derived> {
     using BaseTmpl = RigidTransformBase<T>;
 };
 
+/** Auxilliary struct for the translation of the inverse of a rigid transform
+ *
+ * Used for `inverse(a).translation()`, which is `-(R^T t)` for a transform `(R, t)`.
+ */
+template <typename Derived>
+struct InverseTranslationGetter {
+    using Frames = internal::
+      WrapWithFrames<RightFrameOf<Derived>, RightFrameOf<Derived>, LeftFrameOf<Derived>>;
+
+    template <typename BareTf>
+    static auto get(const BareTf &leaf) {
+        return eval(-(inverse(leaf.rotationBlock()) * leaf.translationBlock()));
+    }
+
+    template <typename Trans, typename Rt>
+    static auto jacobian(const Trans &, const Rt &rt) -> BlockMatrix<Trans, Rt> {
+        using Mat3 = Eigen::Matrix<internal::scalar_t<Rt>, 3, 3>;
+        auto jac = BlockMatrix<Trans, Rt>{};
+        // Under a left perturbation of the transform, the rotation terms cancel
+        jac.template colsWrt<0>().setZero();
+        jac.template colsWrt<1>() = -Mat3{rt.rotationBlock().value()}.transpose();
+        return jac;
+    }
+};
+
 /** Transforms a point. Also known as a coordinate map.
  *
  * @f[ SO(3) \times R^3 \to R^3 @f]
@@ -117,6 +142,49 @@ auto evalImpl(expr<Compose>,
     return res;
 }
 
+template <typename T>
+using enable_if_rigid_t =
+  std::enable_if_t<std::is_base_of<RigidTransformBase<tmp::remove_cr_t<T>>,
+                                   tmp::remove_cr_t<T>>{},
+                   bool>;
+
+/** Rewrites `(a * b).rotation()` as `a.rotation() * b.rotation()`
+ *
+ * Neither translation is evaluated, and the Jacobians are only the rotation blocks.
+ */
+template <typename Derived, enable_if_rigid_t<Derived> = true>
+auto rotationOf(expr<Compose>, Derived &&c) {
+    return std::forward<Derived>(c).lhs().rotation() *
+           std::forward<Derived>(c).rhs().rotation();
+}
+
+/** Rewrites `(a * b).translation()` as `a * b.translation()`
+ *
+ * The rotation of b is not evaluated.
+ */
+template <typename Derived, enable_if_rigid_t<Derived> = true>
+auto translationOf(expr<Compose>, Derived &&c) {
+    return std::forward<Derived>(c).lhs() * std::forward<Derived>(c).rhs().translation();
+}
+
+/** Rewrites `inverse(a).rotation()` as `inverse(a.rotation())` */
+template <typename Derived, enable_if_rigid_t<Derived> = true>
+auto rotationOf(expr<Inverse>, Derived &&inv) {
+    return inverse(std::forward<Derived>(inv).rhs().rotation());
+}
+
+/** Rewrites `inverse(a).translation()` to compute only the translation of the inverse
+ *
+ * The expression `-(inverse(a.rotation()) * a.translation())` would be equivalent, but
+ * would not have unique leaves.
+ */
+template <typename Derived, enable_if_rigid_t<Derived> = true>
+auto translationOf(expr<Inverse>, Derived &&inv) {
+    using Rhs = tmp::remove_cr_t<decltype(std::forward<Derived>(inv).rhs())>;
+    return memberAccess<InverseTranslationGetter<Rhs>>(
+      std::forward<Derived>(inv).rhs());
+}
+
 /** Implementation of LogMap for any rigid transform
  */
 template <typename Rhs>
@@ -137,7 +205,7 @@ auto evalImpl(expr<LogMap>, const RigidTransformBase<Rhs> &rhs) ->
     if (theta2 > Eigen::NumTraits<Scalar>::epsilon()) {
         const auto A = std::sin(theta) / theta;
         const auto B = (1 - std::cos(theta)) / theta2;
-        const Mat3 cross = crossMatrix(omega);
+        const auto cross = crossMatrix(omega);
         const Mat3 cross2 = cross * cross;
 
         const Mat3 Vinv =
@@ -148,7 +216,7 @@ auto evalImpl(expr<LogMap>, const RigidTransformBase<Rhs> &rhs) ->
     } else {
         // small theta2; use limit as theta -> 0
         // @todo: use Taylor series, not just the limit!
-        const Mat3 cross = crossMatrix(omega);
+        const auto cross = crossMatrix(omega);
 
         const Mat3 Vinv = Mat3::Identity() - cross / 2;
 
@@ -170,21 +238,32 @@ auto jacobianImpl(expr<LogMap>,
 
     using std::cos;
     using std::sin;
+    using std::sqrt;
     // First get Jacobian of logmap of rotation part only
     const auto &Drot =
       jacobianImpl(expr<LogMap>{}, val.derived().rotation(), rhs.derived().rotation());
 
     const auto &omega = val.derived().rotation().value();
     const auto &u = val.derived().translation().value();
-    const auto theta2 = omega.squaredNorm();
-    const auto theta = sqrt(theta2);
-    const auto a = sin(theta) / theta;
-    const auto b = (1 - cos(theta)) / theta2;
-    const auto c = (1 - a) / theta2;
+    const Scalar theta2 = omega.squaredNorm();
+    Scalar b, c, w_cross, w_outer;
+    if (theta2 > sqrt(Eigen::NumTraits<Scalar>::epsilon())) {
+        const auto theta = sqrt(theta2);
+        const auto a = sin(theta) / theta;
+        b = (1 - cos(theta)) / theta2;
+        c = (1 - a) / theta2;
+        w_cross = (a - 2 * b) / theta2;
+        w_outer = (b - 3 * c) / theta2;
+    } else {
+        // Small angle: the terms above cancel catastrophically, so use Taylor series
+        b = Scalar{0.5} - theta2 / 24;
+        c = Scalar{1} / 6 - theta2 / 120;
+        w_cross = Scalar{-1} / 12 + theta2 / 180;
+        w_outer = Scalar{-1} / 60 + theta2 / 1260;
+    }
     // Calculate Eade's "W" term
-    const Mat3 W = (c - b) * Mat3::Identity() +
-                   (a - 2 * b) / theta2 * crossMatrix(omega) +
-                   (b - 3 * c) / theta2 * omega * omega.transpose();
+    const Mat3 W = (c - b) * Mat3::Identity() + w_cross * crossMatrix(omega) +
+                   w_outer * omega * omega.transpose();
 
     // Calculate Eade's "B" term
     const Mat3 B = b * crossMatrix(u) +
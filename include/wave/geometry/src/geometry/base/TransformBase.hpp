@@ -22,11 +22,11 @@ struct RotationGetter {
 
     template <typename Rot, typename Rt>
     static auto jacobian(const Rot &, const Rt &) {
-        //@todo optimize with sparse block matrix
-        auto jac = BlockMatrix<Rot, Rt>{};
-        jac.template colsWrt<1>().setZero();
-        jac.template colsWrt<0>().setIdentity();
-        return jac;
+        // The rotation is the first block of the transform's tangent
+        return IdentityBlockMatrix<internal::scalar_t<Rt>,
+                                   internal::traits<Rot>::TangentSize,
+                                   internal::traits<Rt>::TangentSize,
+                                   0>{};
     }
 };
 
@@ -53,6 +53,33 @@ struct TranslationGetter {
     }
 };
 
+namespace internal {
+
+/** Makes the expression for `.rotation()` of a transform expression
+ *
+ * By default the whole transform is evaluated and the block taken from the result.
+ * Expressions whose rotation can be found from a part of their operands overload this
+ * function for their tag. It is called unqualified, so the overloads are found by ADL
+ * and may be declared after this file.
+ */
+template <typename Tag, typename Derived>
+auto rotationOf(Tag, Derived &&expr) {
+    return memberAccess<RotationGetter<tmp::remove_cr_t<Derived>>>(
+      std::forward<Derived>(expr));
+}
+
+/** Makes the expression for `.translation()` of a transform expression
+ *
+ * @see rotationOf
+ */
+template <typename Tag, typename Derived>
+auto translationOf(Tag, Derived &&expr) {
+    return memberAccess<TranslationGetter<tmp::remove_cr_t<Derived>>>(
+      std::forward<Derived>(expr));
+}
+
+}  // namespace internal
+
 /** Base class for transform-like expressions including SO(3) (RotationBase) and SE(3)
  * (RigidTransformBase)
  */
@@ -69,29 +96,30 @@ class TransformBase : public ExpressionBase<Derived> {
  public:
     /** Gets an expression representing the translation part of the transform */
     auto translation() const & {
-        return internal::memberAccess<TranslationGetter<Derived>>(this->derived());
+        return translationOf(internal::get_expr_tag_t<Derived>{}, this->derived());
     }
 
     auto translation() & {
-        return internal::memberAccess<TranslationGetter<Derived>>(this->derived());
+        return translationOf(internal::get_expr_tag_t<Derived>{}, this->derived());
     }
 
     auto translation() && {
-        return internal::memberAccess<TranslationGetter<Derived>>(
-          std::move(*this).derived());
+        return translationOf(internal::get_expr_tag_t<Derived>{},
+                             std::move(*this).derived());
     }
 
     /** Gets an expression representing the rotation part of the transform */
     auto rotation() const & {
-        return internal::memberAccess<RotationGetter<Derived>>(this->derived());
+        return rotationOf(internal::get_expr_tag_t<Derived>{}, this->derived());
     }
 
     auto rotation() & {
-        return internal::memberAccess<RotationGetter<Derived>>(this->derived());
+        return rotationOf(internal::get_expr_tag_t<Derived>{}, this->derived());
     }
 
     auto rotation() && {
-        return internal::memberAccess<RotationGetter>(std::move(*this).derived());
+        return rotationOf(internal::get_expr_tag_t<Derived>{},
+                          std::move(*this).derived());
     }
 
     /** Produce a random element */
@@ -51,7 +51,10 @@ namespace internal {
 template <typename ImplType>
 struct traits<MatrixRotation<ImplType>>
     : rotation_leaf_traits_base<MatrixRotation<ImplType>> {
-    using PlainType = MatrixRotation<typename ImplType::PlainObject>;
+    // Always a column-major matrix. The PlainObject of a transposed view (the result of
+    // Inverse) would be row-major, and mixing storage orders costs a conversion later.
+    using PlainType =
+      MatrixRotation<Eigen::Matrix<typename Eigen::internal::traits<ImplType>::Scalar, 3, 3>>;
 };
 
 /** Implements inverse of a rotation matrix */
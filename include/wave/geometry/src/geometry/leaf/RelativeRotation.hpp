@@ -119,7 +119,7 @@ auto evalImpl(expr<ExpMap>, const RelativeRotation<ImplType> &rhs) {
         s = sa / angle;
         c = cos(angle / 2);
     } else {
-        s = Scalar{0.5} + angle2 / 48;
+        s = Scalar{0.5} - angle2 / 48;
         c = 1 - angle2 / 8;
     }
 
@@ -110,7 +110,7 @@ auto evalImpl(expr<ExpMap>, const Twist<ImplType> &rhs) ->
         const auto A = std::sin(theta) / theta;
         const auto B = (Scalar{1.0} - std::cos(theta)) / theta2;
         const auto C = (Scalar{1.0} - A) / theta2;
-        const Mat3 cross = crossMatrix(omega);
+        const auto cross = crossMatrix(omega);
         const Mat3 cross2 = cross * cross;
         const Mat3 V = Mat3::Identity() + B * cross + C * cross2;
         out.translationBlock().value() = V * rhs.translation().value();
@@ -120,7 +120,7 @@ auto evalImpl(expr<ExpMap>, const Twist<ImplType> &rhs) ->
         const auto A = Scalar{1.0};
         const auto B = Scalar{0.0};
         const auto C = Scalar{0.0};
-        const Mat3 cross = crossMatrix(omega);
+        const auto cross = crossMatrix(omega);
         const Mat3 cross2 = cross * cross;
         const Mat3 V = Mat3::Identity() + B * cross + C * cross2;
         out.translationBlock().value() = V * rhs.translation().value();
@@ -12,16 +12,16 @@ namespace wave {
  * @f[ SO(3) \times SO(3) \to so(3) @f] or
  * @f[ SE(3) \times SE(3) \to se(3) @f]
  *
- * `BoxMinus<Lhs, Rhs>` is equivalent to `LogMap<RightFrameOf<R>, Compose<Lhs,
- * Inverse<Rhs>>>`.
+ * `BoxMinus<Lhs, Rhs>` has the same value as `LogMap<RightFrameOf<R>, Compose<Lhs,
+ * Inverse<Rhs>>>`, but is evaluated in one step, with closed-form Jacobians.
  */
 template <typename Lhs, typename Rhs>
 struct BoxMinus : internal::base_tmpl_t<typename internal::eval_traits<Lhs>::TangentType,
                                         typename internal::eval_traits<Rhs>::TangentType,
                                         BoxMinus<Lhs, Rhs>>,
-                  UnaryStorage<BoxMinus<Lhs, Rhs>, Compose<Lhs, Inverse<Rhs>>> {
+                  internal::binary_storage_for<BoxMinus<Lhs, Rhs>> {
  private:
-    using Storage = UnaryStorage<BoxMinus<Lhs, Rhs>, Compose<Lhs, Inverse<Rhs>>>;
+    using Storage = internal::binary_storage_for<BoxMinus<Lhs, Rhs>>;
 
  public:
     // Inherit constructors from BinaryStorage
@@ -54,13 +54,223 @@ struct CompoundBoxMinus
 
 namespace internal {
 
-/** We implement BoxMinus as a "heavy alias": it is meant to act exactly like the LogMap
- * expression. See also BoxPlus.
+template <typename Lhs, typename Rhs>
+struct traits<BoxMinus<Lhs, Rhs>> : binary_traits_base<BoxMinus<Lhs, Rhs>> {
+    using OutputFunctor =
+      WrapWithFrames<LeftFrameOf<Lhs>, LeftFrameOf<Lhs>, RightFrameOf<Rhs>>;
+};
+
+/** Log map of a rotation, with the sine and cosine of its angle
+ *
+ * The trigonometric terms are kept so the SE(3) log map can reuse them.
  */
+template <typename Scalar>
+struct RotationLog {
+    /** Computes the log map of a rotation matrix */
+    template <typename Derived>
+    explicit RotationLog(const Eigen::MatrixBase<Derived> &m) {
+        using std::atan2;
+        // From http://ethaneade.com/lie.pdf. The norm of the vee term is 2 sin(theta),
+        // which gives the angle more accurately than acos() of the trace.
+        const auto vee = Eigen::Matrix<Scalar, 3, 1>{
+          m(2, 1) - m(1, 2), m(0, 2) - m(2, 0), m(1, 0) - m(0, 1)};
+        sin_theta = Scalar{0.5} * vee.norm();
+        cos_theta = Scalar{0.5} * (m.trace() - Scalar{1});
+        theta = atan2(sin_theta, cos_theta);
+        if (sin_theta > Eigen::NumTraits<Scalar>::epsilon()) {
+            phi = theta / (Scalar{2} * sin_theta) * vee;
+        } else {
+            // Very small angle
+            phi = Scalar{0.5} * vee;
+        }
+    }
+
+    /** Computes the log map of a unit quaternion, without converting it to a matrix */
+    template <typename Derived>
+    explicit RotationLog(const Eigen::QuaternionBase<Derived> &q_in) {
+        using std::atan2;
+        // Use the quaternion with non-negative w, so the angle is in [0, pi]
+        const auto sign = q_in.w() < Scalar{0} ? Scalar{-1} : Scalar{1};
+        const auto w = sign * q_in.w();
+        const Eigen::Matrix<Scalar, 3, 1> v = sign * q_in.vec();
+        const auto n = v.norm();
+        theta = Scalar{2} * atan2(n, w);
+        // Double-angle formulas for a unit quaternion
+        sin_theta = Scalar{2} * n * w;
+        cos_theta = w * w - n * n;
+        if (n > Eigen::NumTraits<Scalar>::epsilon()) {
+            phi = theta / n * v;
+        } else {
+            // Very small angle
+            phi = Scalar{2} / w * v;
+        }
+    }
+
+    /** Applies the inverse of the left Jacobian of SO(3) to a vector
+     *
+     * This is the translation part of the SE(3) log map.
+     */
+    template <typename Derived>
+    Eigen::Matrix<Scalar, 3, 1> applyInverseJacobian(
+      const Eigen::MatrixBase<Derived> &t) const {
+        const auto coeff = inverseJacobianCoeff(theta, sin_theta, cos_theta);
+        const Eigen::Matrix<Scalar, 3, 1> phi_t = phi.cross(t);
+        return t - Scalar{0.5} * phi_t + coeff * phi.cross(phi_t);
+    }
+
+    Eigen::Matrix<Scalar, 3, 1> phi;
+    Scalar theta;
+    Scalar sin_theta;
+    Scalar cos_theta;
+};
+
+/** Box-minus of SE(3) elements given by rotation matrices and translations
+ *
+ * Computes log(A * B^-1) without forming the inverse, sharing the trigonometric terms of
+ * the rotation and translation parts.
+ */
+template <typename Scalar, typename RA, typename TA, typename RB, typename TB>
+auto boxMinusRigid(const Eigen::MatrixBase<RA> &Ra,
+                   const Eigen::MatrixBase<TA> &ta,
+                   const Eigen::MatrixBase<RB> &Rb,
+                   const Eigen::MatrixBase<TB> &tb) -> Twist<Eigen::Matrix<Scalar, 6, 1>> {
+    const Eigen::Matrix<Scalar, 3, 3> Rc = Ra * Rb.transpose();
+    const auto log = RotationLog<Scalar>{Rc};
+    return Twist<Eigen::Matrix<Scalar, 6, 1>>{
+      log.phi, log.applyInverseJacobian(ta - Rc * tb)};
+}
+
+/** Fallback implementation of BoxMinus for any transforms, as log(lhs * inverse(rhs)) */
+template <typename Lhs, typename Rhs>
+auto evalImpl(expr<BoxMinus>,
+              const TransformBase<Lhs> &lhs,
+              const TransformBase<Rhs> &rhs) {
+    return eval(log(lhs.derived() * inverse(rhs.derived())));
+}
+
+/** Implements BoxMinus of rotation matrices
+ *
+ * A * B^-1 is a transpose-multiply, and the log map reads the result directly.
+ */
+template <typename Lhs, typename Rhs>
+auto evalImpl(expr<BoxMinus>,
+              const MatrixRotation<Lhs> &lhs,
+              const MatrixRotation<Rhs> &rhs) ->
+  typename traits<MatrixRotation<Lhs>>::TangentType {
+    using Scalar = scalar_t<MatrixRotation<Lhs>>;
+    const Eigen::Matrix<Scalar, 3, 3> m = lhs.value() * rhs.value().transpose();
+    return typename traits<MatrixRotation<Lhs>>::TangentType{RotationLog<Scalar>{m}.phi};
+}
+
+/** Implements BoxMinus of quaternions, taking the log map of the quaternion directly */
+template <typename Lhs, typename Rhs>
+auto evalImpl(expr<BoxMinus>,
+              const QuaternionRotation<Lhs> &lhs,
+              const QuaternionRotation<Rhs> &rhs) ->
+  typename traits<QuaternionRotation<Lhs>>::TangentType {
+    using Scalar = scalar_t<QuaternionRotation<Lhs>>;
+    const Eigen::Quaternion<Scalar> q = lhs.value() * rhs.value().conjugate();
+    return
+      typename traits<QuaternionRotation<Lhs>>::TangentType{RotationLog<Scalar>{q}.phi};
+}
+
+/** Implements BoxMinus of rigid transform matrices */
 template <typename Lhs, typename Rhs>
-struct traits<BoxMinus<Lhs, Rhs>>
-    : traits<LogMap<RightFrameOf<Rhs>, Compose<Lhs, Inverse<Rhs>>>> {};
+auto evalImpl(expr<BoxMinus>,
+              const MatrixRigidTransform<Lhs> &lhs,
+              const MatrixRigidTransform<Rhs> &rhs) {
+    return boxMinusRigid<scalar_t<MatrixRigidTransform<Lhs>>>(
+      lhs.rotationBlock().value(),
+      lhs.translationBlock().value(),
+      rhs.rotationBlock().value(),
+      rhs.translationBlock().value());
+}
+
+/** Implements BoxMinus of compact rigid transforms
+ *
+ * The rotation is taken as a quaternion product, and converted to a matrix once to
+ * rotate the translation.
+ */
+template <typename QL, typename VL, typename QR, typename VR>
+auto evalImpl(expr<BoxMinus>,
+              const CompactRigidTransform<QL, VL> &lhs,
+              const CompactRigidTransform<QR, VR> &rhs)
+  -> Twist<Eigen::Matrix<scalar_t<CompactRigidTransform<QL, VL>>, 6, 1>> {
+    using Scalar = scalar_t<CompactRigidTransform<QL, VL>>;
+    const Eigen::Quaternion<Scalar> q =
+      lhs.rotationBlock().value() * rhs.rotationBlock().value().conjugate();
+    const auto log = RotationLog<Scalar>{q};
+    const Eigen::Matrix<Scalar, 3, 1> t =
+      lhs.translationBlock().value() - q * rhs.translationBlock().value();
+    return Twist<Eigen::Matrix<Scalar, 6, 1>>{log.phi, log.applyInverseJacobian(t)};
+}
+
+/** Jacobian of BoxMinus of rotations wrt the lhs
+ *
+ * This is the inverse of the left Jacobian of SO(3) at the result,
+ * @f$ J_l^{-1}(\phi) = I - \frac{1}{2} [\phi]_\times + k [\phi]_\times^2 @f$.
+ * It only uses the result, thus is independent of the rotation parametrization.
+ */
+template <typename Val, typename Lhs, typename Rhs>
+auto leftJacobianImpl(expr<BoxMinus>,
+                      const RelativeRotation<Val> &val,
+                      const RotationBase<Lhs> &,
+                      const RotationBase<Rhs> &)
+  -> jacobian_t<RelativeRotation<Val>, Lhs> {
+    using Scalar = scalar_t<RelativeRotation<Val>>;
+    using Jacobian = jacobian_t<RelativeRotation<Val>, Lhs>;
+    const auto &phi = val.value();
+    const auto cross = crossMatrix(phi);
+    return Jacobian::Identity() - Scalar{0.5} * cross +
+           inverseJacobianCoeff(phi.squaredNorm()) * (cross * cross);
+}
 
+/** Jacobian of BoxMinus of rotations wrt the rhs
+ *
+ * This is the negative inverse of the right Jacobian of SO(3) at the result,
+ * @f$ -J_r^{-1}(\phi) = -(I + \frac{1}{2} [\phi]_\times + k [\phi]_\times^2) @f$,
+ * with the same coefficient k as the lhs Jacobian.
+ */
+template <typename Val, typename Lhs, typename Rhs>
+auto rightJacobianImpl(expr<BoxMinus>,
+                       const RelativeRotation<Val> &val,
+                       const RotationBase<Lhs> &,
+                       const RotationBase<Rhs> &)
+  -> jacobian_t<RelativeRotation<Val>, Rhs> {
+    using Scalar = scalar_t<RelativeRotation<Val>>;
+    using Jacobian = jacobian_t<RelativeRotation<Val>, Rhs>;
+    const auto &phi = val.value();
+    const auto cross = crossMatrix(phi);
+    return -Jacobian::Identity() - Scalar{0.5} * cross -
+           inverseJacobianCoeff(phi.squaredNorm()) * (cross * cross);
+}
+
+/** Jacobian of BoxMinus of rigid transforms wrt the lhs
+ *
+ * This is the inverse of the left Jacobian of SE(3) at the result, the same as the
+ * Jacobian of the log map.
+ */
+template <typename Val, typename Lhs, typename Rhs>
+auto leftJacobianImpl(expr<BoxMinus>,
+                      const TwistBase<Val> &val,
+                      const RigidTransformBase<Lhs> &lhs,
+                      const RigidTransformBase<Rhs> &) -> jacobian_t<Val, Lhs> {
+    return jacobianImpl(expr<LogMap>{}, val.derived(), lhs.derived());
+}
+
+/** Jacobian of BoxMinus of rigid transforms wrt the rhs
+ *
+ * This is the negative inverse of the right Jacobian of SE(3) at the result. Since
+ * @f$ J_r(\xi) = J_l(-\xi) @f$, it is the negative Jacobian of the log map at -xi.
+ */
+template <typename Val, typename Lhs, typename Rhs>
+auto rightJacobianImpl(expr<BoxMinus>,
+                       const TwistBase<Val> &val,
+                       const RigidTransformBase<Lhs> &,
+                       const RigidTransformBase<Rhs> &rhs) -> jacobian_t<Val, Rhs> {
+    const auto negated = plain_eval_t<Val>{-val.derived().value()};
+    return -jacobianImpl(expr<LogMap>{}, negated, rhs.derived());
+}
 
 template <typename Lhs, typename Rhs>
 struct traits<CompoundBoxMinus<Lhs, Rhs>>
@@ -53,6 +53,47 @@ struct traits<ComposeFlipped<Lhs, Rhs>> : binary_traits_base<ComposeFlipped<Lhs,
     using OutputFunctor = WrapWithFrames<LeftFrameOf<Rhs>, RightFrameOf<Lhs>>;
 };
 
+template <typename T>
+struct is_compose : std::false_type {};
+
+template <typename Lhs, typename Rhs>
+struct is_compose<Compose<Lhs, Rhs>> : std::true_type {};
+
+/** Applies lhs to rhs with Tmpl (Rotate or Transform), referring to lhs */
+template <template <typename, typename> class Tmpl, typename Lhs, typename Rhs>
+auto applyChain(const Lhs &lhs, Rhs &&rhs) -> Tmpl<const Lhs &, Rhs> {
+    return Tmpl<const Lhs &, Rhs>{lhs, std::forward<Rhs>(rhs)};
+}
+
+/** Applies `a * b` to rhs as `a * (b * rhs)`, recursing into a and b */
+template <template <typename, typename> class Tmpl, typename A, typename B, typename Rhs>
+auto applyChain(const Compose<A, B> &lhs, Rhs &&rhs) {
+    return applyChain<Tmpl>(lhs.lhs(),
+                            applyChain<Tmpl>(lhs.rhs(), std::forward<Rhs>(rhs)));
+}
+
+/** Evaluates `R1 * ... * RN * v` as `R1 * (... * (RN * v))` when only the value is
+ * needed
+ *
+ * This takes N products of a rotation with a vector instead of N - 1 products of
+ * rotations. Jacobians are not rewritten: forward-mode Jacobians reuse the values of the
+ * composed rotations.
+ */
+template <typename Lhs, typename Rhs, TICK_REQUIRES(is_compose<tmp::remove_cr_t<Lhs>>{})>
+auto rewriteForValue(adl, const Rotate<Lhs, Rhs> &expr) {
+    return applyChain<Rotate>(expr.lhs(), expr.rhs());
+}
+
+/** Evaluates `T1 * ... * TN * p` as `T1 * (... * (TN * p))` when only the value is
+ * needed
+ *
+ * @see rewriteForValue(adl, const Rotate<Lhs, Rhs> &)
+ */
+template <typename Lhs, typename Rhs, TICK_REQUIRES(is_compose<tmp::remove_cr_t<Lhs>>{})>
+auto rewriteForValue(adl, const Transform<Lhs, Rhs> &expr) {
+    return applyChain<Transform>(expr.lhs(), expr.rhs());
+}
+
 /** Left Jacobian of any composition is identity */
 template <typename Val, typename Lhs, typename Rhs>
 auto leftJacobianImpl(expr<Compose>,
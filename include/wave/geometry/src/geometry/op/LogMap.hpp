@@ -31,6 +31,43 @@ struct traits<LogMap<ExtraFrame, Rhs>>
     using OutputFunctor = WrapWithFrames<LeftFrameOf<Rhs>, LeftFrameOf<Rhs>, ExtraFrame>;
 };
 
+/** Coefficient of @f$ [\phi]_\times^2 @f$ in the inverse left and right Jacobians of
+ * SO(3), given the rotation angle and its sine and cosine
+ *
+ * From http://ethaneade.org/exp_diff.pdf. The closed form loses about eps / theta^2 of
+ * relative precision, so below theta^2 = 0.01 the Taylor series is used instead, whose
+ * truncation error is then as small.
+ */
+template <typename Scalar>
+Scalar inverseJacobianCoeff(const Scalar &theta,
+                            const Scalar &sin_theta,
+                            const Scalar &cos_theta) {
+    const auto theta2 = theta * theta;
+    if (theta2 > Scalar{0.01}) {
+        // 1 - cos(theta) is 2 sin^2(theta / 2), found without cancellation from the
+        // sine and cosine of theta
+        const Scalar one_minus_cos = cos_theta > 0
+                                       ? sin_theta * sin_theta / (Scalar{1} + cos_theta)
+                                       : Scalar{1} - cos_theta;
+        return (Scalar{1} - theta * sin_theta / (Scalar{2} * one_minus_cos)) / theta2;
+    } else {
+        return Scalar{1} / Scalar{12} +
+               theta2 * (Scalar{1} / Scalar{720} +
+                         theta2 * (Scalar{1} / Scalar{30240} + theta2 / Scalar{1209600}));
+    }
+}
+
+/** Coefficient of @f$ [\phi]_\times^2 @f$ in the inverse left and right Jacobians of
+ * SO(3), given the squared rotation angle */
+template <typename Scalar>
+Scalar inverseJacobianCoeff(const Scalar &theta2) {
+    using std::cos;
+    using std::sin;
+    using std::sqrt;
+    const auto theta = sqrt(theta2);
+    return inverseJacobianCoeff(theta, Scalar{sin(theta)}, Scalar{cos(theta)});
+}
+
 /** Jacobian of logmap of any rotation
  *
  * It only uses the result, thus is independent of the rotation parametrization.
@@ -42,21 +79,9 @@ auto jacobianImpl(expr<LogMap>,
     using Scalar = scalar_t<Rhs>;
     using Jacobian = jacobian_t<RelativeRotation<Val>, Rhs>;
     const auto &phi = val.value();
-    // From http://ethaneade.org/exp_diff.pdf
-    using std::cos;
-    using std::sin;
-    const auto theta2 = phi.squaredNorm();
-    const auto theta = sqrt(theta2);
-    const auto A = sin(theta) / theta;
-    const auto B = (Scalar{1} - cos(theta)) / theta2;
-
-    //        if (theta2 > Eigen::NumTraits<Scalar>::epsilon()) {
-    return Jacobian::Identity() - Scalar{0.5} * crossMatrix(phi) +
-           ((B - Scalar{0.5} * A) / (Scalar{1} - cos(theta))) * crossMatrix(phi) *
-             crossMatrix(phi);
-    //        } else {
-    // @todo small input
-    //        }
+    const auto cross = crossMatrix(phi);
+    return Jacobian::Identity() - Scalar{0.5} * cross +
+           inverseJacobianCoeff(phi.squaredNorm()) * (cross * cross);
 }
 
 }  // namespace internal
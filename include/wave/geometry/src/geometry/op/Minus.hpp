@@ -31,9 +31,8 @@ struct traits<Minus<Rhs>, std::enable_if_t<has_three_decorators<Rhs>{}>>
 
 /** Jacobian implementation for all Minus */
 template <typename Res, typename Rhs>
-auto jacobianImpl(expr<Minus>, const Res &, const Rhs &) -> jacobian_t<Res, Rhs> {
-    // @todo rewrite in terms of our Identity expression
-    return -jacobian_t<Res, Rhs>::Identity();
+auto jacobianImpl(expr<Minus>, const Res &, const Rhs &) {
+    return -identity_t<Rhs>{};
 };
 
 }  // namespace internal
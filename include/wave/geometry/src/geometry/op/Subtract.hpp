@@ -111,8 +111,7 @@ auto leftJacobianImpl(expr<Subtract>, const Res &, const Lhs &, const Rhs &) {
 /** Jacobian implementation for all subtractions */
 template <typename Res, typename Lhs, typename Rhs>
 auto rightJacobianImpl(expr<Subtract>, const Res &, const Lhs &, const Rhs &) {
-    // @todo rewrite in terms of our Identity expression
-    return -jacobian_t<Res, Rhs>::Identity();
+    return -identity_t<Rhs>{};
 };
 
 }  // namespace internal
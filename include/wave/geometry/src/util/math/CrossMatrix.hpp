@@ -20,33 +20,33 @@ namespace wave {
  * In different works, `CrossMatrix(a)` might be written as @f$ a^{\times} @f$ or
  * @f$ \hat{a} @f$ .
  *
+ * The matrix is never stored: its coefficients are read from the vector when needed, and
+ * products with vectors, matrices and other cross-matrices are replaced by cross products
+ * or closed forms (see the operator* overloads below).
+ *
  * @tparam VecType the type of the vector expression
  */
 // The implementation of an Eigen expression here was guided by
 // https://eigen.tuxfamily.org/dox/TopicNewExpressionType.html
 template <class VecType>
-class CrossMatrix : public Eigen::Matrix<typename VecType::Scalar, 3, 3> {
+class CrossMatrix : public Eigen::MatrixBase<CrossMatrix<VecType>> {
  public:
     EIGEN_STATIC_ASSERT_VECTOR_SPECIFIC_SIZE(VecType, 3);
-    using MatrixType = Eigen::Matrix<typename VecType::Scalar, 3, 3>;
-    using Nested = typename Eigen::internal::ref_selector<CrossMatrix>::type;
+    using Base = Eigen::MatrixBase<CrossMatrix>;
+    EIGEN_DENSE_PUBLIC_INTERFACE(CrossMatrix)
+    using MatrixType = Eigen::Matrix<Scalar, 3, 3>;
     using VecTypeNested = typename Eigen::internal::ref_selector<VecType>::type;
 
-    using Scalar = typename VecType::Scalar;
-
     EIGEN_STRONG_INLINE
-    explicit CrossMatrix(const VecType &vec)
-        : MatrixType{(MatrixType{} << Scalar{0},
-                      -vec(2),
-                      vec(1),
-                      vec(2),
-                      Scalar{0},
-                      -vec(0),
-                      -vec(1),
-                      vec(0),
-                      Scalar{0})
-                       .finished()},
-          vec{vec} {}
+    explicit CrossMatrix(const VecType &vec) : vec{vec} {}
+
+    EIGEN_DEVICE_FUNC constexpr Eigen::Index rows() const noexcept {
+        return 3;
+    }
+
+    EIGEN_DEVICE_FUNC constexpr Eigen::Index cols() const noexcept {
+        return 3;
+    }
 
     using NegativeReturnType = CrossMatrix<typename VecType::NegativeReturnType>;
 
@@ -73,10 +73,16 @@ inline auto crossMatrix(const Eigen::MatrixBase<VecType> &&vec) -> CrossMatrix<V
     return CrossMatrix<VecType>(std::move(vec.derived()));
 }
 
-// Forward declaration
+// Forward declarations
 template <typename Scalar, int N>
 class IdentityMatrix;
 
+template <typename Scalar, int N>
+class NegativeIdentityMatrix;
+
+template <typename Scalar, int Rows, int Cols, int Offset>
+class IdentityBlockMatrix;
+
 }  // namespace wave
 
 namespace Eigen {
@@ -170,12 +176,20 @@ EIGEN_DEVICE_FUNC inline auto operator*(const Eigen::MatrixBase<OtherType> &lhs,
 
 /**
  * Multiply two cross-matrices
- * (needed to disambiguate)
+ *
+ * Uses the closed form @f$ a^\times b^\times = b a^T - (a \cdot b) I @f$, which for
+ * @f$ a = b @f$ is @f$ a a^T - |a|^2 I @f$.
  */
 template <typename Lhs, typename Rhs>
 EIGEN_DEVICE_FUNC inline auto operator*(const wave::CrossMatrix<Lhs> &lhs,
-                                        const wave::CrossMatrix<Rhs> &rhs) {
-    return lhs.rowwise().cross(rhs.vec);
+                                        const wave::CrossMatrix<Rhs> &rhs)
+  -> Eigen::Matrix<typename wave::CrossMatrix<Lhs>::Scalar, 3, 3> {
+    using Vector = Eigen::Matrix<typename wave::CrossMatrix<Lhs>::Scalar, 3, 1>;
+    const Vector a = lhs.vec;
+    const Vector b = rhs.vec;
+    Eigen::Matrix<typename wave::CrossMatrix<Lhs>::Scalar, 3, 3> res = b * a.transpose();
+    res.diagonal().array() -= a.dot(b);
+    return res;
 }
 
 /**
@@ -202,6 +216,41 @@ EIGEN_DEVICE_FUNC inline const wave::CrossMatrix<VecType> &operator*(
     return cross;
 }
 
+/**
+ * Multiply a negative Identity expression by a CrossMatrix expression
+ * (Provided to break tie between the other specializations)
+ */
+template <typename VecType, typename Scalar>
+EIGEN_DEVICE_FUNC inline auto operator*(const wave::NegativeIdentityMatrix<Scalar, 3> &,
+                                        const wave::CrossMatrix<VecType> &cross) {
+    return -cross;
+}
+
+/**
+ * Multiply a CrossMatrix expression by a negative Identity expression
+ * (Provided to break tie between the other specializations)
+ */
+template <typename VecType, typename Scalar>
+EIGEN_DEVICE_FUNC inline auto operator*(const wave::CrossMatrix<VecType> &cross,
+                                        const wave::NegativeIdentityMatrix<Scalar, 3> &) {
+    return -cross;
+}
+
+/**
+ * Multiply a CrossMatrix expression by an IdentityBlockMatrix
+ * (Provided to break tie between the other specializations)
+ */
+template <typename VecType, typename Scalar, int Cols, int Offset>
+EIGEN_DEVICE_FUNC inline auto operator*(
+  const wave::CrossMatrix<VecType> &cross,
+  const wave::IdentityBlockMatrix<Scalar, 3, Cols, Offset> &)
+  -> Eigen::Matrix<typename wave::CrossMatrix<VecType>::Scalar, 3, Cols> {
+    Eigen::Matrix<typename wave::CrossMatrix<VecType>::Scalar, 3, Cols> res;
+    res.setZero();
+    res.template middleCols<3>(Offset) = cross;
+    return res;
+}
+
 namespace internal {
 
 // Static attributes of our CrossMatrix expression
@@ -213,7 +262,7 @@ struct traits<::wave::CrossMatrix<VecType>> {
     using StorageIndex = typename VecType::StorageIndex;
     using Scalar = typename VecType::Scalar;
     enum {
-        Flags = Eigen::AutoAlign,
+        Flags = Eigen::ColMajor,
         RowsAtCompileTime = 3,
         ColsAtCompileTime = 3,
         MaxRowsAtCompileTime = 3,
@@ -221,6 +270,35 @@ struct traits<::wave::CrossMatrix<VecType>> {
     };
 };
 
+// Coefficient access for the CrossMatrix expression. The vector is evaluated once, and
+// each coefficient is read from it
+template <class VecType>
+struct evaluator<::wave::CrossMatrix<VecType>>
+    : evaluator_base<::wave::CrossMatrix<VecType>> {
+    using XprType = ::wave::CrossMatrix<VecType>;
+    using Scalar = typename XprType::Scalar;
+    using CoeffReturnType = Scalar;
+    enum {
+        CoeffReadCost = NumTraits<Scalar>::ReadCost + NumTraits<Scalar>::AddCost,
+        Flags = Eigen::ColMajor,
+        Alignment = 0
+    };
+
+    EIGEN_DEVICE_FUNC explicit evaluator(const XprType &xpr) : vec{xpr.vec} {}
+
+    EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE CoeffReturnType coeff(Index row,
+                                                                Index col) const {
+        // Element (i, j) of the cross matrix is +-vec(k) for {i, j, k} = {0, 1, 2}, with
+        // a negative sign where j follows i cyclically
+        if (row == col) {
+            return Scalar{0};
+        }
+        const auto &v = this->vec.coeff(3 - row - col);
+        return (col - row + 3) % 3 == 1 ? -v : v;
+    }
+
+    const Eigen::Matrix<Scalar, 3, 1> vec;
+};
 
 }  // namespace internal
 }  // namespace Eigen
@@ -13,6 +13,9 @@
 
 namespace wave {
 
+template <typename Scalar, int N>
+class NegativeIdentityMatrix;
+
 /**
  * An Eigen expression for a square identity matrix
  *
@@ -31,6 +34,66 @@ class IdentityMatrix : public Eigen::Matrix<Scalar, N, N>::IdentityReturnType {
     using MatrixType = Eigen::Matrix<Scalar, N, N>;
     using Base = typename MatrixType::IdentityReturnType;
     IdentityMatrix() : Base{MatrixType::Identity()} {}
+
+    NegativeIdentityMatrix<Scalar, N> operator-() const {
+        return NegativeIdentityMatrix<Scalar, N>{};
+    }
+};
+
+/**
+ * An Eigen expression for the negative of a square identity matrix
+ *
+ * Like IdentityMatrix, it is never stored: multiplying by it negates the other operand.
+ */
+template <typename Scalar, int N>
+class NegativeIdentityMatrix
+    : public Eigen::CwiseUnaryOp<
+        Eigen::internal::scalar_opposite_op<Scalar>,
+        const typename Eigen::Matrix<Scalar, N, N>::IdentityReturnType> {
+ public:
+    using MatrixType = Eigen::Matrix<Scalar, N, N>;
+    using Base = Eigen::CwiseUnaryOp<Eigen::internal::scalar_opposite_op<Scalar>,
+                                     const typename MatrixType::IdentityReturnType>;
+    NegativeIdentityMatrix() : Base{MatrixType::Identity()} {}
+
+    IdentityMatrix<Scalar, N> operator-() const {
+        return IdentityMatrix<Scalar, N>{};
+    }
+};
+
+namespace internal {
+
+/** Nullary functor giving the coefficients of an IdentityBlockMatrix */
+template <typename Scalar, int Offset>
+struct identity_block_op {
+    EIGEN_DEVICE_FUNC EIGEN_STRONG_INLINE Scalar operator()(Eigen::Index row,
+                                                            Eigen::Index col) const {
+        return col == row + Offset ? Scalar{1} : Scalar{0};
+    }
+};
+
+}  // namespace internal
+
+/**
+ * An Eigen expression for a Rows*Cols matrix which is zero except for an identity block
+ * in columns [Offset, Offset + Rows)
+ *
+ * This is the Jacobian of a compound object's component with respect to the object, for
+ * example of the rotation of a rigid transform. Multiplying a matrix on the right by it
+ * copies the matrix into a block of columns; multiplying on the left selects rows.
+ */
+template <typename Scalar, int Rows, int Cols, int Offset>
+class IdentityBlockMatrix
+    : public Eigen::CwiseNullaryOp<internal::identity_block_op<Scalar, Offset>,
+                                   Eigen::Matrix<Scalar, Rows, Cols>> {
+    static_assert(Offset >= 0 && Offset + Rows <= Cols, "Block out of range");
+
+ public:
+    using MatrixType = Eigen::Matrix<Scalar, Rows, Cols>;
+    using Base =
+      Eigen::CwiseNullaryOp<internal::identity_block_op<Scalar, Offset>, MatrixType>;
+    IdentityBlockMatrix()
+        : Base{Rows, Cols, internal::identity_block_op<Scalar, Offset>{}} {}
 };
 
 }  // namespace wave
@@ -45,6 +108,38 @@ template <typename Scalar, int N>
 struct traits<::wave::IdentityMatrix<Scalar, N>>
     : Eigen::Matrix<Scalar, N, N>::IdentityReturnType {};
 
+// Treat NegativeIdentityMatrix identically to its CwiseUnaryOp base class
+template <typename Scalar, int N>
+struct traits<::wave::NegativeIdentityMatrix<Scalar, N>>
+    : traits<typename ::wave::NegativeIdentityMatrix<Scalar, N>::Base> {};
+
+template <typename Scalar, int N>
+struct evaluator<::wave::NegativeIdentityMatrix<Scalar, N>>
+    : evaluator<typename ::wave::NegativeIdentityMatrix<Scalar, N>::Base> {
+    using Base = evaluator<typename ::wave::NegativeIdentityMatrix<Scalar, N>::Base>;
+    explicit evaluator(const ::wave::NegativeIdentityMatrix<Scalar, N> &xpr)
+        : Base{xpr} {}
+};
+
+template <typename Scalar, int Offset>
+struct functor_traits<::wave::internal::identity_block_op<Scalar, Offset>> {
+    enum { Cost = NumTraits<Scalar>::AddCost, PacketAccess = false, IsRepeatable = true };
+};
+
+// Treat IdentityBlockMatrix identically to its CwiseNullaryOp base class
+template <typename Scalar, int Rows, int Cols, int Offset>
+struct traits<::wave::IdentityBlockMatrix<Scalar, Rows, Cols, Offset>>
+    : traits<typename ::wave::IdentityBlockMatrix<Scalar, Rows, Cols, Offset>::Base> {};
+
+template <typename Scalar, int Rows, int Cols, int Offset>
+struct evaluator<::wave::IdentityBlockMatrix<Scalar, Rows, Cols, Offset>>
+    : evaluator<typename ::wave::IdentityBlockMatrix<Scalar, Rows, Cols, Offset>::Base> {
+    using Base =
+      evaluator<typename ::wave::IdentityBlockMatrix<Scalar, Rows, Cols, Offset>::Base>;
+    explicit evaluator(const ::wave::IdentityBlockMatrix<Scalar, Rows, Cols, Offset> &xpr)
+        : Base{xpr} {}
+};
+
 }  // namespace internal
 
 /**
@@ -83,6 +178,141 @@ EIGEN_DEVICE_FUNC inline const wave::IdentityMatrix<Scalar, N> &operator*(
     return i;
 }
 
+/**
+ * Multiply a negative Identity expression by another matrix on the right
+ */
+template <typename Scalar, int N, typename OtherDerived>
+EIGEN_DEVICE_FUNC inline auto operator*(const wave::NegativeIdentityMatrix<Scalar, N> &,
+                                        const Eigen::MatrixBase<OtherDerived> &rhs) {
+    static_assert(OtherDerived::RowsAtCompileTime == N ||
+                    OtherDerived::RowsAtCompileTime == Eigen::Dynamic,
+                  "Invalid matrix product");
+    return -rhs.derived();
+}
+
+/**
+ * Multiply a negative Identity expression by another matrix on the left
+ */
+template <typename Scalar, int N, typename OtherDerived>
+EIGEN_DEVICE_FUNC inline auto operator*(const Eigen::MatrixBase<OtherDerived> &lhs,
+                                        const wave::NegativeIdentityMatrix<Scalar, N> &) {
+    static_assert(OtherDerived::ColsAtCompileTime == N ||
+                    OtherDerived::ColsAtCompileTime == Eigen::Dynamic,
+                  "Invalid matrix product");
+    return -lhs.derived();
+}
+
+/**
+ * Multiply two negative Identity expressions
+ * (Provided to break tie between the other specializations)
+ */
+template <typename Scalar, int N>
+EIGEN_DEVICE_FUNC inline auto operator*(const wave::NegativeIdentityMatrix<Scalar, N> &,
+                                        const wave::NegativeIdentityMatrix<Scalar, N> &) {
+    return wave::IdentityMatrix<Scalar, N>{};
+}
+
+/**
+ * Multiply an Identity expression by a negative Identity expression
+ * (Provided to break tie between the other specializations)
+ */
+template <typename Scalar, int N>
+EIGEN_DEVICE_FUNC inline const wave::NegativeIdentityMatrix<Scalar, N> &operator*(
+  const wave::IdentityMatrix<Scalar, N> &,
+  const wave::NegativeIdentityMatrix<Scalar, N> &i) {
+    return i;
+}
+
+/**
+ * Multiply a negative Identity expression by an Identity expression
+ * (Provided to break tie between the other specializations)
+ */
+template <typename Scalar, int N>
+EIGEN_DEVICE_FUNC inline const wave::NegativeIdentityMatrix<Scalar, N> &operator*(
+  const wave::NegativeIdentityMatrix<Scalar, N> &i,
+  const wave::IdentityMatrix<Scalar, N> &) {
+    return i;
+}
+
+/**
+ * Multiply a matrix on the right by an IdentityBlockMatrix
+ *
+ * The result is zero except for a block of columns holding the l.h.s. matrix.
+ */
+template <typename Scalar, int Rows, int Cols, int Offset, typename OtherDerived>
+EIGEN_DEVICE_FUNC inline auto operator*(
+  const Eigen::MatrixBase<OtherDerived> &lhs,
+  const wave::IdentityBlockMatrix<Scalar, Rows, Cols, Offset> &)
+  -> Eigen::Matrix<typename OtherDerived::Scalar, OtherDerived::RowsAtCompileTime, Cols> {
+    static_assert(OtherDerived::ColsAtCompileTime == Rows ||
+                    OtherDerived::ColsAtCompileTime == Eigen::Dynamic,
+                  "Invalid matrix product");
+    using Result =
+      Eigen::Matrix<typename OtherDerived::Scalar, OtherDerived::RowsAtCompileTime, Cols>;
+    Result res = Result::Zero(lhs.rows(), Cols);
+    res.template middleCols<Rows>(Offset) = lhs.derived();
+    return res;
+}
+
+/**
+ * Multiply a matrix on the left by an IdentityBlockMatrix
+ *
+ * The result is a block of rows of the r.h.s. matrix.
+ */
+template <typename Scalar, int Rows, int Cols, int Offset, typename OtherDerived>
+EIGEN_DEVICE_FUNC inline auto operator*(
+  const wave::IdentityBlockMatrix<Scalar, Rows, Cols, Offset> &,
+  const Eigen::MatrixBase<OtherDerived> &rhs) {
+    static_assert(OtherDerived::RowsAtCompileTime == Cols ||
+                    OtherDerived::RowsAtCompileTime == Eigen::Dynamic,
+                  "Invalid matrix product");
+    return rhs.derived().template middleRows<Rows>(Offset);
+}
+
+/**
+ * Multiply an Identity expression by an IdentityBlockMatrix
+ * (Provided to break tie between the other specializations)
+ */
+template <typename Scalar, int Rows, int Cols, int Offset>
+EIGEN_DEVICE_FUNC inline const wave::IdentityBlockMatrix<Scalar, Rows, Cols, Offset> &
+operator*(const wave::IdentityMatrix<Scalar, Rows> &,
+          const wave::IdentityBlockMatrix<Scalar, Rows, Cols, Offset> &block) {
+    return block;
+}
+
+/**
+ * Multiply an IdentityBlockMatrix by an Identity expression
+ * (Provided to break tie between the other specializations)
+ */
+template <typename Scalar, int Rows, int Cols, int Offset>
+EIGEN_DEVICE_FUNC inline const wave::IdentityBlockMatrix<Scalar, Rows, Cols, Offset> &
+operator*(const wave::IdentityBlockMatrix<Scalar, Rows, Cols, Offset> &block,
+          const wave::IdentityMatrix<Scalar, Cols> &) {
+    return block;
+}
+
+/**
+ * Multiply a negative Identity expression by an IdentityBlockMatrix
+ * (Provided to break tie between the other specializations)
+ */
+template <typename Scalar, int Rows, int Cols, int Offset>
+EIGEN_DEVICE_FUNC inline auto operator*(
+  const wave::NegativeIdentityMatrix<Scalar, Rows> &,
+  const wave::IdentityBlockMatrix<Scalar, Rows, Cols, Offset> &block) {
+    return -block;
+}
+
+/**
+ * Multiply an IdentityBlockMatrix by a negative Identity expression
+ * (Provided to break tie between the other specializations)
+ */
+template <typename Scalar, int Rows, int Cols, int Offset>
+EIGEN_DEVICE_FUNC inline auto operator*(
+  const wave::IdentityBlockMatrix<Scalar, Rows, Cols, Offset> &block,
+  const wave::NegativeIdentityMatrix<Scalar, Cols> &) {
+    return -block;
+}
+
 }  // namespace Eigen
 
 #endif  // WAVE_GEOMETRY_IDENTITYMATRIX_HPP
@@ -95,6 +95,13 @@ class MatrixMap {
         this->storage.setZero();
     }
 
+    /** Adds the blocks of another MatrixMap with the same keys, widths and height */
+    MatrixMap &operator+=(const MatrixMap &other) {
+        assert(this->storage.rows() == other.storage.rows() &&
+               this->storage.cols() == other.storage.cols());
+        this->storage += other.storage;
+        return *this;
+    }
 
  private:
     Eigen::Matrix<Scalar, Eigen::Dynamic, Eigen::Dynamic> storage;
@@ -0,0 +1,112 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_DOUBLEBUFFER_HPP
+#define WAVE_GEOMETRY_DOUBLEBUFFER_HPP
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+namespace wave {
+
+/** Two copies of a value, one for readers while the other is written
+ *
+ * This is the left-right technique: a writer updates the copy readers are not using,
+ * swaps the copies with an atomic store, waits until no reader is still on the old
+ * copy, and updates it too. Each reader registers on one of two counters, chosen by a
+ * version index that the writer toggles only once the other counter has drained.
+ *
+ * Readers are wait-free: read() takes a fixed number of atomic operations besides the
+ * caller's function, and never sees a copy being written. Writers take a lock, and wait
+ * for readers to leave the copy they are about to update, so a read should be short,
+ * such as copying out a value.
+ */
+template <typename T>
+class DoubleBuffer {
+ public:
+    explicit DoubleBuffer(const T &initial = T{}) : copies{{initial, initial}} {}
+
+    DoubleBuffer(const DoubleBuffer &) = delete;
+    DoubleBuffer &operator=(const DoubleBuffer &) = delete;
+
+    /** Returns f(value), without waiting for writers
+     *
+     * f must not call write() on this buffer, and its result must not refer to the
+     * value, which may be overwritten once read() returns.
+     */
+    template <typename F>
+    decltype(auto) read(F &&f) const {
+        const auto version = this->version.load();
+        const auto arrival = Arrival{this->readers[version].count};
+        return f(static_cast<const T &>(this->copies[this->active.load()]));
+    }
+
+    /** Returns a copy of the value */
+    T load() const {
+        return this->read([](const T &value) { return value; });
+    }
+
+    /** Calls f on each copy of the value in turn, making the first visible to readers
+     * before updating the second
+     *
+     * f must leave both copies the same, given the same starting value.
+     */
+    template <typename F>
+    void write(F &&f) {
+        std::lock_guard<std::mutex> lock{this->writer_mutex};
+        const auto active = this->active.load();
+        f(this->copies[1 - active]);
+        this->active.store(1 - active);
+
+        const auto version = this->version.load();
+        this->waitForReaders(1 - version);
+        this->version.store(1 - version);
+        this->waitForReaders(version);
+        f(this->copies[active]);
+    }
+
+    /** Replaces the value */
+    void store(const T &value) {
+        this->write([&value](T &copy) { copy = value; });
+    }
+
+ private:
+    /** A reader count on its own cache line, so readers do not contend with the copies */
+    struct alignas(64) Counter {
+        std::atomic<std::size_t> count{0};
+    };
+
+    /** Counts a reader while it is in scope */
+    struct Arrival {
+        explicit Arrival(std::atomic<std::size_t> &count) : count{count} {
+            ++this->count;
+        }
+
+        ~Arrival() {
+            --this->count;
+        }
+
+        std::atomic<std::size_t> &count;
+    };
+
+    void waitForReaders(std::size_t version) const {
+        while (this->readers[version].count.load() != 0) {
+            std::this_thread::yield();
+        }
+    }
+
+    std::array<T, 2> copies;
+    std::atomic<std::size_t> active{0};   // the copy readers use
+    std::atomic<std::size_t> version{0};  // the counter new readers register on
+    mutable std::array<Counter, 2> readers;
+    std::mutex writer_mutex;
+};
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_DOUBLEBUFFER_HPP
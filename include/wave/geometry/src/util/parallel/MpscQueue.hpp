@@ -0,0 +1,93 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_MPSCQUEUE_HPP
+#define WAVE_GEOMETRY_MPSCQUEUE_HPP
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <utility>
+
+namespace wave {
+
+/** A lock-free queue with many producers and a single consumer
+ *
+ * Producers push nodes onto a linked stack with a compare-and-swap. The consumer takes
+ * the whole stack with one exchange and reverses it, so items are consumed in the order
+ * they were pushed. As nodes are never taken one at a time, there is no ABA problem.
+ *
+ * push() and empty() may be called from any thread; consumeAll() from one thread at a
+ * time.
+ */
+template <typename T>
+class MpscQueue {
+ public:
+    MpscQueue() = default;
+
+    ~MpscQueue() {
+        const auto remaining = List{this->head.exchange(nullptr)};
+    }
+
+    MpscQueue(const MpscQueue &) = delete;
+    MpscQueue &operator=(const MpscQueue &) = delete;
+
+    /** Adds an item, without locking */
+    void push(T value) {
+        auto *node = new Node{std::move(value), this->head.load()};
+        while (!this->head.compare_exchange_weak(node->next, node)) {
+        }
+    }
+
+    /** Returns true if no items are waiting */
+    bool empty() const noexcept {
+        return this->head.load() == nullptr;
+    }
+
+    /** Calls f on each waiting item, oldest first, and returns the number of items
+     *
+     * If f throws, the items after the one it threw on are discarded.
+     */
+    template <typename F>
+    std::size_t consumeAll(F &&f) {
+        auto pending = List{};
+        for (auto *node = this->head.exchange(nullptr); node != nullptr;) {
+            auto *next = node->next;
+            node->next = pending.first;
+            pending.first = node;
+            node = next;
+        }
+        std::size_t count = 0;
+        while (pending.first != nullptr) {
+            const auto node = std::unique_ptr<Node>{pending.first};
+            pending.first = node->next;
+            f(std::move(node->value));
+            ++count;
+        }
+        return count;
+    }
+
+ private:
+    struct Node {
+        T value;
+        Node *next;
+    };
+
+    /** A list of nodes, freed on destruction */
+    struct List {
+        ~List() {
+            while (this->first != nullptr) {
+                delete std::exchange(this->first, this->first->next);
+            }
+        }
+
+        Node *first = nullptr;
+    };
+
+    std::atomic<Node *> head{nullptr};
+};
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_MPSCQUEUE_HPP
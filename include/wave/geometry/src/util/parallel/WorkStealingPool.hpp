@@ -0,0 +1,243 @@
+/**
+ * @file
+ */
+
+#ifndef WAVE_GEOMETRY_WORKSTEALINGPOOL_HPP
+#define WAVE_GEOMETRY_WORKSTEALINGPOOL_HPP
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace wave {
+
+/** A fixed set of threads running tasks from per-thread queues
+ *
+ * Each participating thread pushes the tasks it submits onto its own queue and takes the
+ * most recently submitted task from it first. A thread whose queue is empty steals the
+ * oldest task from another queue. Tasks are given the index of the thread running them,
+ * in [0, size()), which can be used to index per-thread storage.
+ *
+ * The thread calling run() takes part as thread 0, so a pool of size 1 starts no threads
+ * and runs every task on the caller.
+ */
+class WorkStealingPool {
+ public:
+    using Task = std::function<void(std::size_t)>;
+
+    /** Starts size - 1 worker threads
+     *
+     * @param size number of threads taking part in run(), including the caller
+     */
+    explicit WorkStealingPool(std::size_t size = defaultSize()) {
+        size = std::max<std::size_t>(size, 1);
+        for (std::size_t i = 0; i < size; ++i) {
+            this->queues.push_back(std::make_unique<Queue>());
+        }
+        for (std::size_t i = 1; i < size; ++i) {
+            this->threads.emplace_back([this, i] { this->work(i); });
+        }
+    }
+
+    ~WorkStealingPool() {
+        {
+            std::lock_guard<std::mutex> lock{this->sleep_mutex};
+            this->stopping = true;
+        }
+        this->wake.notify_all();
+        for (auto &t : this->threads) {
+            t.join();
+        }
+    }
+
+    WorkStealingPool(const WorkStealingPool &) = delete;
+    WorkStealingPool &operator=(const WorkStealingPool &) = delete;
+
+    /** Returns the number of threads taking part in run(), including the caller */
+    std::size_t size() const noexcept {
+        return this->queues.size();
+    }
+
+    /** Returns the number of hardware threads, or 1 if unknown */
+    static std::size_t defaultSize() noexcept {
+        return std::max(1u, std::thread::hardware_concurrency());
+    }
+
+    /** Runs a task, and all tasks it submits, and returns once they have finished
+     *
+     * Only one call to run() may be in progress at a time.
+     *
+     * @throws the first exception thrown by a task. Tasks not yet started when it was
+     * thrown are skipped.
+     */
+    void run(Task task) {
+        const auto previous = currentWorker();
+        currentWorker() = {this, 0};
+        this->submit(std::move(task));
+        while (this->pending.load() > 0) {
+            if (!this->runOne(0)) {
+                std::unique_lock<std::mutex> lock{this->sleep_mutex};
+                this->wake.wait(lock, [this] {
+                    return this->queued.load() > 0 || this->pending.load() == 0;
+                });
+            }
+        }
+        currentWorker() = previous;
+
+        auto error = std::exception_ptr{};
+        std::swap(error, this->error);
+        if (error) {
+            std::rethrow_exception(error);
+        }
+    }
+
+    /** Adds a task to be run before the current run() returns
+     *
+     * From within a task, the task is pushed onto the calling thread's own queue.
+     */
+    void submit(Task task) {
+        const auto current = currentWorker();
+        const auto index = current.first == this ? current.second : 0;
+        ++this->pending;
+        {
+            auto &queue = *this->queues[index];
+            std::lock_guard<std::mutex> lock{queue.mutex};
+            queue.tasks.push_back(std::move(task));
+        }
+        ++this->queued;
+        this->notify(false);
+    }
+
+ private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    /** The pool and thread index the calling thread is running tasks for, if any */
+    static std::pair<const WorkStealingPool *, std::size_t> &currentWorker() noexcept {
+        static thread_local std::pair<const WorkStealingPool *, std::size_t> current{
+          nullptr, 0};
+        return current;
+    }
+
+    /** Wakes one or all sleeping threads, taking the lock so no wakeup is lost */
+    void notify(bool all) {
+        { std::lock_guard<std::mutex> lock{this->sleep_mutex}; }
+        if (all) {
+            this->wake.notify_all();
+        } else {
+            this->wake.notify_one();
+        }
+    }
+
+    /** Takes a task from the back of our own queue, or the front of another's */
+    bool take(std::size_t index, Task &task) {
+        const auto n = this->queues.size();
+        for (std::size_t k = 0; k < n; ++k) {
+            auto &queue = *this->queues[(index + k) % n];
+            std::lock_guard<std::mutex> lock{queue.mutex};
+            if (!queue.tasks.empty()) {
+                if (k == 0) {
+                    task = std::move(queue.tasks.back());
+                    queue.tasks.pop_back();
+                } else {
+                    task = std::move(queue.tasks.front());
+                    queue.tasks.pop_front();
+                }
+                --this->queued;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /** Runs one task as thread `index`, if one is available */
+    bool runOne(std::size_t index) {
+        auto task = Task{};
+        if (!this->take(index, task)) {
+            return false;
+        }
+        if (!this->failed.load()) {
+            try {
+                task(index);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock{this->sleep_mutex};
+                if (!this->failed.exchange(true)) {
+                    this->error = std::current_exception();
+                }
+            }
+        }
+        if (--this->pending == 0) {
+            this->failed = false;
+            this->notify(true);
+        }
+        return true;
+    }
+
+    /** Loop of worker thread `index` */
+    void work(std::size_t index) {
+        currentWorker() = {this, index};
+        while (true) {
+            if (this->runOne(index)) {
+                continue;
+            }
+            std::unique_lock<std::mutex> lock{this->sleep_mutex};
+            this->wake.wait(
+              lock, [this] { return this->stopping || this->queued.load() > 0; });
+            if (this->stopping) {
+                return;
+            }
+        }
+    }
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> threads;
+    std::atomic<std::size_t> pending{0};  // submitted tasks not yet finished
+    std::atomic<std::size_t> queued{0};   // submitted tasks not yet taken
+    std::atomic<bool> failed{false};
+    std::exception_ptr error;
+    std::mutex sleep_mutex;
+    std::condition_variable wake;
+    bool stopping = false;
+};
+
+/** Splits [0, n) into contiguous chunks and runs f(chunk, start, end) for each, as one
+ * task each on the pool
+ *
+ * There is one chunk per pool thread, or fewer if that would give chunks smaller than
+ * `grain`. Without a pool of at least two threads, or if n < 2 * grain, f(0, 0, n) runs
+ * on the caller. Chunk indices are in [0, pool->size()).
+ */
+template <typename F>
+void parallelChunks(WorkStealingPool *pool,
+                    std::size_t n,
+                    std::size_t grain,
+                    const F &f) {
+    grain = std::max<std::size_t>(grain, 1);
+    if (pool == nullptr || pool->size() < 2 || n < 2 * grain) {
+        f(std::size_t{0}, std::size_t{0}, n);
+        return;
+    }
+    const auto num_chunks = std::min(pool->size(), n / grain);
+    const auto per_chunk = (n + num_chunks - 1) / num_chunks;
+    pool->run([&](std::size_t) {
+        for (std::size_t c = 0; c * per_chunk < n; ++c) {
+            pool->submit([&f, c, per_chunk, n](std::size_t) {
+                const auto start = c * per_chunk;
+                f(c, start, std::min(start + per_chunk, n));
+            });
+        }
+    });
+}
+
+}  // namespace wave
+
+#endif  // WAVE_GEOMETRY_WORKSTEALINGPOOL_HPP
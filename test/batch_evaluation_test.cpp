@@ -0,0 +1,159 @@
+#include "test.hpp"
+#include "wave/geometry/dynamic.hpp"
+#include "wave/geometry/geometry.hpp"
+
+namespace {
+
+using Rotation = wave::RotationMd;
+using Translation = wave::Translationd;
+
+/** Builds k graphs x[i] * e * p[i], all sharing the node e */
+struct Instances {
+    explicit Instances(int k) {
+        for (int i = 0; i < k; ++i) {
+            x.emplace_back(Rotation::Random());
+            p.emplace_back(Translation::Random());
+            roots.emplace_back(x.back() * e * inverse(x.back()) * p.back());
+        }
+    }
+
+    wave::Proxy<Rotation> e{Rotation::Random() * Rotation::Random()};
+    std::vector<wave::Proxy<Rotation>> x;
+    std::vector<wave::Proxy<Translation>> p;
+    std::vector<wave::Proxy<Translation>> roots;
+};
+
+}  // namespace
+
+TEST(BatchEvaluationTest, values) {
+    const auto instances = Instances{10};
+    auto structures = wave::internal::DynamicStructureCache{};
+    auto batch = wave::internal::BatchSweep<Translation>{instances.roots, structures};
+    const auto results = batch.evaluate();
+    ASSERT_EQ(instances.roots.size(), results.size());
+    for (std::size_t k = 0; k < results.size(); ++k) {
+        EXPECT_APPROX(instances.roots[k].eval(), results[k]);
+    }
+    EXPECT_EQ(1u, structures.size());
+}
+
+TEST(BatchEvaluationTest, reverseJacobians) {
+    const auto instances = Instances{10};
+    auto structures = wave::internal::DynamicStructureCache{};
+    auto batch = wave::internal::BatchSweep<Translation>{instances.roots, structures};
+    const auto results = batch.evaluateWithReverseJacobians();
+    ASSERT_EQ(instances.roots.size(), results.size());
+    for (std::size_t k = 0; k < results.size(); ++k) {
+        const auto &root = instances.roots[k];
+        const auto expected = wave::internal::evaluateWithDynamicReverseJacobians(root);
+        EXPECT_APPROX(expected.first, results[k].first);
+        for (const auto &leaf : wave::internal::getLeavesMap(root)) {
+            EXPECT_APPROX(Eigen::MatrixXd{expected.second.at(leaf.first)},
+                          Eigen::MatrixXd{results[k].second.at(leaf.first)});
+        }
+    }
+}
+
+TEST(BatchEvaluationTest, sharedNodesEvaluatedOnce) {
+    const auto instances = Instances{10};
+    auto structures = wave::internal::DynamicStructureCache{};
+    auto batch = wave::internal::BatchSweep<Translation>{instances.roots, structures};
+    // e, then x, p and the root of each instance
+    EXPECT_EQ(31u, batch.numNodes());
+
+    // The same batch can be evaluated again
+    for (int rep = 0; rep < 2; ++rep) {
+        const auto results = batch.evaluate();
+        for (std::size_t k = 0; k < results.size(); ++k) {
+            EXPECT_APPROX(instances.roots[k].eval(), results[k]);
+        }
+    }
+}
+
+TEST(BatchEvaluationTest, differentShapesRejected) {
+    auto instances = Instances{3};
+    const auto p = wave::Proxy<Translation>{Translation::Random()};
+    instances.roots.emplace_back(instances.x.front() * p);
+    auto structures = wave::internal::DynamicStructureCache{};
+    EXPECT_THROW((wave::internal::BatchSweep<Translation>{instances.roots, structures}),
+                 std::invalid_argument);
+}
+
+namespace {
+
+/** Arrays of values for k instances of inverse(x * e) * p */
+struct Arrays {
+    explicit Arrays(int k) {
+        for (int i = 0; i < k; ++i) {
+            x.push_back(Rotation::Random());
+            p.push_back(Translation::Random());
+        }
+    }
+
+    std::vector<Rotation> x;
+    std::vector<Translation> p;
+};
+
+}  // namespace
+
+TEST(BatchKernelTest, boundLeaves) {
+    const auto arrays = Arrays{10};
+    const auto x = Rotation::Random();
+    const auto p = Translation::Random();
+    const auto e = wave::Proxy<Rotation>{Rotation::Random() * Rotation::Random()};
+    const auto pose = wave::Proxy<Rotation>{x * e};
+    auto kernel = wave::internal::BatchKernel<Translation>{
+      wave::Proxy<Translation>{inverse(pose) * p}};
+    kernel.bind(x, arrays.x.data());
+    kernel.bind(p, arrays.p.data());
+
+    const auto values = kernel.evaluate(arrays.x.size());
+    const auto results = kernel.evaluateWithReverseJacobians(arrays.x.size());
+    ASSERT_EQ(arrays.x.size(), results.size());
+    for (std::size_t k = 0; k < results.size(); ++k) {
+        // The same graph, built from the values of instance k
+        const auto &xk = arrays.x[k];
+        const auto &pk = arrays.p[k];
+        const auto root = wave::Proxy<Translation>{
+          inverse(wave::Proxy<Rotation>{xk * e}) * pk};
+        const auto expected = wave::internal::evaluateWithDynamicReverseJacobians(root);
+        EXPECT_APPROX(expected.first, values[k]);
+        EXPECT_APPROX(expected.first, results[k]);
+        const Eigen::Matrix3d J_x = expected.second.at(&xk);
+        const Eigen::Matrix3d J_p = expected.second.at(&pk);
+        EXPECT_APPROX(J_x, kernel.jacobian(x, k));
+        EXPECT_APPROX(J_p, kernel.jacobian(p, k));
+    }
+}
+
+TEST(BatchKernelTest, boundNode) {
+    const auto arrays = Arrays{10};
+    const auto p = Translation::Random();
+    const auto pose = wave::Proxy<Rotation>{Rotation::Random() * Rotation::Random()};
+    auto kernel = wave::internal::BatchKernel<Translation>{
+      wave::Proxy<Translation>{inverse(pose) * p}};
+    // The node takes the values of x in place of its own
+    kernel.bind(pose, arrays.x.data());
+
+    const auto results = kernel.evaluateWithReverseJacobians(arrays.x.size());
+    for (std::size_t k = 0; k < results.size(); ++k) {
+        const auto &xk = arrays.x[k];
+        const auto expected = (inverse(xk) * p).evalWithJacobians(xk);
+        EXPECT_APPROX(std::get<0>(expected), results[k]);
+        EXPECT_APPROX(std::get<1>(expected), kernel.jacobian(pose, k));
+        // p is not bound, so has no Jacobian
+        EXPECT_APPROX(Eigen::Matrix3d::Zero().eval(), kernel.jacobian(p, k));
+    }
+}
+
+TEST(BatchKernelTest, bindingsChecked) {
+    const auto x = Rotation::Random();
+    const auto p = Translation::Random();
+    const auto other = Rotation::Random();
+    auto kernel = wave::internal::BatchKernel<Translation>{
+      wave::Proxy<Translation>{x * p}};
+    const auto values = std::vector<Rotation>(3, Rotation::Random());
+    EXPECT_THROW(kernel.bind(other, values.data()), std::invalid_argument);
+    kernel.bind(x, values.data());
+    EXPECT_EQ(3u, kernel.evaluate(values.size()).size());
+}
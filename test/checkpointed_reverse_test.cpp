@@ -0,0 +1,114 @@
+#include "test.hpp"
+#include "wave/geometry/dynamic.hpp"
+#include "wave/geometry/geometry.hpp"
+
+namespace {
+
+using Rotation = wave::RotationMd;
+using Translation = wave::Translationd;
+
+/** Builds a chain of Dynamic nodes, r_n * ... * r_1 * t, like an odometry chain */
+struct RotateChain {
+    explicit RotateChain(int n) : t{Translation::Random()}, result{t} {
+        for (int i = 0; i < n; ++i) {
+            rotations.emplace_back(Rotation::Random());
+            result = rotations.back() * result;
+        }
+    }
+
+    wave::Proxy<Translation> t;
+    std::vector<wave::Proxy<Rotation>> rotations;
+    wave::Proxy<Translation> result;
+};
+
+/** Checks two maps have the same Jacobians for each of the given keys */
+template <typename Map, typename Keys>
+void expectSameJacobians(const Map &expected, const Map &actual, const Keys &keys) {
+    for (const auto &key : keys) {
+        EXPECT_APPROX(Eigen::MatrixXd{expected.at(key.first)},
+                      Eigen::MatrixXd{actual.at(key.first)});
+    }
+}
+
+}  // namespace
+
+TEST(CheckpointedReverseTest, repetitions) {
+    // binomial(s + t, s) >= l
+    EXPECT_EQ(0, wave::internal::checkpointRepetitions(1, 3));
+    EXPECT_EQ(1, wave::internal::checkpointRepetitions(4, 3));
+    EXPECT_EQ(2, wave::internal::checkpointRepetitions(5, 3));
+    EXPECT_EQ(2, wave::internal::checkpointRepetitions(10, 3));
+    EXPECT_EQ(3, wave::internal::checkpointRepetitions(11, 3));
+    EXPECT_EQ(9, wave::internal::checkpointRepetitions(10, 1));
+}
+
+TEST(CheckpointedReverseTest, chainMatchesReverse) {
+    const auto chain = RotateChain{40};
+    const auto expected =
+      wave::internal::evaluateWithDynamicReverseJacobians(chain.result);
+    const auto leaves = wave::internal::getLeavesMap(chain.result);
+    ASSERT_EQ(41u, leaves.size());
+
+    for (const auto budget : {0, 1, 2, 5, 100}) {
+        const auto actual =
+          wave::internal::evaluateWithCheckpointedReverseJacobians(chain.result, budget);
+        EXPECT_APPROX(expected.first, actual.first);
+        expectSameJacobians(expected.second, actual.second, leaves);
+    }
+}
+
+TEST(CheckpointedReverseTest, chainRespectsBudget) {
+    const auto chain = RotateChain{200};
+    const auto expected =
+      wave::internal::evaluateWithDynamicReverseJacobians(chain.result);
+    const auto leaves = wave::internal::getLeavesMap(chain.result);
+
+    for (const auto budget : {1, 3, 8}) {
+        auto sweep = wave::internal::CheckpointedReverseSweep<double>{
+          chain.result.follow(), static_cast<std::size_t>(budget)};
+        const auto jac_map = sweep.run([](const auto &) {});
+        expectSameJacobians(expected.second, jac_map, leaves);
+        // The checkpoints, plus the segment start and the step being reversed
+        EXPECT_LE(sweep.peakStored(), budget + 2u);
+    }
+}
+
+TEST(CheckpointedReverseTest, longChain) {
+    // Recursive evaluation of a chain this deep may overflow the stack
+    const auto chain = RotateChain{100000};
+    const auto res =
+      wave::internal::evaluateWithCheckpointedReverseJacobians(chain.result, 20);
+
+    auto expected = chain.t.eval();
+    auto expected_jac = Eigen::Matrix3d::Identity().eval();
+    for (const auto &r : chain.rotations) {
+        expected = eval(r * expected);
+        expected_jac = r.eval().value() * expected_jac;
+    }
+    EXPECT_APPROX(expected, res.first);
+
+    const auto &t_leaf =
+      static_cast<const wave::Dynamic<Translation &&> &>(chain.t.follow()).rhs();
+    EXPECT_APPROX(expected_jac, Eigen::Matrix3d{res.second.at(&t_leaf)});
+}
+
+TEST(CheckpointedReverseTest, sharedNodes) {
+    // A graph which is not a chain: nodes are used by several parents
+    const auto r1 = wave::Proxy<Rotation>{Rotation::Random()};
+    const auto r2 = wave::Proxy<Rotation>{Rotation::Random()};
+    const auto a = wave::Proxy<Rotation>{r1 * r2};
+    const auto b = wave::Proxy<Rotation>{a * r1};
+    const auto c = wave::Proxy<Rotation>{b * a * inverse(a)};
+
+    const auto expected = wave::internal::evaluateWithDynamicReverseJacobians(c);
+    const auto leaves = wave::internal::getLeavesMap(c);
+    for (const auto budget : {0, 4}) {
+        const auto actual =
+          wave::internal::evaluateWithCheckpointedReverseJacobians(c, budget);
+        EXPECT_APPROX(expected.first, actual.first);
+        expectSameJacobians(expected.second, actual.second, leaves);
+    }
+
+    // The graph can still be evaluated normally afterwards
+    EXPECT_APPROX(expected.first, c.eval());
+}
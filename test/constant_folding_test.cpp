@@ -0,0 +1,92 @@
+#include "test.hpp"
+#include "wave/geometry/dynamic.hpp"
+#include "wave/geometry/geometry.hpp"
+
+namespace {
+
+using Rotation = wave::RotationMd;
+
+}  // namespace
+
+TEST(ConstantFoldingTest, foldConstantSubgraph) {
+    auto c1 = Rotation::Random();
+    const auto c2 = Rotation::Random();
+    const auto x = Rotation::Random();
+    const auto extrinsic = wave::Proxy<Rotation>{c1 * c2};
+    const auto result = wave::Proxy<Rotation>{x * extrinsic};
+
+    auto folding = wave::ConstantFolding<double>{};
+    folding.markConstant(c1);
+    folding.markConstant(c2);
+    folding.fold(result);
+    EXPECT_EQ(1u, folding.size());
+
+    EXPECT_APPROX(wave::eval(x * c1 * c2), result.eval());
+    EXPECT_APPROX((x * c1 * c2).jacobian(x), result.jacobian(x));
+    EXPECT_APPROX(Eigen::Matrix3d::Zero(), result.jacobian(c1));
+
+    // Folded leaves are not reported by reverse mode
+    const auto [value, jac_map] =
+      wave::internal::evaluateWithDynamicReverseJacobians(result);
+    EXPECT_APPROX(wave::eval(x * c1 * c2), value);
+    EXPECT_EQ(1u, jac_map.count(&x));
+    EXPECT_EQ(0u, jac_map.count(&c1));
+    EXPECT_APPROX((x * c1 * c2).jacobian(x), Eigen::Matrix3d{jac_map.at(&x)});
+
+    // Updating a constant re-folds
+    const auto new_c1 = Rotation::Random();
+    folding.update(c1, new_c1);
+    EXPECT_APPROX(wave::eval(x * new_c1 * c2), result.eval());
+
+    // Unfolding restores the dependence on the constants
+    folding.unfold();
+    EXPECT_EQ(0u, folding.size());
+    EXPECT_APPROX((x * c1 * c2).jacobian(c1), result.jacobian(c1));
+}
+
+TEST(ConstantFoldingTest, foldLargestSubgraphs) {
+    auto a = Rotation::Random();
+    const auto b = Rotation::Random();
+    const auto x = Rotation::Random();
+    const auto y = Rotation::Random();
+    const auto inner = wave::Proxy<Rotation>{a * b};
+    const auto outer = wave::Proxy<Rotation>{inner * inverse(inner) * inner};
+    const auto root1 = wave::Proxy<Rotation>{x * outer};
+    const auto root2 = wave::Proxy<Rotation>{y * inner};
+
+    auto folding = wave::ConstantFolding<double>{};
+    folding.markConstant(a);
+    folding.markConstant(b);
+
+    // Only outer is used by a non-constant node
+    folding.fold(root1);
+    EXPECT_EQ(1u, folding.size());
+
+    // In the second graph, inner is used by a non-constant node
+    folding.fold(root2);
+    EXPECT_EQ(2u, folding.size());
+
+    folding.update(a, Rotation::Random());
+    EXPECT_APPROX(wave::eval(x * a * b), root1.eval());
+    EXPECT_APPROX(wave::eval(y * a * b), root2.eval());
+
+    const auto [value, jac_map] =
+      wave::internal::evaluateWithCheckpointedReverseJacobians(root1, 2);
+    EXPECT_APPROX(wave::eval(x * a * b), value);
+    EXPECT_EQ(0u, jac_map.count(&a));
+    EXPECT_APPROX((x * a * b).jacobian(x), Eigen::Matrix3d{jac_map.at(&x)});
+}
+
+TEST(ConstantFoldingTest, unfoldOnDestruction) {
+    const auto c = Rotation::Random();
+    const auto x = Rotation::Random();
+    const auto result = wave::Proxy<Rotation>{x * wave::Proxy<Rotation>{inverse(c)}};
+    {
+        auto folding = wave::ConstantFolding<double>{};
+        folding.markConstant(c);
+        folding.fold(result);
+        EXPECT_EQ(1u, folding.size());
+        EXPECT_APPROX(Eigen::Matrix3d::Zero(), result.jacobian(c));
+    }
+    EXPECT_APPROX((x * inverse(c)).jacobian(c), result.jacobian(c));
+}
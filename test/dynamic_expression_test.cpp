@@ -1,3 +1,4 @@
+#include <thread>
 #include "test.hpp"
 #include "wave/geometry/dynamic.hpp"
 #include "wave/geometry/geometry.hpp"
@@ -204,3 +205,120 @@ TYPED_TEST(RefProxyTest, differentiate) {
         EXPECT_EQ(3, p.second);
     }
 }
+
+TEST(DynamicContextTest, concurrentEvaluation) {
+    // One read-only graph, shared by several threads
+    const auto t = wave::Proxy<wave::Translationd>{wave::Translationd::Random()};
+    auto r = std::vector<wave::Proxy<wave::RotationMd>>{};
+    auto result = wave::Proxy<wave::Translationd>{t};
+    for (int i = 0; i < 20; ++i) {
+        r.emplace_back(wave::RotationMd::Random());
+        result = wave::Proxy<wave::Translationd>{r.back() * inverse(r.back()) * r.back() *
+                                                 result};
+    }
+
+    const auto expected = wave::internal::evaluateWithDynamicReverseJacobians(result);
+    const auto leaves = wave::internal::getLeavesMap(result);
+
+    const auto n_threads = 4;
+    auto failures = std::vector<int>(n_threads, 0);
+    auto threads = std::vector<std::thread>{};
+    for (int k = 0; k < n_threads; ++k) {
+        threads.emplace_back([&, k] {
+            for (int rep = 0; rep < 50; ++rep) {
+                const auto actual =
+                  wave::internal::evaluateWithDynamicReverseJacobians(result);
+                auto same = expected.first.value().isApprox(actual.first.value());
+                for (const auto &leaf : leaves) {
+                    same = same && expected.second.at(leaf.first)
+                                     .isApprox(actual.second.at(leaf.first));
+                }
+                same = same && result.eval().value().isApprox(expected.first.value());
+                failures[k] += !same;
+            }
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    for (const auto f : failures) {
+        EXPECT_EQ(0, f);
+    }
+}
+
+namespace {
+
+/** Builds a factor-like graph x * (a * b), with its own leaves */
+struct FactorGraph {
+    wave::Proxy<wave::RotationMd> a{wave::RotationMd::Random()};
+    wave::Proxy<wave::RotationMd> b{wave::RotationMd::Random()};
+    wave::Proxy<wave::RotationMd> x{wave::RotationMd::Random()};
+    wave::Proxy<wave::RotationMd> result{x * wave::Proxy<wave::RotationMd>{a * b}};
+};
+
+}  // namespace
+
+TEST(DynamicStructureTest, sameShapeShared) {
+    auto structures = wave::internal::DynamicStructureCache{};
+    const auto f1 = FactorGraph{};
+    const auto f2 = FactorGraph{};
+    const auto g1 = wave::internal::DynamicGraph<double>{f1.result.follow(), &structures};
+    const auto g2 = wave::internal::DynamicGraph<double>{f2.result.follow(), &structures};
+    EXPECT_EQ(1u, structures.size());
+    EXPECT_EQ(g1.structure, g2.structure);
+    EXPECT_EQ(&f2.result.follow(), g2.nodes.back().node);
+    EXPECT_EQ(&f1.result.follow(), g1.nodes.back().node);
+
+    // Without a cache, each graph has its own structure
+    const auto g3 = wave::internal::DynamicGraph<double>{f1.result.follow()};
+    EXPECT_NE(g1.structure, g3.structure);
+    EXPECT_TRUE(g1.structure->sameShape(*g3.structure));
+}
+
+TEST(DynamicStructureTest, differentShapes) {
+    auto structures = wave::internal::DynamicStructureCache{};
+    const auto p = wave::Proxy<wave::RotationMd>{wave::RotationMd::Random()};
+    const auto q = wave::Proxy<wave::RotationMd>{wave::RotationMd::Random()};
+    // Same node types, but p * p has one child where p * q has two
+    const auto shared = wave::Proxy<wave::RotationMd>{p * p};
+    const auto distinct = wave::Proxy<wave::RotationMd>{p * q};
+    const auto inverted = wave::Proxy<wave::RotationMd>{p * inverse(q)};
+
+    const auto g1 = wave::internal::DynamicGraph<double>{shared.follow(), &structures};
+    const auto g2 = wave::internal::DynamicGraph<double>{distinct.follow(), &structures};
+    const auto g3 = wave::internal::DynamicGraph<double>{inverted.follow(), &structures};
+    EXPECT_EQ(3u, structures.size());
+    EXPECT_EQ(1u, g1.nodes.back().children.size());
+    EXPECT_EQ(2u, g2.nodes.back().children.size());
+    EXPECT_EQ(2u, g2.nodes[0].parents.size() + g2.nodes[1].parents.size());
+}
+
+TEST(DynamicStructureTest, sweepsWithSharedStructure) {
+    auto structures = wave::internal::DynamicStructureCache{};
+    for (int i = 0; i < 3; ++i) {
+        const auto f = FactorGraph{};
+        const auto expected = wave::internal::evaluateWithDynamicReverseJacobians(f.result);
+        const auto actual =
+          wave::internal::evaluateWithCheckpointedReverseJacobians(f.result, 2, &structures);
+        EXPECT_APPROX(expected.first, actual.first);
+        for (const auto &leaf : wave::internal::getLeavesMap(f.result)) {
+            EXPECT_APPROX(Eigen::MatrixXd{expected.second.at(leaf.first)},
+                          Eigen::MatrixXd{actual.second.at(leaf.first)});
+        }
+    }
+    EXPECT_EQ(1u, structures.size());
+}
+
+TEST(DynamicExpressionTest, releaseLongChain) {
+    // Releasing the root frees a chain too deep to be freed recursively
+    auto leaf = wave::Proxy<wave::RotationMd>{wave::RotationMd::Random()};
+    const auto first = std::weak_ptr<wave::DynamicBase<wave::RotationMd>>{leaf.get()};
+    auto root = leaf;
+    for (int i = 0; i < 200000; ++i) {
+        root = root * leaf;
+    }
+    leaf = wave::Proxy<wave::RotationMd>{wave::RotationMd::Random()};
+    EXPECT_FALSE(first.expired());
+    root = leaf;
+    EXPECT_TRUE(first.expired());
+}
@@ -0,0 +1,127 @@
+#include "../test.hpp"
+#include "wave/geometry/estimation.hpp"
+
+namespace {
+
+using Store = wave::VariableStore<wave::Translationd>;
+
+/** Points pulled halfway towards their targets in each iteration */
+struct Problem {
+    Store store;
+    std::vector<Eigen::Vector3d, Eigen::aligned_allocator<Eigen::Vector3d>> targets;
+};
+
+bool iterate(Problem &problem) {
+    const auto &x = problem.store.values<wave::Translationd>();
+    Eigen::VectorXd delta{problem.store.tangentSize()};
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        delta.segment<3>(3 * i) = 0.5 * (problem.targets[i] - x[i].value());
+    }
+    wave::boxPlus(problem.store, delta);
+    return delta.lpNorm<Eigen::Infinity>() < 1e-12;
+}
+
+void publish(const Problem &problem, Store &solution) {
+    solution = problem.store;
+}
+
+using Solver = wave::BackgroundSolver<Problem, Store>;
+
+/** Returns an update adding a point at the origin with the given target */
+Solver::Update addPoint(const Eigen::Vector3d &target) {
+    return [target](Problem &problem) {
+        problem.store.add(wave::Translationd{Eigen::Vector3d::Zero()});
+        problem.targets.push_back(target);
+    };
+}
+
+}  // namespace
+
+TEST(BackgroundSolverTest, appliesUpdatesAndConverges) {
+    auto solver = Solver{Problem{}, iterate, publish};
+    EXPECT_EQ(1u, solver.published());
+    EXPECT_EQ(0u, solver.latest().size());
+    solver.waitUntilIdle();
+    EXPECT_EQ(1u, solver.published());
+
+    const auto a = Eigen::Vector3d{1, 2, 3};
+    const auto b = Eigen::Vector3d{-4, 5, 0};
+    solver.post(addPoint(a));
+    solver.post(addPoint(b));
+    solver.waitUntilIdle();
+    auto solution = solver.latest();
+    ASSERT_EQ(2u, solution.size());
+    EXPECT_APPROX_PREC(a, solution.values<wave::Translationd>()[0].value(), 1e-9);
+    EXPECT_APPROX_PREC(b, solution.values<wave::Translationd>()[1].value(), 1e-9);
+    const auto published = solver.published();
+    EXPECT_GT(published, 30u);
+
+    // Converged, so nothing is published until the next update
+    solver.waitUntilIdle();
+    EXPECT_EQ(published, solver.published());
+    solver.post([&a](Problem &problem) { problem.targets[0] = -a; });
+    solver.waitUntilIdle();
+    EXPECT_GT(solver.published(), published);
+    solution = solver.latest();
+    const Eigen::Vector3d x = solution.values<wave::Translationd>()[0].value();
+    EXPECT_APPROX_PREC((-a).eval(), x, 1e-9);
+}
+
+TEST(BackgroundSolverTest, readersSeeWholeIterates) {
+    // All points start together with the same target, so they stay together in every
+    // published iterate
+    auto problem = Problem{};
+    for (int i = 0; i < 200; ++i) {
+        problem.store.add(wave::Translationd{Eigen::Vector3d::Zero()});
+        problem.targets.emplace_back(1, 1, 1);
+    }
+    auto solver = Solver{std::move(problem), iterate, publish};
+    auto posters = std::vector<std::thread>{};
+    for (int p = 0; p < 2; ++p) {
+        posters.emplace_back([&solver] {
+            for (int i = 0; i < 20; ++i) {
+                solver.post([i](Problem &problem) {
+                    for (auto &t : problem.targets) {
+                        t.setConstant(i);
+                    }
+                });
+            }
+        });
+    }
+
+    int reads = 0;
+    int torn = 0;
+    while (reads < 1000 || solver.published() < 10) {
+        torn += solver.read([](const Store &s) {
+            const auto &x = s.values<wave::Translationd>();
+            for (const auto &p : x) {
+                if (p.value() != x.front().value()) {
+                    return 1;
+                }
+            }
+            return 0;
+        });
+        ++reads;
+    }
+    for (auto &t : posters) {
+        t.join();
+    }
+    EXPECT_EQ(0, torn);
+    solver.waitUntilIdle();
+    const auto solution = solver.latest();
+    const Eigen::Vector3d x = solution.values<wave::Translationd>()[7].value();
+    EXPECT_APPROX_PREC(Eigen::Vector3d::Constant(19).eval(), x, 1e-9);
+}
+
+TEST(BackgroundSolverTest, rethrowsErrors) {
+    auto solver = Solver{Problem{}, iterate, publish};
+    solver.post([](Problem &) { throw std::runtime_error{"bad update"}; });
+    EXPECT_THROW(solver.waitUntilIdle(), std::runtime_error);
+
+    // The solver keeps running
+    solver.post(addPoint(Eigen::Vector3d::Ones()));
+    solver.waitUntilIdle();
+    const auto solution = solver.latest();
+    const Eigen::Vector3d x = solution.values<wave::Translationd>()[0].value();
+    EXPECT_APPROX_PREC(Eigen::Vector3d::Ones().eval(), x, 1e-9);
+}
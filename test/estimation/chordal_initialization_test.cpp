@@ -0,0 +1,147 @@
+#include "../test.hpp"
+#include "wave/geometry/estimation.hpp"
+
+namespace {
+
+/** Returns measurements along a chain and back to the start, and across it */
+std::vector<std::pair<std::size_t, std::size_t>> loopEdges(std::size_t n) {
+    auto edges = std::vector<std::pair<std::size_t, std::size_t>>{};
+    for (std::size_t k = 0; k < n; ++k) {
+        edges.emplace_back(k, (k + 1) % n);
+    }
+    edges.emplace_back(n - 1, n / 2);
+    edges.emplace_back(1, 3);
+    return edges;
+}
+
+template <typename Rotation>
+using Rotations = std::vector<Rotation, Eigen::aligned_allocator<Rotation>>;
+
+using Measurement = wave::RelativeRotationMeasurement<wave::RotationMd>;
+
+template <typename Leaf>
+class ChordalPoseTest : public testing::Test {};
+
+using PoseTypes = testing::Types<wave::RigidTransformMd, wave::RigidTransformQd>;
+TYPED_TEST_CASE(ChordalPoseTest, PoseTypes);
+
+}  // namespace
+
+TEST(ChordalInitializationTest, projectToRotation) {
+    const auto R = wave::RotationMd::Random().value();
+    EXPECT_APPROX(R, wave::internal::projectToRotation(R));
+    EXPECT_APPROX(R, wave::internal::projectToRotation(2.0 * R));
+
+    // A reflection is projected to a rotation
+    const Eigen::Matrix3d P = wave::internal::projectToRotation(-R);
+    EXPECT_NEAR(1.0, P.determinant(), 1e-9);
+    EXPECT_APPROX(Eigen::Matrix3d::Identity(), Eigen::Matrix3d{P.transpose() * P});
+}
+
+TEST(ChordalInitializationTest, exactRotations) {
+    const std::size_t n = 8;
+    auto truth = Rotations<wave::RotationQd>{};
+    auto store = wave::VariableStore<wave::Translationd, wave::RotationQd>{};
+    store.add(wave::Translationd::Random());
+    for (std::size_t k = 0; k < n; ++k) {
+        truth.push_back(wave::RotationQd::Random());
+        store.add(k == 0 ? truth[0] : wave::RotationQd::Random());
+    }
+
+    auto measurements = std::vector<Measurement>{};
+    for (const auto &e : loopEdges(n)) {
+        const auto R_ij = wave::RotationMd{inverse(truth[e.first]) * truth[e.second]};
+        measurements.push_back({e.first, e.second, R_ij});
+    }
+    wave::initializeRotationsChordal<wave::RotationQd>(store, measurements);
+
+    for (std::size_t k = 0; k < n; ++k) {
+        EXPECT_APPROX(truth[k], store.values<wave::RotationQd>()[k]);
+    }
+}
+
+TYPED_TEST(ChordalPoseTest, exactPoses) {
+    using Leaf = TypeParam;
+    const std::size_t n = 8;
+    const std::size_t anchor = 3;
+    auto truth = std::vector<Leaf, Eigen::aligned_allocator<Leaf>>{};
+    auto store = wave::VariableStore<Leaf>{};
+    for (std::size_t k = 0; k < n; ++k) {
+        truth.push_back(Leaf::Random());
+        store.add(k == anchor ? truth[k] : Leaf::Random());
+    }
+
+    auto measurements = std::vector<wave::RelativePoseMeasurement<Leaf>>{};
+    for (const auto &e : loopEdges(n)) {
+        measurements.push_back(
+          {e.first, e.second, Leaf{inverse(truth[e.first]) * truth[e.second]}});
+    }
+    wave::initializePosesChordal<Leaf>(store, measurements, anchor);
+
+    for (std::size_t k = 0; k < n; ++k) {
+        EXPECT_APPROX(truth[k], store.template values<Leaf>()[k]);
+    }
+}
+
+TEST(ChordalInitializationTest, noisyRotationsBeatOdometry) {
+    // A long loop: composing noisy odometry drifts, but the loop closure and the
+    // measurements skipping one pose correct it. Use Eigen's Random(), which is
+    // repeatable, rather than RotationMd::Random(), so the result does not vary by run.
+    const std::size_t n = 50;
+    auto truth = Rotations<wave::RotationMd>{};
+    for (std::size_t k = 0; k < n; ++k) {
+        const auto angle = wave::RelativeRotationd{M_PI * Eigen::Vector3d::Random()};
+        truth.emplace_back(exp(angle));
+    }
+    auto measurements = std::vector<Measurement>{};
+    for (std::size_t k = 0; k < 2 * n; ++k) {
+        const auto i = k % n;
+        const auto j = (i + 1 + k / n) % n;
+        const auto noise = wave::RelativeRotationd{0.05 * Eigen::Vector3d::Random()};
+        const auto R_ij = wave::RotationMd{inverse(truth[i]) * truth[j] * exp(noise)};
+        measurements.push_back({i, j, R_ij});
+    }
+
+    auto store = wave::VariableStore<wave::RotationMd>{};
+    auto odometry = store;
+    store.add(truth[0]);
+    odometry.add(truth[0]);
+    for (std::size_t k = 1; k < n; ++k) {
+        store.add(wave::RotationMd{Eigen::Matrix3d::Identity()});
+        odometry.add(
+          wave::RotationMd{odometry.values<wave::RotationMd>()[k - 1] *
+                           measurements[k - 1].rotation});
+    }
+    wave::initializeRotationsChordal<wave::RotationMd>(store, measurements);
+
+    const auto error = [&truth](const auto &values) {
+        double sum = 0;
+        for (std::size_t k = 0; k < truth.size(); ++k) {
+            sum += wave::eval(values[k] - truth[k]).value().squaredNorm();
+        }
+        return sum;
+    };
+    EXPECT_LT(error(store.values<wave::RotationMd>()),
+              error(odometry.values<wave::RotationMd>()));
+}
+
+TEST(ChordalInitializationTest, disconnectedThrows) {
+    // Variable 3 is measured only with zero weight
+    auto store = wave::VariableStore<wave::RotationMd>{};
+    for (int k = 0; k < 4; ++k) {
+        store.add(wave::RotationMd::Random());
+    }
+    const auto before = store.values<wave::RotationMd>();
+    const auto R = wave::RotationMd::Random();
+    auto measurements = std::vector<Measurement>{{0, 1, R}, {1, 2, R}, {2, 3, R, 0.0}};
+    EXPECT_THROW(wave::initializeRotationsChordal<wave::RotationMd>(store, measurements),
+                 std::runtime_error);
+    for (std::size_t k = 0; k < 4; ++k) {
+        EXPECT_EQ(before[k].value(), store.values<wave::RotationMd>()[k].value());
+    }
+
+    measurements.back().weight = 1;
+    wave::initializeRotationsChordal<wave::RotationMd>(store, measurements);
+    EXPECT_APPROX(wave::RotationMd{before[0] * R * R * R},
+                  store.values<wave::RotationMd>()[3]);
+}
@@ -0,0 +1,112 @@
+#include "../test.hpp"
+#include "wave/geometry/estimation.hpp"
+
+namespace {
+
+/** A random problem on a chain of 6-dimensional poses, each with a 3-dimensional
+ * point, kept both as a BlockJacobian and as a dense J and r
+ */
+struct ChainProblem {
+    explicit ChainProblem(std::size_t num_poses)
+        : num_poses{num_poses}, J{9 * num_poses}, dense_J(0, 9 * num_poses) {
+        for (std::size_t i = 0; i + 1 < num_poses; ++i) {
+            this->add(6, this->pose(i), 6, this->pose(i + 1), 6);
+        }
+        for (std::size_t i = 0; i < num_poses; ++i) {
+            this->add(4, this->pose(i), 6, this->point(i), 3);
+        }
+        this->addPrior();
+    }
+
+    std::size_t pose(std::size_t i) const {
+        return 6 * i;
+    }
+
+    std::size_t point(std::size_t i) const {
+        return 6 * this->num_poses + 3 * i;
+    }
+
+    void add(int rows, std::size_t a, int size_a, std::size_t b, int size_b) {
+        const Eigen::VectorXd r = Eigen::VectorXd::Random(rows);
+        const Eigen::MatrixXd J_a = Eigen::MatrixXd::Random(rows, size_a);
+        const Eigen::MatrixXd J_b = Eigen::MatrixXd::Random(rows, size_b);
+        this->J.addFactor(r, {a, b}, J_a, J_b);
+
+        const auto m = this->dense_J.rows();
+        this->dense_J.conservativeResize(m + rows, Eigen::NoChange);
+        this->dense_J.bottomRows(rows).setZero();
+        this->dense_J.block(m, a, rows, size_a) = J_a;
+        this->dense_J.block(m, b, rows, size_b) = J_b;
+        this->dense_r.conservativeResize(m + rows);
+        this->dense_r.tail(rows) = r;
+    }
+
+    void addPrior() {
+        const Eigen::Matrix<double, 6, 1> r = Eigen::Matrix<double, 6, 1>::Random();
+        const Eigen::Matrix<double, 6, 6> I = Eigen::Matrix<double, 6, 6>::Identity();
+        this->J.addFactor(r, {0}, I);
+        const auto m = this->dense_J.rows();
+        this->dense_J.conservativeResize(m + 6, Eigen::NoChange);
+        this->dense_J.bottomRows(6).setZero();
+        this->dense_J.block(m, 0, 6, 6) = I;
+        this->dense_r.conservativeResize(m + 6);
+        this->dense_r.tail(6) = r;
+    }
+
+    std::size_t num_poses;
+    wave::BlockJacobian J;
+    Eigen::MatrixXd dense_J;
+    Eigen::VectorXd dense_r;
+};
+
+}  // namespace
+
+TEST(ConjugateGradientTest, products) {
+    const auto problem = ChainProblem{20};
+    const Eigen::MatrixXd &J = problem.dense_J;
+    const Eigen::VectorXd x = Eigen::VectorXd::Random(J.cols());
+    EXPECT_APPROX((J.transpose() * problem.dense_r).eval(), problem.J.gradient());
+    EXPECT_APPROX((J.transpose() * (J * x)).eval(), problem.J.normalProduct(x));
+
+    // Split into tasks of two factors, with partial sums added in a fixed order
+    auto pool = wave::WorkStealingPool{4};
+    EXPECT_APPROX(problem.J.normalProduct(x), problem.J.normalProduct(x, &pool, 2));
+    EXPECT_APPROX(problem.J.gradient(), problem.J.gradient(&pool, 2));
+}
+
+TEST(ConjugateGradientTest, solveMatchesDense) {
+    const auto problem = ChainProblem{30};
+    const Eigen::MatrixXd &J = problem.dense_J;
+    const Eigen::MatrixXd H = J.transpose() * J;
+    const Eigen::VectorXd b = -J.transpose() * problem.dense_r;
+    const Eigen::VectorXd expected = H.llt().solve(b);
+
+    auto options = wave::PcgOptions{};
+    options.relative_tolerance = 1e-12;
+    const auto result = wave::solvePcg(problem.J, options);
+    EXPECT_LE(result.relative_residual, 1e-12);
+    EXPECT_LT(result.iterations, static_cast<int>(J.cols()));
+    EXPECT_APPROX_PREC(expected, result.step, 1e-8);
+
+    // With damping, and on a pool
+    auto pool = wave::WorkStealingPool{4};
+    options.damping = 0.5;
+    options.pool = &pool;
+    options.grain_size = 4;
+    const Eigen::MatrixXd H_damped =
+      H + 0.5 * Eigen::MatrixXd::Identity(H.rows(), H.cols());
+    const Eigen::VectorXd damped = H_damped.llt().solve(b);
+    EXPECT_APPROX_PREC(damped, wave::solvePcg(problem.J, options).step, 1e-8);
+}
+
+TEST(ConjugateGradientTest, blockDiagonalConvergesInOneIteration) {
+    // With one factor per variable, J^T J is block diagonal, and the block-Jacobi
+    // preconditioner is its exact inverse
+    auto J = wave::BlockJacobian{9};
+    J.addFactor(Eigen::VectorXd::Random(8), {0}, Eigen::MatrixXd::Random(8, 6));
+    J.addFactor(Eigen::Vector3d::Random(), {6}, Eigen::Matrix3d::Random());
+
+    const auto result = wave::solvePcg(J);
+    EXPECT_EQ(1, result.iterations);
+    EXPECT_LT(result.relative_residual, 1e-12);
+}
@@ -0,0 +1,121 @@
+#include "../test.hpp"
+#include "wave/geometry/estimation.hpp"
+
+namespace {
+
+using Pose = wave::RigidTransformMd;
+using Point = wave::Translationd;
+using Store = wave::VariableStore<Pose, Point>;
+
+/** Returns the information matrix J^T J of random factors on a chain of poses, each
+ * observing one point, with a prior on the first pose
+ */
+Eigen::MatrixXd chainInformation(const Store &store) {
+    const auto n = store.tangentSize();
+    const auto num_poses = store.values<Pose>().size();
+    Eigen::MatrixXd H = Eigen::MatrixXd::Zero(n, n);
+    const auto addFactor = [&H](Eigen::Index a, int size_a, Eigen::Index b, int size_b) {
+        const Eigen::MatrixXd J_a = Eigen::MatrixXd::Random(6, size_a);
+        const Eigen::MatrixXd J_b = Eigen::MatrixXd::Random(6, size_b);
+        H.block(a, a, size_a, size_a) += J_a.transpose() * J_a;
+        H.block(a, b, size_a, size_b) += J_a.transpose() * J_b;
+        H.block(b, a, size_b, size_a) += J_b.transpose() * J_a;
+        H.block(b, b, size_b, size_b) += J_b.transpose() * J_b;
+    };
+    const auto pose = [&store](std::size_t i) { return store.offset<Pose>() + 6 * i; };
+    const auto point = [&store](std::size_t i) { return store.offset<Point>() + 3 * i; };
+    for (std::size_t i = 0; i + 1 < num_poses; ++i) {
+        addFactor(pose(i), 6, pose(i + 1), 6);
+    }
+    for (std::size_t i = 0; i < num_poses; ++i) {
+        addFactor(pose(i), 6, point(i), 3);
+    }
+    H.block<6, 6>(0, 0) += Eigen::Matrix<double, 6, 6>::Identity();
+    return H;
+}
+
+Store chainStore(std::size_t num_poses) {
+    auto store = Store{};
+    for (std::size_t i = 0; i < num_poses; ++i) {
+        store.add(Pose::Random());
+        store.add(Point::Random());
+    }
+    return store;
+}
+
+}  // namespace
+
+TEST(CovarianceTest, sparseInverseSubsetOnPattern) {
+    const auto store = chainStore(10);
+    const Eigen::MatrixXd H = chainInformation(store);
+    const Eigen::MatrixXd expected = H.inverse();
+    const auto subset = wave::internal::SparseInverseSubset{H.sparseView()};
+
+    // Every entry of a nonzero block of H is on the pattern of the factor
+    const auto n = H.rows();
+    int found = 0;
+    for (Eigen::Index r = 0; r < n; ++r) {
+        for (Eigen::Index c = 0; c < n; ++c) {
+            double value;
+            if (subset.entry(r, c, value)) {
+                EXPECT_NEAR(expected(r, c), value, 1e-9 * expected.norm());
+                ++found;
+            } else {
+                EXPECT_EQ(0.0, H(r, c));
+            }
+        }
+    }
+    EXPECT_LT(found, n * n);
+}
+
+TEST(CovarianceTest, indefiniteMatrixThrows) {
+    const auto store = chainStore(3);
+    Eigen::MatrixXd H = chainInformation(store);
+    H.row(0).setZero();
+    H.col(0).setZero();
+    EXPECT_THROW((wave::MarginalCovariance<Pose, Point>{store, H.sparseView()}),
+                 std::runtime_error);
+}
+
+TEST(CovarianceTest, marginalsAndCrossCovariances) {
+    const std::size_t num_poses = 20;
+    const auto store = chainStore(num_poses);
+    const Eigen::MatrixXd H = chainInformation(store);
+    const Eigen::MatrixXd expected = H.inverse();
+    const auto prec = 1e-9 * expected.norm();
+    const auto cov = wave::MarginalCovariance<Pose, Point>{store, H.sparseView()};
+    const auto pose = store.offset<Pose>();
+    const auto point = store.offset<Point>();
+    const auto check = [&](Eigen::Index row, Eigen::Index col, const auto &block) {
+        const Eigen::MatrixXd actual = block;
+        const Eigen::MatrixXd e = expected.block(row, col, block.rows(), block.cols());
+        EXPECT_APPROX_PREC(e, actual, prec);
+    };
+
+    // Query in an arbitrary order, so the recursion starts from different columns
+    for (const std::size_t i : {7u, 0u, 19u, 12u}) {
+        const wave::BlockMatrix<Pose, Pose> P = cov.covariance<Pose>(i);
+        check(pose + 6 * i, pose + 6 * i, P);
+        const wave::BlockMatrix<Point, Point> L = cov.covariance<Point>(i);
+        check(point + 3 * i, point + 3 * i, L);
+
+        // Pose and its point share a factor
+        check(pose + 6 * i, point + 3 * i, cov.crossCovariance<Pose, Point>(i, i));
+    }
+
+    // Far apart in the chain: found by a solve
+    check(pose + 6 * 2, pose + 6 * 17, cov.crossCovariance<Pose, Pose>(2, 17));
+    check(point + 3 * 15, pose + 6 * 1, cov.crossCovariance<Point, Pose>(15, 1));
+}
+
+TEST(CovarianceTest, constructsNoise) {
+    const auto store = chainStore(5);
+    const Eigen::MatrixXd H = chainInformation(store);
+    const auto cov = wave::MarginalCovariance<Pose, Point>{store, H.sparseView()};
+
+    const auto P = cov.covariance<Pose>(3);
+    const auto noise = wave::FullNoise<Pose>::FromCovariance(P);
+    EXPECT_APPROX(P, noise.covariance());
+    EXPECT_APPROX((noise.inverseSqrtCov() * P * noise.inverseSqrtCov()).eval(),
+                  (Eigen::Matrix<double, 6, 6>::Identity()));
+}
@@ -0,0 +1,81 @@
+#include "../test.hpp"
+#include "wave/geometry/estimation.hpp"
+
+TEST(ErrorStateEkfTest, symmetricProduct) {
+    const Eigen::Matrix<double, 6, 6> A = Eigen::Matrix<double, 6, 6>::Random();
+    const Eigen::Matrix<double, 6, 6> P = A * A.transpose();
+    const Eigen::Matrix<double, 4, 6> F = Eigen::Matrix<double, 4, 6>::Random();
+    const Eigen::Matrix<double, 4, 6> FP = F * P;
+    Eigen::Matrix<double, 4, 4> out;
+    wave::internal::symmetricProduct(FP, F, out);
+    EXPECT_APPROX((F * P * F.transpose()).eval(), out);
+    EXPECT_EQ(out, out.transpose());
+}
+
+TEST(ErrorStateEkfTest, linearStateMatchesKalmanFilter) {
+    // With a translation state, the filter is a plain Kalman filter
+    const auto x0 = wave::Translationd{1, 2, 3};
+    const Eigen::Matrix3d P0 = Eigen::Vector3d{1, 2, 3}.asDiagonal();
+    auto ekf = wave::ErrorStateEkf<wave::Translationd>{x0, P0};
+
+    const auto v = wave::Translationd{0.5, 0, -1};
+    const auto Q = wave::DiagonalNoise<wave::Translationd>::FromStdDev(0.1, 0.2, 0.3);
+    ekf.predict([&v](const auto &x) { return x + v; }, Q);
+    const Eigen::Matrix3d Q_dense = Eigen::Vector3d{0.01, 0.04, 0.09}.asDiagonal();
+    const Eigen::Matrix3d P1 = P0 + Q_dense;
+    EXPECT_APPROX((x0.value() + v.value()).eval(), ekf.state().value());
+    EXPECT_APPROX(P1, ekf.covariance());
+
+    // Measure the state directly
+    const Eigen::Matrix3d R = Eigen::Vector3d{0.5, 0.5, 2}.asDiagonal();
+    const auto z_noise = wave::FullNoise<wave::Translationd>::FromCovariance(R);
+    const auto z = wave::Uncertain<wave::Translationd, wave::FullNoise>{
+      wave::Translationd{2, 2, 2}, z_noise};
+    const auto nis = ekf.update([](const auto &x) { return x; }, z);
+
+    const Eigen::Matrix3d S = P1 + R;
+    const Eigen::Matrix3d K = P1 * S.inverse();
+    const Eigen::Vector3d r = x0.value() + v.value() - z.value.value();
+    const Eigen::Vector3d expected = x0.value() + v.value() - K * r;
+    const Eigen::Matrix3d expected_P = P1 - K * S * K.transpose();
+    EXPECT_APPROX(expected, ekf.state().value());
+    EXPECT_APPROX(expected_P, ekf.covariance());
+    EXPECT_DOUBLE_EQ(r.dot(S.inverse() * r), nis);
+}
+
+TEST(ErrorStateEkfTest, poseConvergesFromLandmarks) {
+    // A rigid transform state, observing known points in its own frame
+    using Pose = wave::RigidTransformQd;
+    const auto axis = Eigen::Vector3d{1, 2, 0}.normalized();
+    const auto truth =
+      Pose{Eigen::Quaterniond{Eigen::AngleAxisd{0.3, axis}}, Eigen::Vector3d{1, -2, 0.5}};
+    const auto landmarks = std::vector<wave::Translationd>{wave::Translationd{5, 0, 0},
+                                                           wave::Translationd{0, 5, 0},
+                                                           wave::Translationd{0, 0, 5}};
+    const auto noise =
+      wave::DiagonalNoise<wave::Translationd>::FromStdDev(1e-3, 1e-3, 1e-3);
+
+    // Start near the truth, where the linearization is accurate
+    const auto error =
+      (Eigen::Matrix<double, 6, 1>{} << 5e-3, -5e-3, 2e-3, 0.01, 0.02, -0.01).finished();
+    const auto start = Pose{truth + wave::Twistd{error}};
+    const Eigen::Matrix<double, 6, 6> P0 = 1e-3 * Eigen::Matrix<double, 6, 6>::Identity();
+    auto ekf = wave::ErrorStateEkf<Pose>{start, P0};
+    const auto Q =
+      wave::DiagonalNoise<Pose>::FromStdDev(1e-6, 1e-6, 1e-6, 1e-6, 1e-6, 1e-6);
+    for (int round = 0; round < 5; ++round) {
+        // A stationary process model
+        ekf.predict([](const auto &T) { return T * Pose::Identity(); }, Q);
+        for (const auto &p : landmarks) {
+            const auto z = wave::Uncertain<wave::Translationd, wave::DiagonalNoise>{
+              wave::eval(inverse(truth) * p), noise};
+            ekf.update([&p](const auto &T) { return inverse(T) * p; }, z);
+        }
+        const auto &P = ekf.covariance();
+        EXPECT_EQ(P, P.transpose());
+        const auto llt = Eigen::LLT<Eigen::Matrix<double, 6, 6>>{P};
+        EXPECT_EQ(Eigen::Success, llt.info());
+    }
+    EXPECT_APPROX_PREC(truth, ekf.state(), 1e-5);
+    EXPECT_LT(ekf.covariance().trace(), 1e-6);
+}
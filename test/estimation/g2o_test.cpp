@@ -0,0 +1,130 @@
+#include "../test.hpp"
+#include "wave/geometry/g2o.hpp"
+
+namespace {
+
+/** Returns the path of a file in the test data directory */
+std::string dataPath(const std::string &name) {
+    const auto here = std::string{__FILE__};
+    return here.substr(0, here.find_last_of('/')) + "/data/" + name;
+}
+
+wave::G2oPoseGraph parse(const std::string &text) {
+    return wave::parseG2o(text.data(), text.data() + text.size());
+}
+
+}  // namespace
+
+TEST(G2oTest, loadFile) {
+    const auto graph = wave::loadG2o(dataPath("small.g2o"));
+    EXPECT_EQ(5u, graph.variables->size());
+    EXPECT_EQ(6u, graph.factors.size());
+    EXPECT_EQ(6u, graph.measurements.size());
+    EXPECT_EQ((std::vector<long>{10, 11, 12, 13, 14}), graph.ids);
+
+    // The measurements are exact
+    for (std::size_t k = 0; k < graph.factors.size(); ++k) {
+        const auto &m = graph.measurements[k];
+        const auto &T_i = graph.pose(m.i);
+        const auto &T_j = graph.pose(m.j);
+        const auto expected = wave::RigidTransformMd{inverse(T_i) * T_j};
+        EXPECT_APPROX_PREC(m.transform, expected, 1e-9);
+
+        const auto &f = graph.factors[k];
+        EXPECT_EQ(2u, f.size());
+        EXPECT_EQ(&(*graph.variables)[m.i], f.begin()->get());
+        const auto [r, J_i, J_j] = f.evaluateWithJacobians(T_i, T_j);
+        EXPECT_LT(r.norm(), 1e-6);
+    }
+
+    // The factors keep the variables alive
+    const auto factor = graph.factors.front();
+    const auto *variable = factor.begin()->get();
+    EXPECT_EQ(variable, &(*graph.variables)[0]);
+}
+
+TEST(G2oTest, parse2d) {
+    const auto graph = parse(
+      "VERTEX_SE2 0 0 0 0\n"
+      "\n"
+      "VERTEX_SE2 1 1.5 0.5 0.3\r\n"
+      "EDGE_SE2 0 1 1.5 0.5 0.3 100 0 0 100 0 400\n"
+      "EDGE_SE2 1 0 -1.5 0.5 -0.3 100 0 0 100 0 400");
+    ASSERT_EQ(2u, graph.variables->size());
+    ASSERT_EQ(2u, graph.factors.size());
+    const auto &T_1 = graph.pose(1);
+    EXPECT_APPROX(Eigen::Vector3d(1.5, 0.5, 0), T_1.translationBlock().value());
+    EXPECT_APPROX(graph.measurements[0].transform, T_1);
+
+    const auto [r, J_0, J_1] = graph.factors[0].evaluateWithJacobians(graph.pose(0), T_1);
+    EXPECT_LT(r.norm(), 1e-9);
+}
+
+TEST(G2oTest, twistInformation) {
+    // Information on the quaternion vector part, which is half the angle
+    Eigen::Matrix<double, 6, 6> g2o = Eigen::Matrix<double, 6, 6>::Zero();
+    g2o.diagonal() << 1, 2, 3, 400, 500, 600;
+    Eigen::Matrix<double, 6, 6> expected = Eigen::Matrix<double, 6, 6>::Zero();
+    expected.diagonal() << 100, 125, 150, 1, 2, 3;
+    EXPECT_APPROX(expected, wave::internal::twistInformation(g2o));
+}
+
+TEST(G2oTest, errors) {
+    EXPECT_THROW(parse("VERTEX_SE2 0 0 x 0\n"), std::runtime_error);
+    EXPECT_THROW(parse("VERTEX_SE2 0 0 0 0\nEDGE_SE2 0 1 0 0 0 1 0 0 1 0 1\n"),
+                 std::runtime_error);
+    EXPECT_THROW(wave::loadG2o(dataPath("missing.g2o")), std::runtime_error);
+
+    EXPECT_THROW(parse("VERTEX_SE2 0 0 0 0\nVERTEX_SE2 0 1 0 0\n"), std::runtime_error);
+
+    // Unknown types of lines are named, with their line
+    try {
+        parse("VERTEX_SE2 0 0 0 0\nVERTEX_XY 1 0 0\n");
+        ADD_FAILURE() << "Expected an exception";
+    } catch (const std::runtime_error &e) {
+        EXPECT_NE(std::string::npos, std::string{e.what()}.find("VERTEX_XY on line 2"));
+    }
+
+    // Comments and FIX lines are ignored
+    const auto graph = parse("# comment\nFIX 0\nVERTEX_SE2 0 0 0 0\n");
+    EXPECT_EQ(1u, graph.variables->size());
+}
+
+TEST(G2oTest, parseToro) {
+    // The same graph in TORO and g2o formats
+    const auto toro = parse(
+      "VERTEX2 0 0 0 0\n"
+      "VERTEX2 1 1.5 0.5 0.3\n"
+      "EDGE2 0 1 1.5 0.5 0.3 100 1 200 400 2 3\n"
+      "VERTEX3 2 1 2 3 0.1 0.2 0.3\n"
+      "EDGE3 1 2 1 2 3 0.1 0.2 0.3 "
+      "1 0 0 0 0 0 2 0 0 0 0 3 0 0 0 400 0 0 500 0 600\n");
+    ASSERT_EQ(3u, toro.variables->size());
+    ASSERT_EQ(2u, toro.factors.size());
+    const auto g2o = parse("VERTEX_SE2 0 0 0 0\n"
+                           "VERTEX_SE2 1 1.5 0.5 0.3\n"
+                           "EDGE_SE2 0 1 1.5 0.5 0.3 100 1 2 200 3 400\n");
+    EXPECT_APPROX(g2o.pose(1), toro.pose(1));
+    // Equal whitened residuals away from the measurement show equal information
+    const auto moved = wave::RigidTransformMd{
+      wave::RotationMd{Eigen::AngleAxisd{0.2, Eigen::Vector3d::UnitZ()}},
+      wave::Translationd{0.1, -0.1, 0.2}};
+    const auto r_g2o = g2o.factors[0].evaluate(g2o.pose(0), moved);
+    const auto r_toro = toro.factors[0].evaluate(toro.pose(0), moved);
+    EXPECT_APPROX(r_g2o, r_toro);
+
+    // Roll, pitch and yaw are applied in that order
+    const auto expected =
+      Eigen::Matrix3d{Eigen::AngleAxisd{0.3, Eigen::Vector3d::UnitZ()} *
+                      Eigen::AngleAxisd{0.2, Eigen::Vector3d::UnitY()} *
+                      Eigen::AngleAxisd{0.1, Eigen::Vector3d::UnitX()}};
+    EXPECT_APPROX(expected, toro.pose(2).rotationBlock().value());
+    EXPECT_APPROX(Eigen::Vector3d(1, 2, 3), toro.pose(2).translationBlock().value());
+
+    // Rotation information comes first in the Twist
+    Eigen::Matrix<double, 6, 6> information = Eigen::Matrix<double, 6, 6>::Zero();
+    information.diagonal() << 400, 500, 600, 1, 2, 3;
+    Eigen::Matrix<double, 6, 6> toro_information = Eigen::Matrix<double, 6, 6>::Zero();
+    toro_information.diagonal() << 1, 2, 3, 400, 500, 600;
+    EXPECT_APPROX(information, wave::internal::eulerTwistInformation(toro_information));
+}
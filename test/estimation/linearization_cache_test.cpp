@@ -0,0 +1,104 @@
+#include "../test.hpp"
+#include "wave/geometry/estimation.hpp"
+
+TEST(LinearizationCacheTest, sharedSubexpressionEvaluatedOnce) {
+    const auto T_wb = wave::RigidTransformMd::Random();
+    const auto T_bc = wave::RigidTransformMd::Random();
+    auto cache = wave::LinearizationCache{};
+
+    for (int i = 0; i < 10; ++i) {
+        // A reprojection-like residual using the cached camera pose
+        const auto p_w = wave::Translationd::Random();
+        const auto &[T_wc, J_wb, J_bc] = cache.evaluate(T_wb * T_bc, T_wb, T_bc);
+        const auto [r, J_wc, J_p] = (inverse(T_wc) * p_w).evalWithJacobians(T_wc, p_w);
+
+        const auto [expected, expected_wb, expected_bc, expected_p] =
+          (inverse(T_wb * T_bc) * p_w).evalWithJacobians(T_wb, T_bc, p_w);
+        EXPECT_APPROX(expected, r);
+        EXPECT_APPROX(expected_wb, J_wc * J_wb);
+        EXPECT_APPROX(expected_bc, J_wc * J_bc);
+        EXPECT_APPROX(expected_p, J_p);
+    }
+    EXPECT_EQ(1u, cache.evaluations());
+    EXPECT_EQ(1u, cache.size());
+}
+
+TEST(LinearizationCacheTest, keyedOnStructureAndLeaves) {
+    const auto T_wb = wave::RigidTransformMd::Random();
+    const auto T_bc = wave::RigidTransformMd::Random();
+    auto cache = wave::LinearizationCache{};
+
+    const auto &a = cache.evaluate(T_wb * T_bc, T_wb, T_bc);
+    const auto &b = cache.evaluate(T_bc * T_wb, T_bc, T_wb);
+    const auto &c = cache.evaluate(inverse(T_wb) * T_bc, T_wb, T_bc);
+    EXPECT_EQ(3u, cache.evaluations());
+    EXPECT_APPROX(wave::eval(T_wb * T_bc), std::get<0>(a));
+    EXPECT_APPROX(wave::eval(T_bc * T_wb), std::get<0>(b));
+    EXPECT_APPROX(wave::eval(inverse(T_wb) * T_bc), std::get<0>(c));
+}
+
+TEST(LinearizationCacheTest, nextPassReevaluates) {
+    auto T_wb = wave::RigidTransformMd::Random();
+    const auto T_bc = wave::RigidTransformMd::Random();
+    auto cache = wave::LinearizationCache{};
+
+    cache.evaluate(T_wb * T_bc, T_wb, T_bc);
+    T_wb = wave::RigidTransformMd::Random();
+    cache.nextPass();
+    const auto &res = cache.evaluate(T_wb * T_bc, T_wb, T_bc);
+    EXPECT_EQ(2u, cache.evaluations());
+    EXPECT_EQ(1u, cache.size());
+    EXPECT_APPROX(wave::eval(T_wb * T_bc), std::get<0>(res));
+}
+
+TEST(LinearizationCacheTest, touchReevaluatesOnlyUsersOfLeaf) {
+    auto T_wb = wave::RigidTransformMd::Random();
+    const auto T_bc = wave::RigidTransformMd::Random();
+    const auto T_bd = wave::RigidTransformMd::Random();
+    auto cache = wave::LinearizationCache{};
+
+    cache.evaluate(T_wb * T_bc, T_wb, T_bc);
+    cache.evaluate(T_bc * T_bd, T_bc, T_bd);
+    T_wb = wave::RigidTransformMd::Random();
+    cache.touch(T_wb);
+    const auto &res = cache.evaluate(T_wb * T_bc, T_wb, T_bc);
+    cache.evaluate(T_bc * T_bd, T_bc, T_bd);
+    EXPECT_EQ(3u, cache.evaluations());
+    EXPECT_APPROX(wave::eval(T_wb * T_bc), std::get<0>(res));
+
+    cache.clear();
+    EXPECT_EQ(0u, cache.size());
+}
+
+TEST(LinearizationCacheTest, keyedOnLeavesOtherThanTargets) {
+    // Same expression type and Jacobian target, but a different non-target leaf
+    const auto T_wb = wave::RigidTransformMd::Random();
+    const auto T_bc1 = wave::RigidTransformMd::Random();
+    const auto T_bc2 = wave::RigidTransformMd::Random();
+    auto cache = wave::LinearizationCache{};
+
+    const auto a = cache.evaluate(T_wb * T_bc1, T_wb);
+    const auto b = cache.evaluate(T_wb * T_bc2, T_wb);
+    EXPECT_EQ(2u, cache.evaluations());
+    EXPECT_APPROX(wave::eval(T_wb * T_bc1), std::get<0>(a));
+    EXPECT_APPROX(wave::eval(T_wb * T_bc2), std::get<0>(b));
+
+    // The order of the leaves is part of the key
+    const auto c = cache.evaluate(T_bc1 * T_bc2, T_bc1);
+    const auto d = cache.evaluate(T_bc2 * T_bc1, T_bc1);
+    EXPECT_EQ(4u, cache.evaluations());
+    EXPECT_APPROX(wave::eval(T_bc1 * T_bc2), std::get<0>(c));
+    EXPECT_APPROX(wave::eval(T_bc2 * T_bc1), std::get<0>(d));
+}
+
+TEST(LinearizationCacheTest, leavesHeldByValueNotCached) {
+    const auto T_wb = wave::RigidTransformMd::Random();
+    auto cache = wave::LinearizationCache{};
+    for (int i = 0; i < 3; ++i) {
+        const auto T_bc = wave::RigidTransformMd::Random();
+        const auto res = cache.evaluate(T_wb * wave::RigidTransformMd{T_bc}, T_wb);
+        EXPECT_APPROX(wave::eval(T_wb * T_bc), std::get<0>(res));
+    }
+    EXPECT_EQ(3u, cache.evaluations());
+    EXPECT_EQ(0u, cache.size());
+}
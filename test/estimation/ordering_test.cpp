@@ -0,0 +1,187 @@
+#include "../test.hpp"
+#include "wave/geometry/estimation.hpp"
+
+namespace {
+
+/** Returns a graph of an n by n grid of variables, each connected to its neighbours */
+wave::VariableGraph makeGrid(std::size_t n) {
+    auto graph = wave::VariableGraph{n * n};
+    for (std::size_t r = 0; r < n; ++r) {
+        for (std::size_t c = 0; c < n; ++c) {
+            if (c + 1 < n) {
+                graph.addFactor({r * n + c, r * n + c + 1});
+            }
+            if (r + 1 < n) {
+                graph.addFactor({r * n + c, (r + 1) * n + c});
+            }
+        }
+    }
+    return graph;
+}
+
+/** Checks an ordering contains each variable once */
+void expectPermutation(std::size_t n, std::vector<std::size_t> ordering) {
+    std::sort(ordering.begin(), ordering.end());
+    auto expected = std::vector<std::size_t>(n);
+    std::iota(expected.begin(), expected.end(), std::size_t{0});
+    EXPECT_EQ(expected, ordering);
+}
+
+}  // namespace
+
+TEST(OrderingTest, fillOfChain) {
+    auto graph = wave::VariableGraph{5};
+    for (std::size_t i = 0; i + 1 < 5; ++i) {
+        graph.addFactor({i, i + 1});
+    }
+    EXPECT_EQ(4u, wave::choleskyFill(graph, {0, 1, 2, 3, 4}));
+
+    // Eliminating the middle first connects its neighbours
+    EXPECT_EQ(5u, wave::choleskyFill(graph, {2, 0, 1, 3, 4}));
+    EXPECT_EQ(4u, wave::choleskyFill(graph, wave::minimumDegreeOrdering(graph)));
+}
+
+TEST(OrderingTest, minimumDegreeEliminatesHubLate) {
+    // A star: variable 0 is connected to all others
+    const std::size_t n = 10;
+    auto graph = wave::VariableGraph{n};
+    for (std::size_t i = 1; i < n; ++i) {
+        graph.addFactor({0, i});
+    }
+    auto natural = std::vector<std::size_t>(n);
+    std::iota(natural.begin(), natural.end(), std::size_t{0});
+    EXPECT_EQ(n * (n - 1) / 2, wave::choleskyFill(graph, natural));
+
+    const auto ordering = wave::minimumDegreeOrdering(graph);
+    expectPermutation(n, ordering);
+    // Once one leaf remains, it ties with the hub
+    EXPECT_TRUE(ordering[n - 1] == 0 || ordering[n - 2] == 0);
+    EXPECT_EQ(n - 1, wave::choleskyFill(graph, ordering));
+}
+
+TEST(OrderingTest, minimumDegreeReducesFillOfGrid) {
+    const std::size_t n = 12;
+    const auto graph = makeGrid(n);
+    auto natural = std::vector<std::size_t>(n * n);
+    std::iota(natural.begin(), natural.end(), std::size_t{0});
+
+    const auto ordering = wave::minimumDegreeOrdering(graph);
+    expectPermutation(n * n, ordering);
+    EXPECT_LT(wave::choleskyFill(graph, ordering), wave::choleskyFill(graph, natural));
+}
+
+TEST(OrderingTest, constrainedOrdering) {
+    const std::size_t n = 6;
+    const auto graph = makeGrid(n);
+
+    // Keep the last row, like the newest poses of a sliding window, at the end
+    auto groups = std::vector<int>(n * n, 0);
+    std::fill(groups.end() - n, groups.end(), 1);
+    const auto ordering = wave::minimumDegreeOrdering(graph, groups);
+    expectPermutation(n * n, ordering);
+    for (std::size_t k = 0; k < n * n; ++k) {
+        EXPECT_EQ(k < n * n - n ? 0 : 1, groups[ordering[k]]);
+    }
+}
+
+TEST(OrderingTest, reverseCuthillMcKeeRecoversChain) {
+    // A chain numbered out of order, and an isolated variable
+    const auto ids = std::vector<std::size_t>{4, 0, 6, 2, 5, 1, 3};
+    auto graph = wave::VariableGraph{8};
+    for (std::size_t i = 0; i + 1 < ids.size(); ++i) {
+        graph.addFactor({ids[i], ids[i + 1]});
+    }
+    const auto ordering = wave::reverseCuthillMcKeeOrdering(graph);
+    expectPermutation(8, ordering);
+
+    // Each variable is next to its neighbours in the chain
+    auto position = std::vector<std::size_t>(8);
+    for (std::size_t k = 0; k < 8; ++k) {
+        position[ordering[k]] = k;
+    }
+    for (std::size_t i = 0; i + 1 < ids.size(); ++i) {
+        const auto a = position[ids[i]];
+        const auto b = position[ids[i + 1]];
+        EXPECT_EQ(1u, std::max(a, b) - std::min(a, b));
+    }
+}
+
+TEST(OrderingTest, reverseCuthillMcKeeBandwidthOfGrid) {
+    // A grid visited from a corner has bandwidth about its width
+    const auto graph = makeGrid(10);
+    const auto ordering = wave::reverseCuthillMcKeeOrdering(graph);
+    expectPermutation(100, ordering);
+    auto position = std::vector<std::size_t>(100);
+    for (std::size_t k = 0; k < 100; ++k) {
+        position[ordering[k]] = k;
+    }
+    std::size_t bandwidth = 0;
+    for (std::size_t v = 0; v < 100; ++v) {
+        for (const auto u : graph.neighbours(v)) {
+            bandwidth = std::max(bandwidth, std::max(position[u], position[v]) -
+                                              std::min(position[u], position[v]));
+        }
+    }
+    EXPECT_LE(bandwidth, 11u);
+}
+
+TEST(OrderingTest, relayoutStore) {
+    auto store = wave::VariableStore<wave::RotationMd, wave::Translationd>{};
+    for (int i = 0; i < 3; ++i) {
+        store.add(wave::RotationMd::Random());
+    }
+    for (int i = 0; i < 2; ++i) {
+        store.add(wave::Translationd::Random());
+    }
+    EXPECT_EQ(5u, store.size());
+    EXPECT_EQ(1u, store.globalIndex<wave::RotationMd>(1));
+    EXPECT_EQ(4u, store.globalIndex<wave::Translationd>(1));
+
+    const auto before = store;
+    const auto new_index = wave::relayout(store, {4, 2, 0, 3, 1});
+
+    // Each type keeps its place; within it, variables follow the ordering
+    const auto expected = std::vector<std::size_t>{1, 2, 0, 4, 3};
+    EXPECT_EQ(expected, new_index);
+    for (std::size_t i = 0; i < 3; ++i) {
+        EXPECT_APPROX(before.values<wave::RotationMd>()[i],
+                      store.values<wave::RotationMd>()[new_index[i]]);
+    }
+    for (std::size_t i = 0; i < 2; ++i) {
+        EXPECT_APPROX(before.values<wave::Translationd>()[i],
+                      store.values<wave::Translationd>()[new_index[3 + i] - 3]);
+    }
+}
+
+TEST(OrderingTest, relayoutKeepsValuesByIndex) {
+    // Pose-graph edges keyed by global index, as a caller would keep them
+    auto store = wave::VariableStore<wave::RigidTransformMd>{};
+    auto edges = std::vector<std::pair<std::size_t, std::size_t>>{};
+    for (std::size_t k = 0; k < 20; ++k) {
+        store.add(wave::RigidTransformMd::Random());
+        if (k > 0) {
+            edges.emplace_back(k - 1, k);
+            edges.emplace_back(k, (7 * k) % 20);
+        }
+    }
+    const auto relative = [&store](std::size_t i, std::size_t j) {
+        const auto &x = store.values<wave::RigidTransformMd>();
+        return wave::RigidTransformMd{inverse(x[i]) * x[j]};
+    };
+    auto expected = std::vector<wave::RigidTransformMd,
+                                Eigen::aligned_allocator<wave::RigidTransformMd>>{};
+    for (const auto &e : edges) {
+        expected.push_back(relative(e.first, e.second));
+    }
+
+    auto ordering = std::vector<std::size_t>(store.size());
+    std::iota(ordering.rbegin(), ordering.rend(), std::size_t{0});
+    const auto new_index = wave::relayout(store, ordering);
+
+    // Expressions rebuilt from the mapped indices see the same values
+    for (std::size_t k = 0; k < edges.size(); ++k) {
+        const auto i = new_index[edges[k].first];
+        const auto j = new_index[edges[k].second];
+        EXPECT_APPROX(expected[k], relative(i, j));
+    }
+}
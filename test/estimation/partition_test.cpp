@@ -0,0 +1,171 @@
+#include "../test.hpp"
+#include "wave/geometry/estimation.hpp"
+
+namespace {
+
+/** Adds the factors of an n by n grid of variables, starting at `first` */
+void addGrid(std::vector<std::vector<std::size_t>> &factors,
+             std::size_t first,
+             std::size_t n) {
+    for (std::size_t r = 0; r < n; ++r) {
+        for (std::size_t c = 0; c < n; ++c) {
+            const auto v = first + r * n + c;
+            if (c + 1 < n) {
+                factors.push_back({v, v + 1});
+            }
+            if (r + 1 < n) {
+                factors.push_back({v, v + n});
+            }
+        }
+    }
+}
+
+/** Two 8 by 8 grids joined by one factor, and a separate 4 by 4 grid */
+std::vector<std::vector<std::size_t>> twoRobotFactors() {
+    auto factors = std::vector<std::vector<std::size_t>>{};
+    addGrid(factors, 0, 8);
+    addGrid(factors, 64, 8);
+    factors.push_back({63, 64});
+    addGrid(factors, 128, 4);
+    return factors;
+}
+
+wave::VariableGraph makeGraph(std::size_t n,
+                              const std::vector<std::vector<std::size_t>> &factors) {
+    auto graph = wave::VariableGraph{n};
+    for (const auto &f : factors) {
+        graph.addFactor(f);
+    }
+    return graph;
+}
+
+}  // namespace
+
+TEST(PartitionTest, incidenceGraphOfG2o) {
+    const auto text = std::string{
+      "VERTEX_SE2 0 0 0 0\nVERTEX_SE2 1 1 0 0\nVERTEX_SE2 2 2 0 0\n"
+      "VERTEX_SE2 3 0 5 0\nVERTEX_SE2 4 1 5 0\n"
+      "EDGE_SE2 3 4 1 0 0 1 0 0 1 0 1\n"
+      "EDGE_SE2 0 1 1 0 0 1 0 0 1 0 1\nEDGE_SE2 1 2 1 0 0 1 0 0 1 0 1\n"};
+    const auto g2o = wave::parseG2o(text.data(), text.data() + text.size());
+
+    // Number the variables as in the block
+    auto variables = std::vector<const wave::FactorVariableBase *>{};
+    for (const auto &v : *g2o.variables) {
+        variables.push_back(&v);
+    }
+    const auto graph = wave::incidenceGraph(g2o.factors, variables);
+    ASSERT_EQ(5u, variables.size());
+    EXPECT_EQ((std::vector<std::size_t>{0, 2}), graph.neighbours(1));
+
+    const auto components = wave::connectedComponents(graph);
+    ASSERT_EQ(2u, components.size());
+    EXPECT_EQ((std::vector<std::size_t>{0, 1, 2}), components[0]);
+    EXPECT_EQ((std::vector<std::size_t>{3, 4}), components[1]);
+
+    // Pointers to factors work too, numbering variables as they are first used
+    auto pointers = std::vector<const wave::FactorBase *>{};
+    for (const auto &f : g2o.factors) {
+        pointers.push_back(&f);
+    }
+    auto found = std::vector<const wave::FactorVariableBase *>{};
+    const auto same = wave::incidenceGraph(pointers, found);
+    ASSERT_EQ(5u, found.size());
+    EXPECT_EQ(&(*g2o.variables)[3], found[0]);
+    EXPECT_EQ((std::vector<std::size_t>{0}), same.neighbours(1));
+}
+
+TEST(PartitionTest, bisectFindsWeakLink) {
+    const auto graph = makeGraph(128 + 16, twoRobotFactors());
+    const auto components = wave::connectedComponents(graph);
+    ASSERT_EQ(2u, components.size());
+    EXPECT_EQ(128u, components[0].size());
+
+    auto dissector = wave::Dissector{graph};
+    const auto split = dissector.bisect(components[0]);
+    EXPECT_EQ(128u, split.left.size() + split.right.size() + split.separator.size());
+    EXPECT_EQ(1u, split.separator.size());
+    EXPECT_GE(split.left.size(), 32u);
+    EXPECT_GE(split.right.size(), 32u);
+
+    // No edges between the sides
+    for (const auto v : split.left) {
+        for (const auto u : graph.neighbours(v)) {
+            EXPECT_FALSE(std::binary_search(split.right.begin(), split.right.end(), u));
+        }
+    }
+}
+
+TEST(PartitionTest, nestedDissectionReducesFillOfGrid) {
+    auto factors = std::vector<std::vector<std::size_t>>{};
+    addGrid(factors, 0, 20);
+    const auto graph = makeGraph(400, factors);
+    auto natural = std::vector<std::size_t>(400);
+    std::iota(natural.begin(), natural.end(), std::size_t{0});
+
+    auto ordering = wave::nestedDissectionOrdering(graph, 16);
+    const auto fill = wave::choleskyFill(graph, ordering);
+    EXPECT_LT(fill, wave::choleskyFill(graph, natural));
+    std::sort(ordering.begin(), ordering.end());
+    EXPECT_EQ(natural, ordering);
+}
+
+TEST(PartitionTest, solvePartitionedMatchesDense) {
+    // Random 3 by 3 blocks on each factor, and a prior on each variable
+    const auto factors = twoRobotFactors();
+    const std::size_t n = 128 + 16;
+    const auto graph = makeGraph(n, factors);
+    auto offsets = std::vector<Eigen::Index>(n + 1);
+    for (std::size_t v = 0; v <= n; ++v) {
+        offsets[v] = 3 * v;
+    }
+    Eigen::MatrixXd H = Eigen::MatrixXd::Identity(3 * n, 3 * n);
+    for (const auto &f : factors) {
+        const Eigen::Matrix<double, 3, 6> J = Eigen::Matrix<double, 3, 6>::Random();
+        const Eigen::Matrix<double, 6, 6> JtJ = J.transpose() * J;
+        const auto a = 3 * f[0];
+        const auto b = 3 * f[1];
+        H.block<3, 3>(a, a) += JtJ.topLeftCorner<3, 3>();
+        H.block<3, 3>(a, b) += JtJ.topRightCorner<3, 3>();
+        H.block<3, 3>(b, a) += JtJ.bottomLeftCorner<3, 3>();
+        H.block<3, 3>(b, b) += JtJ.bottomRightCorner<3, 3>();
+    }
+    const Eigen::VectorXd b = Eigen::VectorXd::Random(3 * n);
+    const Eigen::VectorXd expected = H.llt().solve(b);
+    const Eigen::SparseMatrix<double> sparse = H.sparseView();
+
+    // Whole components only
+    auto options = wave::PartitionOptions{};
+    options.min_bisection_size = 1000;
+    EXPECT_APPROX(expected, wave::solvePartitioned(sparse, b, graph, offsets, options));
+
+    // Bisected, on a pool
+    auto pool = wave::WorkStealingPool{4};
+    options.min_bisection_size = 16;
+    options.pool = &pool;
+    EXPECT_APPROX(expected, wave::solvePartitioned(sparse, b, graph, offsets, options));
+}
+
+TEST(PartitionTest, solvePartitionedSingularThrows) {
+    const auto factors = twoRobotFactors();
+    const std::size_t n = 128 + 16;
+    const auto graph = makeGraph(n, factors);
+    auto offsets = std::vector<Eigen::Index>(n + 1);
+    for (std::size_t v = 0; v <= n; ++v) {
+        offsets[v] = v;
+    }
+    Eigen::MatrixXd H = Eigen::MatrixXd::Identity(n, n);
+    H(0, 0) = 0;
+    const Eigen::VectorXd b = Eigen::VectorXd::Ones(n);
+    const Eigen::SparseMatrix<double> sparse = H.sparseView();
+
+    auto options = wave::PartitionOptions{};
+    EXPECT_THROW(wave::solvePartitioned(sparse, b, graph, offsets, options),
+                 std::runtime_error);
+
+    auto pool = wave::WorkStealingPool{4};
+    options.min_bisection_size = 16;
+    options.pool = &pool;
+    EXPECT_THROW(wave::solvePartitioned(sparse, b, graph, offsets, options),
+                 std::runtime_error);
+}
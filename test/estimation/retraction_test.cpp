@@ -0,0 +1,124 @@
+#include "../test.hpp"
+#include "wave/geometry/estimation.hpp"
+
+template <typename Policy>
+class RetractionTest : public testing::Test {
+ protected:
+    /** Numerical Jacobian of retract<Policy>(x, delta) in the tangent space of its result
+     */
+    template <typename Leaf, typename Vector>
+    static Eigen::MatrixXd numericalJacobian(const Leaf &x, const Vector &delta) {
+        const double h = 1e-7;
+        const auto base = wave::retract<Policy>(x, delta);
+        Eigen::MatrixXd J{delta.size(), delta.size()};
+        for (int k = 0; k < delta.size(); ++k) {
+            Vector d = delta;
+            d(k) += h;
+            const auto moved = wave::retract<Policy>(x, d);
+            J.col(k) = wave::eval(moved - base).value() / h;
+        }
+        return J;
+    }
+};
+
+using Policies = testing::
+  Types<wave::ExpRetraction, wave::CayleyRetraction, wave::FirstOrderRetraction>;
+TYPED_TEST_CASE(RetractionTest, Policies);
+
+TYPED_TEST(RetractionTest, sameRotationForEachStorage) {
+    const auto R = wave::RotationMd::Random();
+    const auto q = wave::RotationQd{R};
+    const Eigen::Vector3d phi = Eigen::Vector3d::Random();
+
+    const auto Rq = wave::RotationMd{wave::retract<TypeParam>(q, phi)};
+    EXPECT_APPROX(wave::retract<TypeParam>(R, phi), Rq);
+
+    const auto T = wave::RigidTransformMd::Random();
+    const auto Tq = wave::RigidTransformQd{T};
+    const Eigen::Matrix<double, 6, 1> xi = Eigen::Matrix<double, 6, 1>::Random();
+    EXPECT_APPROX(wave::retract<TypeParam>(T, xi),
+                  wave::RigidTransformMd{wave::retract<TypeParam>(Tq, xi)});
+}
+
+TYPED_TEST(RetractionTest, resultIsRotation) {
+    const auto R = wave::retract<TypeParam>(wave::RotationMd::Random(),
+                                            Eigen::Vector3d::Random() * 3);
+    EXPECT_APPROX(Eigen::Matrix3d::Identity(), R.value() * R.value().transpose());
+    EXPECT_NEAR(1.0, R.value().determinant(), 1e-12);
+}
+
+TYPED_TEST(RetractionTest, agreesWithExpToFirstOrder) {
+    const auto R = wave::RotationQd::Random();
+    const Eigen::Vector3d phi = 1e-4 * Eigen::Vector3d::Random();
+    const auto expected = wave::eval(R + wave::RelativeRotationd{phi});
+    const auto actual = wave::retract<TypeParam>(R, phi);
+    EXPECT_LT(wave::eval(actual - expected).value().norm(), 1e-11);
+
+    const auto T = wave::RigidTransformQd::Random();
+    const Eigen::Matrix<double, 6, 1> xi = 1e-4 * Eigen::Matrix<double, 6, 1>::Random();
+    const auto expected_T = wave::eval(T + wave::Twistd{xi});
+    const auto actual_T = wave::retract<TypeParam>(T, xi);
+    EXPECT_LT(wave::eval(actual_T - expected_T).value().norm(), 1e-7);
+}
+
+TYPED_TEST(RetractionTest, rotationJacobian) {
+    const auto R = wave::RotationMd::Random();
+    const Eigen::Vector3d phi = Eigen::Vector3d::Random();
+    EXPECT_APPROX_PREC(Eigen::MatrixXd{wave::retractionJacobian<TypeParam>(phi)},
+                       this->numericalJacobian(R, phi),
+                       1e-5);
+
+    // At zero, every retraction has the Jacobian of the exponential map
+    EXPECT_APPROX(Eigen::Matrix3d::Identity(),
+                  wave::retractionJacobian<TypeParam>(Eigen::Vector3d::Zero()));
+}
+
+TYPED_TEST(RetractionTest, rigidJacobian) {
+    const auto T = wave::RigidTransformMd::Random();
+    const Eigen::Matrix<double, 6, 1> xi = Eigen::Matrix<double, 6, 1>::Random();
+    EXPECT_APPROX_PREC(Eigen::MatrixXd{wave::rigidRetractionJacobian<TypeParam>(xi)},
+                       this->numericalJacobian(T, xi),
+                       1e-5);
+}
+
+TYPED_TEST(RetractionTest, storeWithPolicyPerType) {
+    auto store = wave::VariableStore<wave::RotationQd, wave::RigidTransformMd>{};
+    for (int i = 0; i < 10; ++i) {
+        store.add(wave::RotationQd::Random());
+        store.add(wave::RigidTransformMd::Random());
+    }
+    const auto before = store;
+    const Eigen::VectorXd delta = Eigen::VectorXd::Random(store.tangentSize());
+    wave::boxPlus(
+      store, delta, wave::Retractions<TypeParam, wave::CayleyRetraction>{});
+
+    const auto offset = store.offset<wave::RigidTransformMd>();
+    for (int i = 0; i < 10; ++i) {
+        EXPECT_APPROX(wave::retract<TypeParam>(before.values<wave::RotationQd>()[i],
+                                               delta.segment<3>(3 * i)),
+                      store.values<wave::RotationQd>()[i]);
+        EXPECT_APPROX(
+          wave::retract<wave::CayleyRetraction>(
+            before.values<wave::RigidTransformMd>()[i], delta.segment<6>(offset + 6 * i)),
+          store.values<wave::RigidTransformMd>()[i]);
+    }
+}
+
+TEST(RetractionTest, halfAngleAcrossSeriesThreshold) {
+    // The series is used for theta^4 <= epsilon. Each side must match sin and cos to
+    // within rounding, which an error of order theta^2 would not.
+    const double threshold = std::sqrt(Eigen::NumTraits<double>::epsilon());
+    for (const double theta2 : {0.9 * threshold, 1.1 * threshold}) {
+        const double theta = std::sqrt(theta2);
+        double s, c;
+        wave::ExpRetraction::halfAngle(theta2, s, c);
+        EXPECT_NEAR(std::sin(theta / 2) / theta, s, 1e-16);
+        EXPECT_NEAR(std::cos(theta / 2), c, 1e-16);
+
+        // The exp map of a relative rotation uses the same series
+        const Eigen::Vector3d phi = theta * Eigen::Vector3d{1, 2, 2} / 3;
+        const auto q = wave::RotationQd{wave::exp(wave::RelativeRotationd{phi})};
+        const auto expected = Eigen::Quaterniond{Eigen::AngleAxisd{theta, phi / theta}};
+        EXPECT_LT((expected.coeffs() - q.value().coeffs()).norm(), 1e-16);
+    }
+}
@@ -0,0 +1,94 @@
+#include "../test.hpp"
+#include "wave/geometry/estimation.hpp"
+
+TEST(UnscentedTransformTest, sigmaPoints) {
+    const Eigen::Matrix3d A = Eigen::Matrix3d::Random();
+    const Eigen::Matrix3d P = A * A.transpose() + Eigen::Matrix3d::Identity();
+    const auto R = wave::RotationQd{Eigen::Quaterniond{0.5, 0.5, -0.5, 0.5}};
+    const auto x = wave::Uncertain<wave::RotationQd, wave::FullNoise>{
+      R, wave::FullNoise<wave::RotationQd>::FromCovariance(P)};
+    const auto points = wave::SigmaPoints<wave::RotationQd>{x};
+    ASSERT_EQ(7, points.size());
+
+    // The weighted offsets have zero mean and the input covariance
+    const auto &D = points.offsets();
+    const auto &w = points.covarianceWeights();
+    EXPECT_NEAR(0, (D * points.meanWeights()).norm(), 1e-12);
+    EXPECT_APPROX(P, (D * w.asDiagonal() * D.transpose()).eval());
+    EXPECT_DOUBLE_EQ(1, points.meanWeights().sum());
+
+    // Each component is contiguous across points
+    EXPECT_EQ(1, &D(0, 1) - &D(0, 0));
+    EXPECT_EQ(points.size(), &D(1, 0) - &D(0, 0));
+
+    // Each point is the mean box-plus its offset
+    EXPECT_APPROX(R, points.point(0));
+    for (int i = 0; i < points.size(); ++i) {
+        const Eigen::Vector3d offset = D.col(i);
+        EXPECT_APPROX(offset, wave::eval(points.point(i) - R).value());
+    }
+}
+
+TEST(UnscentedTransformTest, indefiniteCovarianceThrows) {
+    const Eigen::Matrix3d P = Eigen::Vector3d{1, 0, 1}.asDiagonal();
+    const auto x = wave::Uncertain<wave::RotationQd, wave::FullNoise>{
+      wave::RotationQd{Eigen::Quaterniond::Identity()},
+      wave::FullNoise<wave::RotationQd>::FromCovariance(P)};
+    EXPECT_THROW(wave::SigmaPoints<wave::RotationQd>{x}, std::runtime_error);
+}
+
+TEST(UnscentedTransformTest, identityRecoversInput) {
+    // On a manifold, box-minus of the points recovers their offsets exactly
+    const auto T = wave::RigidTransformQd{
+      Eigen::Quaterniond{Eigen::AngleAxisd{1, Eigen::Vector3d::UnitY()}},
+      Eigen::Vector3d{1, 2, 3}};
+    using Noise = wave::DiagonalNoise<wave::RigidTransformQd>;
+    const auto noise = Noise::FromStdDev(0.3, 0.2, 0.1, 1.0, 2.0, 3.0);
+    const auto x = wave::Uncertain<wave::RigidTransformQd, wave::DiagonalNoise>{T, noise};
+
+    const auto result = wave::unscentedTransform([](const auto &T) { return T; }, x);
+    const Eigen::Matrix<double, 6, 6> P = noise.covariance();
+    EXPECT_APPROX(T, result.mean);
+    EXPECT_APPROX(P, result.covariance);
+    EXPECT_APPROX(P, result.cross_covariance);
+    EXPECT_EQ(1, result.iterations);
+}
+
+TEST(UnscentedTransformTest, smallCovarianceMatchesLinearization) {
+    using Pose = wave::RigidTransformQd;
+    const auto R = Eigen::Quaterniond{Eigen::AngleAxisd{0.5, Eigen::Vector3d::UnitZ()}};
+    const auto T = Pose{R, Eigen::Vector3d{1, -2, 0.5}};
+    const auto p = wave::Translationd{5, 1, 2};
+    const auto noise =
+      wave::DiagonalNoise<Pose>::FromStdDev(1e-4, 2e-4, 1e-4, 1e-3, 1e-3, 2e-3);
+    const auto x = wave::Uncertain<Pose, wave::DiagonalNoise>{T, noise};
+
+    const auto h = [&p](const auto &T) { return inverse(T) * p; };
+    const auto result = wave::unscentedTransform(h, x);
+    const auto [value, J] = h(T).evalWithJacobians(T);
+    const Eigen::Matrix<double, 6, 6> P = noise.covariance();
+    const Eigen::Matrix3d expected = J * P * J.transpose();
+    const Eigen::Matrix<double, 6, 3> expected_cross = P * J.transpose();
+
+    EXPECT_APPROX_PREC(value, result.mean, 1e-6);
+    const Eigen::Matrix3d covariance = result.covariance;
+    const Eigen::Matrix<double, 6, 3> cross_covariance = result.cross_covariance;
+    EXPECT_APPROX_PREC(expected, covariance, 1e-3);
+    EXPECT_APPROX_PREC(expected_cross, cross_covariance, 1e-3);
+}
+
+TEST(UnscentedTransformTest, nonlinearMean) {
+    // Rotating a point by a rotation with large uncertainty about z pulls the mean of
+    // the result toward the z axis, by E[cos(theta)] = exp(-sigma^2 / 2) for a Gaussian
+    // angle. The unscented mean matches it to fourth order in sigma.
+    const double sigma = 0.3;
+    const auto x = wave::Uncertain<wave::RotationQd, wave::DiagonalNoise>{
+      wave::RotationQd{Eigen::Quaterniond::Identity()},
+      wave::DiagonalNoise<wave::RotationQd>::FromStdDev(1e-9, 1e-9, sigma)};
+    const auto p = wave::Translationd{1, 0, 0};
+
+    const auto h = [&p](const auto &R) { return R * p; };
+    const auto result = wave::unscentedTransform(h, x);
+    EXPECT_NEAR(std::exp(-sigma * sigma / 2), result.mean.value().x(), 1e-3);
+    EXPECT_NEAR(0, result.mean.value().y(), 1e-12);
+}
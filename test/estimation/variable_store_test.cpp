@@ -0,0 +1,127 @@
+#include "../test.hpp"
+#include "wave/geometry/estimation.hpp"
+
+namespace {
+
+using Store = wave::VariableStore<wave::RotationQd,
+                                  wave::RotationMd,
+                                  wave::RigidTransformQd,
+                                  wave::Translationd>;
+
+/** Fills a store with n random variables of each type */
+Store makeStore(int n) {
+    auto store = Store{};
+    for (int i = 0; i < n; ++i) {
+        store.add(wave::RotationQd::Random());
+        store.add(wave::RotationMd::Random());
+        store.add(wave::RigidTransformQd::Random());
+        store.add(wave::Translationd::Random());
+    }
+    return store;
+}
+
+/** Checks each variable in `actual` equals box-plus applied to it one at a time */
+template <typename Leaf>
+void expectBoxPlusOfEach(const Store &before,
+                         const Store &actual,
+                         const Eigen::VectorXd &delta) {
+    using Tangent = typename wave::internal::traits<Leaf>::TangentType;
+    constexpr int Size = wave::internal::traits<Leaf>::TangentSize;
+    const auto &x = before.values<Leaf>();
+    const auto offset = before.offset<Leaf>();
+    for (std::size_t i = 0; i < x.size(); ++i) {
+        const auto d = Tangent{delta.segment<Size>(offset + i * Size)};
+        EXPECT_APPROX(wave::eval(x[i] + d), actual.values<Leaf>()[i]);
+    }
+}
+
+void expectBoxPlusOfAll(const Store &before,
+                        const Store &actual,
+                        const Eigen::VectorXd &delta) {
+    expectBoxPlusOfEach<wave::RotationQd>(before, actual, delta);
+    expectBoxPlusOfEach<wave::RotationMd>(before, actual, delta);
+    expectBoxPlusOfEach<wave::RigidTransformQd>(before, actual, delta);
+    expectBoxPlusOfEach<wave::Translationd>(before, actual, delta);
+}
+
+}  // namespace
+
+TEST(VariableStoreTest, layout) {
+    const auto store = makeStore(5);
+    EXPECT_EQ(5u, store.values<wave::RigidTransformQd>().size());
+    EXPECT_EQ(5u * (3 + 3 + 6 + 3), store.tangentSize());
+    EXPECT_EQ(0u, store.offset<wave::RotationQd>());
+    EXPECT_EQ(15u, store.offset<wave::RotationMd>());
+    EXPECT_EQ(30u, store.offset<wave::RigidTransformQd>());
+    EXPECT_EQ(60u, store.offset<wave::Translationd>());
+    EXPECT_EQ(30u + 2 * 6, store.tangentOffset<wave::RigidTransformQd>(2));
+}
+
+TEST(VariableStoreTest, boxPlusMatchesEachVariable) {
+    const auto before = makeStore(100);
+    const Eigen::VectorXd delta = Eigen::VectorXd::Random(before.tangentSize());
+    auto store = before;
+    wave::boxPlus(store, delta);
+    expectBoxPlusOfAll(before, store, delta);
+}
+
+TEST(VariableStoreTest, boxPlusSmallUpdates) {
+    // Updates small enough to use the series expansion of the exp map
+    const auto before = makeStore(10);
+    const Eigen::VectorXd delta = 1e-5 * Eigen::VectorXd::Random(before.tangentSize());
+    auto store = before;
+    wave::boxPlus(store, delta);
+    expectBoxPlusOfAll(before, store, delta);
+}
+
+TEST(VariableStoreTest, boxPlusWithEmptyGroup) {
+    // No Translation variables, so that range is empty
+    auto before = Store{};
+    for (int i = 0; i < 10; ++i) {
+        before.add(wave::RotationQd::Random());
+        before.add(wave::RigidTransformQd::Random());
+    }
+    ASSERT_TRUE(before.values<wave::Translationd>().empty());
+    const Eigen::VectorXd delta = Eigen::VectorXd::Random(before.tangentSize());
+    auto store = before;
+    wave::boxPlus(store, delta);
+    expectBoxPlusOfAll(before, store, delta);
+}
+
+TEST(VariableStoreTest, boxPlusOnPool) {
+    const auto before = makeStore(1000);
+    const Eigen::VectorXd delta = Eigen::VectorXd::Random(before.tangentSize());
+    auto pool = wave::WorkStealingPool{4};
+    auto options = wave::BoxPlusOptions{};
+    options.pool = &pool;
+    options.grain_size = 64;
+
+    auto serial = before;
+    auto parallel = before;
+    wave::boxPlus(serial, delta);
+    wave::boxPlus(parallel, delta, options);
+    expectBoxPlusOfAll(before, parallel, delta);
+    EXPECT_EQ(serial.values<wave::RotationQd>()[999].value().coeffs(),
+              parallel.values<wave::RotationQd>()[999].value().coeffs());
+}
+
+TEST(VariableStoreTest, boxPlusRenormalizesQuaternions) {
+    auto store = makeStore(10);
+    // Let the quaternions drift away from unit norm
+    for (auto &q : store.values<wave::RotationQd>()) {
+        q.value().coeffs() *= 1.01;
+    }
+    for (auto &T : store.values<wave::RigidTransformQd>()) {
+        T.rotationBlock().value().coeffs() *= 1.01;
+    }
+    auto options = wave::BoxPlusOptions{};
+    options.renormalize_quaternions = true;
+    wave::boxPlus(store, Eigen::VectorXd::Random(store.tangentSize()), options);
+
+    for (const auto &q : store.values<wave::RotationQd>()) {
+        EXPECT_NEAR(1.0, q.value().norm(), 1e-12);
+    }
+    for (const auto &T : store.values<wave::RigidTransformQd>()) {
+        EXPECT_NEAR(1.0, T.rotationBlock().value().norm(), 1e-12);
+    }
+}
@@ -57,7 +57,7 @@ class ManifoldTest : public testing::Test {
     TICK_TRAIT_CHECK(wave::internal::is_binary_expression<wave::Compose<Leaf, Leaf>>);
     TICK_TRAIT_CHECK(
       wave::internal::is_binary_expression<wave::BoxPlus<LeafAB, RelLeafAAB>>);
-    TICK_TRAIT_CHECK(wave::internal::is_unary_expression<wave::BoxMinus<LeafAB, LeafAB>>);
+    TICK_TRAIT_CHECK(wave::internal::is_binary_expression<wave::BoxMinus<LeafAB, LeafAB>>);
 };
 
 // Use a type-parametrized test case, meaning we can instantiate it with types later
@@ -205,6 +205,38 @@ TYPED_TEST_P(ManifoldTest, boxMinusJacobian) {
     CHECK_JACOBIANS(false, r1 - r2, r1, r2);
 }
 
+TYPED_TEST_P(ManifoldTest, boxMinusMatchesLogMap) {
+    // Keep away from angles near pi, where the log map is poorly conditioned
+    const auto r1 = TestFixture::LeafAB::Random();
+    const auto rel = TestFixture::RelLeafAAB::Random();
+    const auto r2 = typename TestFixture::LeafAB{r1 + rel};
+    const auto expected = eval(log(r1 * inverse(r2)));
+    EXPECT_APPROX(expected, eval(r1 - r2));
+
+    const auto &[res, J1, J2] = (r1 - r2).evalWithJacobians(r1, r2);
+    const auto &[expected_res, expected_J1, expected_J2] =
+      log(r1 * inverse(r2)).evalWithJacobians(r1, r2);
+    EXPECT_APPROX(expected_res, res);
+    EXPECT_APPROX(expected_J1, J1);
+    EXPECT_APPROX(expected_J2, J2);
+}
+
+TYPED_TEST_P(ManifoldTest, boxMinusJacobianNearZero) {
+    // Residuals are usually near zero, where the closed forms need care
+    using S = typename TestFixture::Scalar;
+    const auto r1 = TestFixture::LeafAB::Random();
+    auto rel = TestFixture::RelLeafAAB::Random();
+    rel.value() *= S{1e-7};
+    const auto r2 = typename TestFixture::LeafAB{r1 + rel};
+    const auto &[res, J1, J2] = (r1 - r2).evalWithJacobians(r1, r2);
+    EXPECT_LT((res.value() + rel.value()).norm(), this->dummy_prec);
+    using Jacobian = Eigen::Matrix<S, Eigen::Dynamic, Eigen::Dynamic>;
+    const auto I = Jacobian::Identity(J1.rows(), J1.cols()).eval();
+    EXPECT_APPROX_PREC(I, Jacobian{J1}, S{1e-6});
+    EXPECT_APPROX_PREC((-I).eval(), Jacobian{J2}, S{1e-6});
+    CHECK_JACOBIANS(false, r1 - r2, r1, r2);
+}
+
 // Register the test case (having to list all the tests again)
 REGISTER_TYPED_TEST_CASE_P(ManifoldTest,
                            constructRandom,
@@ -221,4 +253,6 @@ REGISTER_TYPED_TEST_CASE_P(ManifoldTest,
                            expMapJacobian,
                            expMapJacobianNearZero,
                            boxPlusJacobian,
-                           boxMinusJacobian);
+                           boxMinusJacobian,
+                           boxMinusMatchesLogMap,
+                           boxMinusJacobianNearZero);
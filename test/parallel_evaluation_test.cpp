@@ -0,0 +1,91 @@
+#include "test.hpp"
+#include "wave/geometry/dynamic.hpp"
+#include "wave/geometry/geometry.hpp"
+
+namespace {
+
+using Rotation = wave::RotationMd;
+using Translation = wave::Translationd;
+
+/** Builds a balanced tree of compositions over n rotations, plus shared nodes */
+struct RotationTree {
+    explicit RotationTree(int n) {
+        for (int i = 0; i < n; ++i) {
+            rotations.emplace_back(Rotation::Random());
+        }
+        auto level = rotations;
+        while (level.size() > 1) {
+            auto next = std::vector<wave::Proxy<Rotation>>{};
+            for (std::size_t i = 0; i + 1 < level.size(); i += 2) {
+                next.emplace_back(level[i] * level[i + 1]);
+            }
+            if (level.size() % 2) {
+                next.push_back(level.back());
+            }
+            level = std::move(next);
+        }
+        // Reuse a leaf and an inner node, so some nodes have several parents
+        result = wave::Proxy<Translation>{level.front() * rotations.front() *
+                                          (rotations.back() * t)};
+    }
+
+    wave::Proxy<Translation> t{Translation::Random()};
+    std::vector<wave::Proxy<Rotation>> rotations;
+    wave::Proxy<Translation> result{Translation::Random()};  // replaced in constructor
+};
+
+/** Checks two maps have the same Jacobians for each of the given keys */
+template <typename Map, typename Keys>
+void expectSameJacobians(const Map &expected, const Map &actual, const Keys &keys) {
+    for (const auto &key : keys) {
+        EXPECT_APPROX(Eigen::MatrixXd{expected.at(key.first)},
+                      Eigen::MatrixXd{actual.at(key.first)});
+    }
+}
+
+}  // namespace
+
+TEST(ParallelEvaluationTest, grainSize) {
+    const auto tree = RotationTree{16};
+    auto pool = wave::WorkStealingPool{4};
+    const auto &root = tree.result.follow();
+
+    EXPECT_FALSE((wave::internal::ParallelSweep<double>{root, pool, 1000}.isParallel()));
+    EXPECT_TRUE((wave::internal::ParallelSweep<double>{root, pool, 1}.isParallel()));
+
+    // A pool with one thread is never used
+    auto serial_pool = wave::WorkStealingPool{1};
+    EXPECT_FALSE((wave::internal::ParallelSweep<double>{root, serial_pool, 1}.isParallel()));
+}
+
+TEST(ParallelEvaluationTest, evaluate) {
+    const auto tree = RotationTree{100};
+    auto pool = wave::WorkStealingPool{4};
+    const auto expected = tree.result.eval();
+
+    for (const auto grain_size : {1, 1000}) {
+        for (int rep = 0; rep < 5; ++rep) {
+            EXPECT_APPROX(expected,
+                          wave::internal::evaluateParallel(tree.result, pool, grain_size));
+        }
+    }
+    // The graph can still be evaluated normally afterwards
+    EXPECT_APPROX(expected, tree.result.eval());
+}
+
+TEST(ParallelEvaluationTest, reverseJacobians) {
+    const auto tree = RotationTree{100};
+    auto pool = wave::WorkStealingPool{4};
+    const auto expected =
+      wave::internal::evaluateWithDynamicReverseJacobians(tree.result);
+    const auto leaves = wave::internal::getLeavesMap(tree.result);
+
+    for (const auto grain_size : {1, 1000}) {
+        for (int rep = 0; rep < 5; ++rep) {
+            const auto actual = wave::internal::evaluateWithParallelReverseJacobians(
+              tree.result, pool, grain_size);
+            EXPECT_APPROX(expected.first, actual.first);
+            expectSameJacobians(expected.second, actual.second, leaves);
+        }
+    }
+}
@@ -76,8 +76,8 @@ TYPED_TEST_P(RigidTransformTest, getters) {
 
     EXPECT_APPROX(this->R1, typename TestFixture::Matrix3{R});
     EXPECT_APPROX(this->t1, t);
-    //    CHECK_JACOBIANS(true, rt.rotation(), rt);
-    //    CHECK_JACOBIANS(true, rt.translation(), rt);
+    CHECK_JACOBIANS(true, rt.rotation(), rt);
+    CHECK_JACOBIANS(true, rt.translation(), rt);
 }
 
 TYPED_TEST_P(RigidTransformTest, assignRvalueViaSubobject) {
@@ -192,6 +192,56 @@ TYPED_TEST_P(RigidTransformTest, composeWithQ) {
     CHECK_JACOBIANS(expected_unique, lhs * rhs, lhs, rhs);
 }
 
+TYPED_TEST_P(RigidTransformTest, subobjectsOfCompose) {
+    const auto lhs = TestFixture::LeafAB::Random();
+    const auto rhs = TestFixture::TransformQ_BC::Random();
+    const auto expected = typename TestFixture::LeafAC{lhs * rhs};
+
+    // Each part is computed from the needed parts of the operands, not the whole product
+    using wave::internal::expr;
+    using wave::internal::get_expr_tag_t;
+    static_assert(
+      std::is_same<expr<wave::Compose>, get_expr_tag_t<decltype((lhs * rhs).rotation())>>{},
+      "");
+    static_assert(std::is_same<expr<wave::Transform>,
+                               get_expr_tag_t<decltype((lhs * rhs).translation())>>{},
+                  "");
+
+    EXPECT_APPROX(expected.rotation(), (lhs * rhs).rotation());
+    EXPECT_APPROX(expected.translation(), (lhs * rhs).translation());
+
+    // The rewritten expressions must not refer to the temporary product
+    const auto rotation = (typename TestFixture::LeafAB{lhs} * rhs).rotation();
+    const auto translation = (typename TestFixture::LeafAB{lhs} * rhs).translation();
+    EXPECT_APPROX(expected.rotation(), rotation);
+    EXPECT_APPROX(expected.translation(), translation);
+
+    const bool expected_unique =
+      TestFixture::IsFramed ||
+      !std::is_same<typename TestFixture::Leaf, typename TestFixture::TransformQ>{};
+    CHECK_JACOBIANS(expected_unique, (lhs * rhs).rotation(), lhs, rhs);
+    CHECK_JACOBIANS(expected_unique, (lhs * rhs).translation(), lhs, rhs);
+}
+
+TYPED_TEST_P(RigidTransformTest, subobjectsOfInverse) {
+    const auto rt = TestFixture::LeafAB::Random();
+    const auto expected = typename TestFixture::LeafBA{inverse(rt)};
+
+    static_assert(
+      std::is_same<wave::internal::expr<wave::Inverse>,
+                   wave::internal::get_expr_tag_t<decltype(inverse(rt).rotation())>>{},
+      "");
+
+    EXPECT_APPROX(expected.rotation(), inverse(rt).rotation());
+    EXPECT_APPROX(expected.translation(), inverse(rt).translation());
+
+    const auto translation = inverse(typename TestFixture::LeafAB{rt}).translation();
+    EXPECT_APPROX(expected.translation(), translation);
+
+    CHECK_JACOBIANS(true, inverse(rt).rotation(), rt);
+    CHECK_JACOBIANS(true, inverse(rt).translation(), rt);
+}
+
 TYPED_TEST_P(RigidTransformTest, transformVector) {
     const auto rt = TestFixture::LeafBA::Random();
     const auto p1 = TestFixture::PointAAC::Random();
@@ -220,4 +270,6 @@ REGISTER_TYPED_TEST_CASE_P(RigidTransformTest,
                            inverseExpr,
                            composeWithM,
                            composeWithQ,
+                           subobjectsOfCompose,
+                           subobjectsOfInverse,
                            transformVector);
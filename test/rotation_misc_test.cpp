@@ -36,3 +36,93 @@ TEST(RotationMiscTest, constructRotationMMap) {
     EXPECT_APPROX(m, r.value());
     EXPECT_EQ(m.data(), r.value().data());
 }
+
+TEST(RotationMiscTest, inverseOfMatrixIsTransposedView) {
+    using RotationM = wave::RotationMd;
+    using InverseEval = wave::internal::eval_t<wave::Inverse<const RotationM &>>;
+    using ComposeEval =
+      wave::internal::eval_t<wave::Compose<wave::Inverse<const RotationM &>, const RotationM &>>;
+
+    // The inverse is a view, and composing it gives a plain column-major matrix
+    static_assert(
+      std::is_same<InverseEval,
+                   wave::MatrixRotation<Eigen::Transpose<const Eigen::Matrix3d>>>{},
+      "Expected inverse of a matrix rotation to be a transposed view");
+    static_assert(std::is_same<ComposeEval, RotationM>{},
+                  "Expected a column-major matrix from composing an inverse");
+
+    // The evaluated inverse refers to the leaf itself, not a copy
+    const auto R1 = RotationM::Random();
+    const auto R2 = RotationM::Random();
+    const auto inv = inverse(R1);
+    const auto &evaluator = wave::internal::prepareEvaluator(inv);
+    EXPECT_EQ(R1.value().data(), evaluator().value().nestedExpression().data());
+
+    EXPECT_APPROX(RotationM{R1.value().transpose() * R2.value()}, eval(inverse(R1) * R2));
+    EXPECT_APPROX(wave::Translationd{R1.value().transpose() * Eigen::Vector3d::UnitX()},
+                  eval(inverse(R1) * wave::Translationd{Eigen::Vector3d::UnitX()}));
+}
+
+TEST(RotationMiscTest, rotateChainEvaluatedRightToLeft) {
+    const auto R1 = wave::RotationMd::Random();
+    const auto R2 = wave::RotationQd::Random();
+    const auto R3 = wave::RotationMd::Random();
+    const auto v = wave::Translationd::Random();
+    const auto expr = R1 * R2 * R3 * v;
+
+    // For the value, the chain is applied to the vector one rotation at a time
+    using Rewritten =
+      decltype(wave::internal::rewriteForValue(wave::internal::adl{}, expr));
+    using Expected = wave::Rotate<
+      const wave::RotationMd &,
+      wave::Rotate<const wave::RotationQd &,
+                   wave::Rotate<const wave::RotationMd &, const wave::Translationd &>>>;
+    static_assert(std::is_same<Rewritten, Expected>{}, "Expected a right-nested chain");
+
+    const Eigen::Vector3d expected =
+      R1.value() * (R2.value() * (R3.value() * v.value()));
+    EXPECT_APPROX(expected, eval(expr).value());
+    EXPECT_APPROX(expected, wave::Translationd{expr}.value());
+
+    // Jacobians are still correct
+    CHECK_JACOBIANS(false, expr, R1, R2, R3, v);
+}
+
+struct FrameA;
+struct FrameB;
+struct FrameC;
+struct FrameD;
+
+TEST(RotationMiscTest, transformChainEvaluatedRightToLeft) {
+    const auto T1 = wave::RigidTransformMFd<FrameA, FrameB>::Random();
+    const auto T2 = wave::RigidTransformQFd<FrameB, FrameC>::Random();
+    const auto p = wave::TranslationFd<FrameC, FrameC, FrameD>::Random();
+    const auto expr = T1 * T2 * p;
+
+    static_assert(wave::internal::has_value_rewrite<decltype(expr)>{},
+                  "Expected a value rewrite");
+
+    const auto expected = wave::TranslationFd<FrameA, FrameA, FrameD>{eval(T1 * T2) * p};
+    EXPECT_APPROX(expected, eval(expr));
+    CHECK_JACOBIANS(true, expr, T1, T2, p);
+}
+
+TEST(RotationMiscTest, inverseJacobianCoeffPrecision) {
+    // Reference from the series in long double, or the closed form far from zero
+    const auto reference = [](long double t2) {
+        if (t2 > 0.1L) {
+            const auto t = std::sqrt(t2);
+            return (1 - t * std::sin(t) / (2 * (1 - std::cos(t)))) / t2;
+        }
+        return 1.0L / 12 + t2 / 720 + t2 * t2 / 30240 + t2 * t2 * t2 / 1209600 +
+               t2 * t2 * t2 * t2 / 47900160;
+    };
+    // Around sqrt(epsilon), where 1 - cos(theta) lost half its digits, around the
+    // switch to the series, and far from it
+    const double root_eps = std::sqrt(Eigen::NumTraits<double>::epsilon());
+    for (const double t2 : {0.9 * root_eps, 1.1 * root_eps, 0.009, 0.011, 1.0, 9.0}) {
+        const auto expected = static_cast<double>(reference(t2));
+        EXPECT_NEAR(expected, wave::internal::inverseJacobianCoeff(t2), 1e-13 * expected)
+          << "theta^2 = " << t2;
+    }
+}
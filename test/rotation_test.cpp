@@ -58,7 +58,7 @@ class RotationTest : public testing::Test {
     TICK_TRAIT_CHECK(wave::internal::is_derived_rotation<LeafAB>);
     TICK_TRAIT_CHECK(wave::internal::is_binary_expression<wave::Compose<Leaf, Leaf>>);
     TICK_TRAIT_CHECK(wave::internal::is_binary_expression<wave::BoxPlus<LeafAB, RelAAB>>);
-    TICK_TRAIT_CHECK(wave::internal::is_unary_expression<wave::BoxMinus<LeafAB, LeafAB>>);
+    TICK_TRAIT_CHECK(wave::internal::is_binary_expression<wave::BoxMinus<LeafAB, LeafAB>>);
 };
 
 // Use a type-parametrized test case, meaning we can instantiate it with types later
@@ -155,6 +155,54 @@ TEST(CrossMatrixTest, multiplyCrossMatrices) {
     }
 }
 
+TEST(CrossMatrixTest, multiplyCrossMatricesClosedForm) {
+    Eigen::Vector3d a, b;
+    Eigen::Matrix3d expected, actual;
+    for (int reps = 100; reps--;) {
+        a.setRandom();
+        b.setRandom();
+
+        expected = manualCrossMatrix(a) * manualCrossMatrix(b);
+        actual = wave::crossMatrix(a) * wave::crossMatrix(b);
+        EXPECT_APPROX(expected, actual);
+
+        // Square
+        expected = manualCrossMatrix(a) * manualCrossMatrix(a);
+        actual = wave::crossMatrix(a) * wave::crossMatrix(a);
+        EXPECT_APPROX(expected, actual);
+        EXPECT_APPROX((a * a.transpose() - a.squaredNorm() * Eigen::Matrix3d::Identity()),
+                      actual);
+
+        // Expressions of vectors
+        expected = manualCrossMatrix(-a) * manualCrossMatrix(2 * b);
+        actual = wave::crossMatrix(-a) * wave::crossMatrix(2 * b);
+        EXPECT_APPROX(expected, actual);
+    }
+}
+
+TEST(CrossMatrixTest, lazyExpressions) {
+    Eigen::Vector3d a;
+    Eigen::Matrix3d expected, actual;
+    for (int reps = 100; reps--;) {
+        a.setRandom();
+
+        // The cross matrix takes part in coefficient-wise expressions without being stored
+        expected = Eigen::Matrix3d::Identity() - 0.5 * manualCrossMatrix(a);
+        actual = Eigen::Matrix3d::Identity() - 0.5 * wave::crossMatrix(a);
+        EXPECT_APPROX(expected, actual);
+
+        expected = manualCrossMatrix(a).transpose();
+        actual = wave::crossMatrix(a).transpose();
+        EXPECT_APPROX(expected, actual);
+        EXPECT_APPROX(expected, wave::crossMatrix(-a));
+
+        Eigen::Matrix<double, 6, 6> block = Eigen::Matrix<double, 6, 6>::Zero();
+        block.bottomLeftCorner<3, 3>() = wave::crossMatrix(a);
+        actual = block.bottomLeftCorner<3, 3>();
+        EXPECT_APPROX(manualCrossMatrix(a), actual);
+    }
+}
+
 TEST(CrossMatrixTest, inverse) {
     Eigen::Vector3d a;
     Eigen::Matrix3d expected, actual;
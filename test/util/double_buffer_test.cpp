@@ -0,0 +1,49 @@
+#include "wave/geometry/src/util/parallel/DoubleBuffer.hpp"
+#include "../test.hpp"
+#include <vector>
+
+TEST(DoubleBufferTest, readsLatestValue) {
+    auto buffer = wave::DoubleBuffer<std::vector<int>>{{1, 2}};
+    EXPECT_EQ((std::vector<int>{1, 2}), buffer.load());
+
+    buffer.write([](std::vector<int> &v) { v.push_back(3); });
+    EXPECT_EQ((std::vector<int>{1, 2, 3}), buffer.load());
+    buffer.store({4});
+    EXPECT_EQ(1u, buffer.read([](const std::vector<int> &v) { return v.size(); }));
+}
+
+TEST(DoubleBufferTest, readersNeverSeePartialWrites) {
+    // Each write fills the array with one number; a torn read would mix two
+    const int num_writes = 2000;
+    auto buffer = wave::DoubleBuffer<std::array<int, 64>>{{}};
+    auto done = std::atomic<bool>{false};
+    auto readers = std::vector<std::thread>{};
+    auto torn = std::atomic<int>{0};
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&] {
+            int last = 0;
+            while (!done.load()) {
+                const auto a = buffer.load();
+                for (const auto x : a) {
+                    if (x != a[0]) {
+                        ++torn;
+                    }
+                }
+                // Values only increase
+                if (a[0] < last) {
+                    ++torn;
+                }
+                last = a[0];
+            }
+        });
+    }
+    for (int i = 1; i <= num_writes; ++i) {
+        buffer.write([i](std::array<int, 64> &a) { a.fill(i); });
+    }
+    done = true;
+    for (auto &t : readers) {
+        t.join();
+    }
+    EXPECT_EQ(0, torn.load());
+    EXPECT_EQ(num_writes, buffer.load()[63]);
+}
@@ -74,3 +74,64 @@ TEST(IdentityTest, multiplyCross) {
     EXPECT_APPROX(expected, Identity3d{} * wave::crossMatrix(vec));
     EXPECT_APPROX(expected, wave::crossMatrix(vec) * Identity3d{});
 }
+
+TEST(NegativeIdentityTest, multiply) {
+    using Identity3d = wave::IdentityMatrix<double, 3>;
+    const Eigen::Matrix3d m = Eigen::Matrix3d::Random();
+    const Eigen::Matrix3d expected = -m;
+    EXPECT_APPROX(expected, -Identity3d{} * m);
+    EXPECT_APPROX(expected, m * -Identity3d{});
+    EXPECT_APPROX(Eigen::Matrix3d{-Eigen::Matrix3d::Identity()}, -Identity3d{});
+
+    // Products of identities stay symbolic
+    static_assert(std::is_same<Identity3d, decltype(-Identity3d{} * -Identity3d{})>{}, "");
+    static_assert(
+      std::is_same<Identity3d, std::decay_t<decltype(-(-Identity3d{}))>>{}, "");
+    EXPECT_APPROX(Eigen::Matrix3d{-Eigen::Matrix3d::Identity()},
+                  Identity3d{} * -Identity3d{});
+    EXPECT_APPROX(Eigen::Matrix3d{-Eigen::Matrix3d::Identity()},
+                  -Identity3d{} * Identity3d{});
+}
+
+TEST(NegativeIdentityTest, multiplyCross) {
+    using Identity3d = wave::IdentityMatrix<double, 3>;
+    const Eigen::Vector3d vec = Eigen::Vector3d::Random();
+    const Eigen::Matrix3d expected = -wave::crossMatrix(vec);
+    EXPECT_APPROX(expected, -Identity3d{} * wave::crossMatrix(vec));
+    EXPECT_APPROX(expected, wave::crossMatrix(vec) * -Identity3d{});
+}
+
+TEST(IdentityBlockTest, construct) {
+    using Block = wave::IdentityBlockMatrix<double, 3, 6, 3>;
+    Eigen::Matrix<double, 3, 6> expected;
+    expected << Eigen::Matrix3d::Zero(), Eigen::Matrix3d::Identity();
+    EXPECT_APPROX(expected, Block{});
+}
+
+TEST(IdentityBlockTest, multiply) {
+    using Block = wave::IdentityBlockMatrix<double, 3, 6, 3>;
+    using Identity3d = wave::IdentityMatrix<double, 3>;
+    using Identity6d = wave::IdentityMatrix<double, 6>;
+    const Eigen::Matrix<double, 3, 6> dense = Block{};
+    const Eigen::Matrix<double, 2, 3> lhs = Eigen::Matrix<double, 2, 3>::Random();
+    const Eigen::Matrix<double, 6, 4> rhs = Eigen::Matrix<double, 6, 4>::Random();
+    const Eigen::MatrixXd lhs_dynamic = lhs;
+
+    EXPECT_APPROX(Eigen::MatrixXd{lhs * dense}, Eigen::MatrixXd{lhs * Block{}});
+    EXPECT_APPROX(Eigen::MatrixXd{lhs * dense}, Eigen::MatrixXd{lhs_dynamic * Block{}});
+    EXPECT_APPROX(Eigen::MatrixXd{dense * rhs}, Eigen::MatrixXd{Block{} * rhs});
+
+    static_assert(std::is_same<const Block &, decltype(Identity3d{} * Block{})>{}, "");
+    static_assert(std::is_same<const Block &, decltype(Block{} * Identity6d{})>{}, "");
+    EXPECT_APPROX(Eigen::MatrixXd{-dense}, Eigen::MatrixXd{-Identity3d{} * Block{}});
+    EXPECT_APPROX(Eigen::MatrixXd{-dense}, Eigen::MatrixXd{Block{} * -Identity6d{}});
+}
+
+TEST(IdentityBlockTest, multiplyCross) {
+    using Block = wave::IdentityBlockMatrix<double, 3, 6, 0>;
+    const Eigen::Vector3d vec = Eigen::Vector3d::Random();
+    const Eigen::Matrix<double, 3, 6> dense = Block{};
+    const Eigen::Matrix3d cross = wave::crossMatrix(vec);
+    EXPECT_APPROX(Eigen::MatrixXd{cross * dense},
+                  Eigen::MatrixXd{wave::crossMatrix(vec) * Block{}});
+}
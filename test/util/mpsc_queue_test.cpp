@@ -0,0 +1,68 @@
+#include "wave/geometry/src/util/parallel/MpscQueue.hpp"
+#include "../test.hpp"
+#include <thread>
+#include <vector>
+
+TEST(MpscQueueTest, consumesInOrder) {
+    auto queue = wave::MpscQueue<int>{};
+    EXPECT_TRUE(queue.empty());
+    for (int i = 0; i < 5; ++i) {
+        queue.push(i);
+    }
+    EXPECT_FALSE(queue.empty());
+
+    auto items = std::vector<int>{};
+    EXPECT_EQ(5u, queue.consumeAll([&](int i) { items.push_back(i); }));
+    EXPECT_EQ((std::vector<int>{0, 1, 2, 3, 4}), items);
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(0u, queue.consumeAll([](int) {}));
+}
+
+TEST(MpscQueueTest, concurrentProducers) {
+    const int num_producers = 4;
+    const int per_producer = 10000;
+    auto queue = wave::MpscQueue<std::pair<int, int>>{};
+    auto producers = std::vector<std::thread>{};
+    for (int p = 0; p < num_producers; ++p) {
+        producers.emplace_back([&queue, p] {
+            for (int i = 0; i < per_producer; ++i) {
+                queue.push({p, i});
+            }
+        });
+    }
+
+    // Consume while producing; each producer's items arrive in the order pushed
+    auto next = std::vector<int>(num_producers, 0);
+    auto consume = [&](std::pair<int, int> item) {
+        EXPECT_EQ(next[item.first], item.second);
+        ++next[item.first];
+    };
+    std::size_t count = 0;
+    while (count < num_producers * per_producer) {
+        count += queue.consumeAll(consume);
+    }
+    for (auto &t : producers) {
+        t.join();
+    }
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(std::vector<int>(num_producers, per_producer), next);
+}
+
+TEST(MpscQueueTest, freesItemsAfterException) {
+    auto item = std::make_shared<int>(0);
+    auto queue = wave::MpscQueue<std::shared_ptr<int>>{};
+    for (int i = 0; i < 3; ++i) {
+        queue.push(item);
+    }
+    EXPECT_THROW(queue.consumeAll([](std::shared_ptr<int>) { throw 1; }), int);
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(1, item.use_count());
+
+    // Items left in the queue are freed with it
+    {
+        auto other = wave::MpscQueue<std::shared_ptr<int>>{};
+        other.push(item);
+        EXPECT_EQ(2, item.use_count());
+    }
+    EXPECT_EQ(1, item.use_count());
+}
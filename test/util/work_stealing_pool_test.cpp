@@ -0,0 +1,105 @@
+#include "wave/geometry/src/util/parallel/WorkStealingPool.hpp"
+#include "../test.hpp"
+
+TEST(WorkStealingPoolTest, runsSubmittedTasks) {
+    auto pool = wave::WorkStealingPool{4};
+    ASSERT_EQ(4u, pool.size());
+
+    // Each task submits two more, down to a fixed depth
+    auto count = std::atomic<int>{0};
+    std::function<void(int)> spawn = [&](int depth) {
+        ++count;
+        if (depth > 0) {
+            for (int i = 0; i < 2; ++i) {
+                pool.submit([&spawn, depth](std::size_t) { spawn(depth - 1); });
+            }
+        }
+    };
+    for (int rep = 0; rep < 3; ++rep) {
+        count = 0;
+        pool.run([&](std::size_t) { spawn(10); });
+        EXPECT_EQ(2047, count);
+    }
+}
+
+TEST(WorkStealingPoolTest, threadIndices) {
+    auto pool = wave::WorkStealingPool{3};
+    auto seen = std::vector<std::atomic<int>>(pool.size());
+    pool.run([&](std::size_t) {
+        for (int i = 0; i < 100; ++i) {
+            pool.submit([&](std::size_t thread) {
+                ASSERT_LT(thread, pool.size());
+                ++seen[thread];
+            });
+        }
+    });
+    auto total = 0;
+    for (const auto &s : seen) {
+        total += s;
+    }
+    EXPECT_EQ(100, total);
+}
+
+TEST(WorkStealingPoolTest, singleThread) {
+    auto pool = wave::WorkStealingPool{1};
+    const auto caller = std::this_thread::get_id();
+    auto count = 0;
+    pool.run([&](std::size_t) {
+        for (int i = 0; i < 10; ++i) {
+            pool.submit([&](std::size_t thread) {
+                EXPECT_EQ(0u, thread);
+                EXPECT_EQ(caller, std::this_thread::get_id());
+                ++count;
+            });
+        }
+    });
+    EXPECT_EQ(10, count);
+}
+
+TEST(WorkStealingPoolTest, rethrowsException) {
+    auto pool = wave::WorkStealingPool{2};
+    EXPECT_THROW(pool.run([&](std::size_t) {
+        for (int i = 0; i < 10; ++i) {
+            pool.submit([](std::size_t) { throw std::runtime_error{"task failed"}; });
+        }
+    }),
+                 std::runtime_error);
+
+    // The pool can be used again
+    auto count = std::atomic<int>{0};
+    pool.run([&](std::size_t) { ++count; });
+    EXPECT_EQ(1, count);
+}
+
+TEST(WorkStealingPoolTest, parallelChunks) {
+    auto pool = wave::WorkStealingPool{4};
+    for (const auto n : {0u, 7u, 100u, 1001u}) {
+        // Each index is covered by exactly one chunk, no smaller than the grain
+        auto covered = std::vector<std::atomic<int>>(n);
+        auto chunks = std::atomic<std::size_t>{0};
+        wave::parallelChunks(
+          &pool, n, 10, [&](std::size_t c, std::size_t start, std::size_t end) {
+              EXPECT_LT(c, pool.size());
+              EXPECT_LE(start, end);
+              for (auto i = start; i < end; ++i) {
+                  ++covered[i];
+              }
+              ++chunks;
+          });
+        for (const auto &k : covered) {
+            EXPECT_EQ(1, k);
+        }
+        EXPECT_LE(chunks, std::max<std::size_t>(1, n / 10));
+    }
+
+    // Without a pool, one chunk on the caller
+    auto calls = 0;
+    wave::parallelChunks(
+      nullptr, 100, 1, [&](std::size_t c, std::size_t start, std::size_t end) {
+          EXPECT_EQ(0u, c);
+          EXPECT_EQ(0u, start);
+          EXPECT_EQ(100u, end);
+          ++calls;
+      });
+    EXPECT_EQ(1, calls);
+}